@@ -174,14 +174,40 @@ void DemoWidget::exportModel()
     if (fileName.isEmpty())
         return;
 
-    QFile file(fileName);
-    if (!file.open(QFile::WriteOnly)) {
+    QFile* file = new QFile(fileName, exporter.data());
+    if (!file->open(QFile::WriteOnly)) {
         QMessageBox::critical(this, errorTitle,
                               tr("Failed to open the file '%1': %2")
-                                    .arg(fileName, file.errorString()));
+                                    .arg(fileName, file->errorString()));
+        return;
+    }
+
+    // streaming exporters run in background, the others block
+    QPointer<QProgressDialog> progress = new QProgressDialog(tr("Data export..."), tr("Cancel"), 0, 0, this);
+    progress->setAttribute(Qt::WA_DeleteOnClose);
+    connect(progress.data(), &QProgressDialog::canceled, exporter.data(), &QtTableModelExporter::cancel);
+    connect(exporter.data(), &QtTableModelExporter::progressChanged, progress.data(), [progress](int value, int maximum) {
+        progress->setMaximum(maximum);
+        progress->setValue(value);
+    });
+
+    QtTableModelExporter* e = exporter.data();
+    connect(e, &QtTableModelExporter::finished, this, [this, e, progress, errorTitle](bool ok) {
+        if (progress)
+            progress->close();
+        if (!ok)
+            QMessageBox::critical(this, errorTitle, e->errorString());
+        e->deleteLater();
+    });
+
+    if (e->startExport(file)) {
+        progress->show();
+        exporter.take();
+        return;
     }
 
-    if (!exporter->exportModel(&file)) {
+    delete progress.data();
+    if (!exporter->exportModel(file)) {
         QMessageBox::critical(this, errorTitle,
                               exporter->errorString());
     }
@@ -5,7 +5,7 @@
 #include <QtWidgets>
 
 #include <QtCheckableProxyModel>
-#include <QtCachingProxyModel>
+#include <QtRevertibleProxyModel>
 
 #include <QtVariantListModel>
 #include <QtVariantItemDelegate>
@@ -1,5 +1,6 @@
 ﻿#include "qtcsvexporter.h"
-#include <QTextStream>
+#include <QtTableModelSerializer>
+#include "qtcsvwriter.h"
 #include <QTextCodec>
 #include <QVariant>
 #include <QDateTime>
@@ -29,70 +30,78 @@ public:
     QChar stringQuote;
     QString dateFormat;
     QString timeFormat;
-    QTextStream stream;
 
     QtTableModelCsvExporterPrivate(QtTableModelCsvExporter* e)
         : q(e)
     {}
-    inline void storeTableHeader();
-    inline void storeItem(const QVariant& v);
 };
 
 
-void QtTableModelCsvExporterPrivate::storeTableHeader()
+// Fields are formatted right into the writer buffer when
+// the output is UTF-8, otherwise every row is formatted into
+// the scratch buffer and re-encoded with the writer codec
+class QtCsvSerializer :
+        public QtTableModelSerializer
 {
-    QAbstractTableModel *m = q->model();
-    QString s;
-    for (int i = 0; i < m->columnCount(); ++i) {
-        s = m->headerData(i, Qt::Horizontal, Qt::DisplayRole).toString();
-        stream << QStringLiteral("?%1?").replace('?', stringQuote).arg(s) << delimiter;
-    }
+public:
+    QtCsvSerializer(bool header, const QString& delimiter, QChar quote, bool boolAlpha,
+                    const QString& dateFormat, const QString& timeFormat)
+        : storeHeader(header)
+        , csv(delimiter, quote, boolAlpha, dateFormat, timeFormat)
+    {}
 
-}
+    void begin(QtTableModelWriter &writer, const QVector<QVariant> &header) Q_DECL_OVERRIDE;
+    void writeRow(QtTableModelWriter &writer, int row, const QVariant *values, int count) Q_DECL_OVERRIDE;
+
+private:
+    inline QByteArray& output(QtTableModelWriter &writer);
+    inline void commitRow(QtTableModelWriter &writer);
 
-void QtTableModelCsvExporterPrivate::storeItem( const QVariant& v )
+    bool storeHeader;
+    QtCsvWriter csv;
+    QByteArray scratch;
+};
+
+
+void QtCsvSerializer::begin(QtTableModelWriter &writer, const QVector<QVariant> &header)
 {
-    switch(v.type())
-    {
-    case QVariant::Bool:
-    {
-        bool b = v.toBool();
-        if (boolalpha)
-            stream << (b ? "true" : "false");
-        else
-            stream << static_cast<int>(b);
+    if (!storeHeader)
+        return;
+
+    QByteArray& out = output(writer);
+    for (int c = 0; c < header.size(); ++c) {
+        if (c > 0)
+            csv.writeDelimiter(out);
+        csv.writeText(out, header[c].toString());
     }
-        break;
-    case QVariant::Date:
-        stream << (v.toDate().toString(dateFormat));
-        break;
-    case QVariant::Time:
-        stream << (v.toTime().toString(timeFormat));
-        break;
-    case QVariant::DateTime:
-        stream <<  (v.toDateTime().toString(dateFormat + " " + timeFormat));
-        break;
-    case QVariant::Double:
-        stream << v.toDouble();
-        break;
-    case QVariant::LongLong:
-        stream << v.toLongLong();
-        break;
-    case QVariant::ULongLong:
-        stream << v.toULongLong();
-        break;
-    case QVariant::Int:
-        stream << v.toInt();
-        break;
-    case QVariant::UInt:
-        stream << v.toUInt();
-        break;
-    case QVariant::ByteArray:
-    case QVariant::String:
-    default:
-        stream << QString("?%1?").replace('?', stringQuote).arg(v.toString());
+    csv.writeEndOfLine(out);
+    commitRow(writer);
+}
+
+void QtCsvSerializer::writeRow(QtTableModelWriter &writer, int, const QVariant *values, int count)
+{
+    QByteArray& out = output(writer);
+    for (int c = 0; c < count; ++c) {
+        if (c > 0)
+            csv.writeDelimiter(out);
+        csv.writeField(out, values[c]);
     }
+    csv.writeEndOfLine(out); // write EOL after every row
+    commitRow(writer);
+}
 
+QByteArray &QtCsvSerializer::output(QtTableModelWriter &writer)
+{
+    return writer.isUtf8() ? writer.buffer() : scratch;
+}
+
+void QtCsvSerializer::commitRow(QtTableModelWriter &writer)
+{
+    if (writer.isUtf8())
+        return;
+
+    writer.write(QString::fromUtf8(scratch));
+    scratch.resize(0);
 }
 
 
@@ -165,50 +174,10 @@ QStringList QtTableModelCsvExporter::fileFilter() const
     return (QStringList() << tr("Plain text (*.csv *.txt *.tab)"));
 }
 
-bool QtTableModelCsvExporter::exportModel(QIODevice *device)
+QtTableModelSerializer *QtTableModelCsvExporter::createSerializer() const
 {
-    if (!beginExport(device))
-        return false;
-
-    d->stream.setDevice(device);
-    d->stream.setCodec(textCodec());
-
-    if (isHeaderStored()) {
-        d->storeTableHeader();
-        d->stream << endl;
-    }
-    storeIndex();
-    endExport();
-    return (d->stream.status() == QTextStream::Ok);
-}
-
-void QtTableModelCsvExporter::storeIndex(const QModelIndex& index)
-{
-    if (aborted())
-        return;
-
-    if (index.isValid()) {
-        d->storeItem(index.data(itemRole()));
-        d->stream << d->delimiter;
-        return;
-    }
-
-    if (d->stream.status() != QTextStream::Ok) {
-        setErrorString(d->stream.device()->errorString());
-        return;
-    }
-
-    const QAbstractTableModel *m = model();
-    const int rowCount =  m->rowCount(index);
-    const int columnCount =  m->columnCount(index);
-    int step = 0;
-    for (int r = 0; r < rowCount; ++r) {
-        for (int c = 0; c < columnCount; ++c) {
-            storeIndex(m->index(r, c, index));
-            setProgress(++step);
-        }
-        d->stream << endl; // write EOL after every row
-    }
+    return new QtCsvSerializer(isHeaderStored(), d->delimiter, d->stringQuote, d->boolalpha,
+                               d->dateFormat, d->timeFormat);
 }
 
 QWidget *QtTableModelCsvExporter::createEditor(QDialog *parent) const
@@ -46,10 +46,11 @@ public:
     QStringList fileFilter() const;
 
     // QtTableModelExporterPlugin interface
-    bool exportModel(QIODevice *device);
-    void storeIndex(const QModelIndex& index = QModelIndex());
     QWidget *createEditor(QDialog *parent) const;
 
+protected:
+    QtTableModelSerializer *createSerializer() const;
+
 private:
     QScopedPointer<class QtTableModelCsvExporterPrivate> d;
 };
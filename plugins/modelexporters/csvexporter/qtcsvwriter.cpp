@@ -0,0 +1,467 @@
+#include <QDateTime>
+#include <QLocale>
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+
+#include "qtcsvwriter.h"
+
+namespace
+{
+
+template<class _Int>
+inline void appendNumber(QByteArray& out, _Int value)
+{
+    char buf[24];
+    const auto result = std::to_chars(buf, buf + sizeof(buf), value);
+    out.append(buf, static_cast<int>(result.ptr - buf));
+}
+
+inline void appendNumber(QByteArray& out, double value)
+{
+    // same as QTextStream with default settings
+#if defined(__cpp_lib_to_chars)
+    char buf[32];
+    const auto result = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::general, 6);
+    out.append(buf, static_cast<int>(result.ptr - buf));
+#else
+    out.append(QByteArray::number(value, 'g', 6));
+#endif
+}
+
+inline void appendPadded(QByteArray& out, int value, int width)
+{
+    char buf[16];
+    const auto result = std::to_chars(buf, buf + sizeof(buf), std::abs(value));
+    if (value < 0)
+        out.append('-');
+    for (int n = static_cast<int>(result.ptr - buf); n < width; ++n)
+        out.append('0');
+    out.append(buf, static_cast<int>(result.ptr - buf));
+}
+
+// appends UTF-16 text as UTF-8, optionally doubling the quote
+void appendUtf8(QByteArray& out, QStringView text, ushort quote = 0)
+{
+    // reserve the worst case at once, then write through the pointer
+    const int offset = out.size();
+    out.resize(offset + static_cast<int>(text.size()) * (quote ? 6 : 3));
+    uchar* dst = reinterpret_cast<uchar*>(out.data()) + offset;
+
+    const QChar* src = text.data();
+    const QChar* end = src + text.size();
+    for (; src != end; ++src)
+    {
+        uint u = src->unicode();
+        if (u < 0x80)
+        {
+            *dst++ = uchar(u);
+            if (u == quote)
+                *dst++ = uchar(u);
+            continue;
+        }
+
+        if (QChar::isHighSurrogate(u) && src + 1 != end && (src + 1)->isLowSurrogate())
+        {
+            u = QChar::surrogateToUcs4(ushort(u), (++src)->unicode());
+            *dst++ = uchar(0xf0 | (u >> 18));
+            *dst++ = uchar(0x80 | ((u >> 12) & 0x3f));
+            *dst++ = uchar(0x80 | ((u >> 6) & 0x3f));
+            *dst++ = uchar(0x80 | (u & 0x3f));
+            continue;
+        }
+
+        if (QChar::isSurrogate(u))
+            u = QChar::ReplacementCharacter;
+
+        for (int k = (u == quote ? 2 : 1); k > 0; --k)
+        {
+            if (u < 0x800)
+            {
+                *dst++ = uchar(0xc0 | (u >> 6));
+            }
+            else
+            {
+                *dst++ = uchar(0xe0 | (u >> 12));
+                *dst++ = uchar(0x80 | ((u >> 6) & 0x3f));
+            }
+            *dst++ = uchar(0x80 | (u & 0x3f));
+        }
+    }
+    out.resize(static_cast<int>(reinterpret_cast<char*>(dst) - out.data()));
+}
+
+}
+
+
+QtDateTimeFormat::QtDateTimeFormat(const QString &format, Kind kind)
+    : text(format)
+    , native(true)
+    , ampm(false)
+{
+    const QLocale locale = QLocale::system();
+    if (locale.zeroDigit() != QLatin1Char('0'))
+    {
+        native = false;
+        return;
+    }
+
+    for (int i = 1; i <= 7; ++i)
+    {
+        dayNames[0][i] = locale.dayName(i, QLocale::ShortFormat).toUtf8();
+        dayNames[1][i] = locale.dayName(i, QLocale::LongFormat).toUtf8();
+    }
+    for (int i = 1; i <= 12; ++i)
+    {
+        monthNames[0][i] = locale.monthName(i, QLocale::ShortFormat).toUtf8();
+        monthNames[1][i] = locale.monthName(i, QLocale::LongFormat).toUtf8();
+    }
+    amPmNames[0][0] = locale.amText().toLower().toUtf8();
+    amPmNames[0][1] = locale.pmText().toLower().toUtf8();
+    amPmNames[1][0] = locale.amText().toUpper().toUtf8();
+    amPmNames[1][1] = locale.pmText().toUpper().toUtf8();
+
+    parse(format, kind);
+}
+
+void QtDateTimeFormat::parse(const QString &format, Kind kind)
+{
+    // mirrors the format rules of QLocale::toString()
+    const QStringView f(format);
+    const int n = static_cast<int>(f.size());
+    for (int i = 0; i < n; )
+    {
+        const QChar c = f[i];
+        if (c == QLatin1Char('\''))
+        {
+            // '' is the quote itself, otherwise text up to the closing quote
+            if (i + 1 < n && f[i + 1] == QLatin1Char('\''))
+            {
+                addLiteral(f.mid(i, 1));
+                i += 2;
+                continue;
+            }
+
+            for (++i; i < n; ++i)
+            {
+                if (f[i] != QLatin1Char('\''))
+                {
+                    addLiteral(f.mid(i, 1));
+                }
+                else if (i + 1 < n && f[i + 1] == QLatin1Char('\''))
+                {
+                    addLiteral(f.mid(i, 1));
+                    ++i;
+                }
+                else
+                {
+                    break;
+                }
+            }
+            ++i; // closing quote
+            continue;
+        }
+
+        int repeat = 1;
+        while (i + repeat < n && f[i + repeat] == c)
+            ++repeat;
+
+        const bool date = (kind & Date);
+        const bool time = (kind & Time);
+        Token token = { Literal, 0, 0, 0 };
+        switch (c.unicode())
+        {
+        case 'd':
+            if (date)
+            {
+                repeat = std::min(repeat, 4);
+                token.field = repeat > 2 ? DayName : Day;
+                token.width = char(repeat > 2 ? repeat - 3 : repeat);
+            }
+            break;
+        case 'M':
+            if (date)
+            {
+                repeat = std::min(repeat, 4);
+                token.field = repeat > 2 ? MonthName : Month;
+                token.width = char(repeat > 2 ? repeat - 3 : repeat);
+            }
+            break;
+        case 'y':
+            if (date && repeat >= 2)
+            {
+                repeat = repeat >= 4 ? 4 : 2;
+                token.field = repeat == 4 ? Year4 : Year2;
+            }
+            else
+            {
+                repeat = 1;
+            }
+            break;
+        case 'h':
+        case 'H':
+        case 'm':
+        case 's':
+            if (time)
+            {
+                static const Field fields[] = { Hour, Hour24, Minute, Second };
+                repeat = std::min(repeat, 2);
+                token.field = fields[c == QLatin1Char('h') ? 0 : c == QLatin1Char('H') ? 1 : c == QLatin1Char('m') ? 2 : 3];
+                token.width = char(repeat);
+            }
+            break;
+        case 'z':
+            if (time)
+            {
+                if (repeat < 3)
+                {
+                    native = false;
+                    return;
+                }
+                repeat = 3;
+                token.field = Msec;
+                token.width = 3;
+            }
+            break;
+        case 'a':
+        case 'A':
+            if (time)
+            {
+                const QChar p = c == QLatin1Char('a') ? QLatin1Char('p') : QLatin1Char('P');
+                repeat = (i + 1 < n && f[i + 1] == p) ? 2 : 1;
+                token.field = AmPm;
+                token.width = char(c == QLatin1Char('A'));
+                ampm = true;
+            }
+            break;
+        case 't':
+            if (time)
+            {
+                native = false;
+                return;
+            }
+            break;
+        default:
+            break;
+        }
+
+        if (token.field == Literal)
+            addLiteral(f.mid(i, repeat));
+        else
+            tokens.push_back(token);
+        i += repeat;
+    }
+}
+
+void QtDateTimeFormat::addLiteral(QStringView s)
+{
+    if (tokens.empty() || tokens.back().field != Literal)
+        tokens.push_back({ Literal, 0, literals.size(), 0 });
+
+    const int size = literals.size();
+    appendUtf8(literals, s);
+    tokens.back().size += literals.size() - size;
+}
+
+void QtDateTimeFormat::format(QByteArray &out, const QDate &date) const
+{
+    if (!date.isValid())
+        return;
+
+    if (!native)
+    {
+        out.append(date.toString(text).toUtf8());
+        return;
+    }
+
+    for (const Token& token : tokens)
+        formatDate(out, date, token);
+}
+
+void QtDateTimeFormat::format(QByteArray &out, const QTime &time) const
+{
+    if (!time.isValid())
+        return;
+
+    if (!native)
+    {
+        out.append(time.toString(text).toUtf8());
+        return;
+    }
+
+    for (const Token& token : tokens)
+        formatTime(out, time, token);
+}
+
+void QtDateTimeFormat::format(QByteArray &out, const QDateTime &dateTime) const
+{
+    if (!dateTime.isValid())
+        return;
+
+    if (!native)
+    {
+        out.append(dateTime.toString(text).toUtf8());
+        return;
+    }
+
+    const QDate date = dateTime.date();
+    const QTime time = dateTime.time();
+    for (const Token& token : tokens)
+    {
+        if (token.field <= Year4)
+            formatDate(out, date, token);
+        else
+            formatTime(out, time, token);
+    }
+}
+
+void QtDateTimeFormat::formatDate(QByteArray &out, const QDate &date, const Token &token) const
+{
+    switch (token.field)
+    {
+    case Literal:
+        out.append(literals.constData() + token.literal, token.size);
+        break;
+    case Day:
+        appendPadded(out, date.day(), token.width);
+        break;
+    case DayName:
+        out.append(dayNames[int(token.width)][date.dayOfWeek()]);
+        break;
+    case Month:
+        appendPadded(out, date.month(), token.width);
+        break;
+    case MonthName:
+        out.append(monthNames[int(token.width)][date.month()]);
+        break;
+    case Year2:
+        appendPadded(out, std::abs(date.year()) % 100, 2);
+        break;
+    case Year4:
+        appendPadded(out, date.year(), 4);
+        break;
+    default:
+        break;
+    }
+}
+
+void QtDateTimeFormat::formatTime(QByteArray &out, const QTime &time, const Token &token) const
+{
+    switch (token.field)
+    {
+    case Literal:
+        out.append(literals.constData() + token.literal, token.size);
+        break;
+    case Hour:
+        if (ampm)
+        {
+            const int hour = time.hour() % 12;
+            appendPadded(out, hour == 0 ? 12 : hour, token.width);
+            break;
+        }
+        Q_FALLTHROUGH();
+    case Hour24:
+        appendPadded(out, time.hour(), token.width);
+        break;
+    case Minute:
+        appendPadded(out, time.minute(), token.width);
+        break;
+    case Second:
+        appendPadded(out, time.second(), token.width);
+        break;
+    case Msec:
+        appendPadded(out, time.msec(), 3);
+        break;
+    case AmPm:
+        out.append(amPmNames[int(token.width)][time.hour() < 12 ? 0 : 1]);
+        break;
+    default:
+        break;
+    }
+}
+
+
+QtCsvWriter::QtCsvWriter(const QString &delimiter, QChar quote, bool boolAlpha,
+                         const QString &dateFormat, const QString &timeFormat)
+    : delimiter(delimiter.toUtf8())
+    , delimiterText(delimiter)
+    , quote(quote)
+    , boolAlpha(boolAlpha)
+    , dateFormat(dateFormat, QtDateTimeFormat::Date)
+    , timeFormat(timeFormat, QtDateTimeFormat::Time)
+    , dateTimeFormat(dateFormat + QLatin1Char(' ') + timeFormat, QtDateTimeFormat::DateTime)
+{
+}
+
+void QtCsvWriter::writeField(QByteArray &out, const QVariant &value) const
+{
+    switch (value.userType())
+    {
+    case QMetaType::Bool:
+        if (boolAlpha)
+            out.append(value.toBool() ? "true" : "false");
+        else
+            out.append(value.toBool() ? '1' : '0');
+        break;
+    case QMetaType::QDate:
+        dateFormat.format(out, value.toDate());
+        break;
+    case QMetaType::QTime:
+        timeFormat.format(out, value.toTime());
+        break;
+    case QMetaType::QDateTime:
+        dateTimeFormat.format(out, value.toDateTime());
+        break;
+    case QMetaType::Double:
+        appendNumber(out, value.toDouble());
+        break;
+    case QMetaType::LongLong:
+        appendNumber(out, value.toLongLong());
+        break;
+    case QMetaType::ULongLong:
+        appendNumber(out, value.toULongLong());
+        break;
+    case QMetaType::Int:
+        appendNumber(out, value.toInt());
+        break;
+    case QMetaType::UInt:
+        appendNumber(out, value.toUInt());
+        break;
+    case QMetaType::QString:
+        // no copy of the string
+        writeText(out, *static_cast<const QString*>(value.constData()));
+        break;
+    case QMetaType::UnknownType:
+        break;
+    default:
+        writeText(out, value.toString());
+    }
+}
+
+void QtCsvWriter::writeText(QByteArray &out, QStringView text) const
+{
+    if (!needsQuoting(text))
+    {
+        appendUtf8(out, text);
+        return;
+    }
+
+    appendUtf8(out, QStringView(&quote, 1));
+    appendUtf8(out, text, quote.unicode());
+    appendUtf8(out, QStringView(&quote, 1));
+}
+
+bool QtCsvWriter::needsQuoting(QStringView text) const
+{
+    if (quote.isNull())
+        return false;
+
+    const QChar delim = delimiterText.size() == 1 ? delimiterText[0] : QChar();
+    for (QChar c : text)
+    {
+        if (c == quote || c == QLatin1Char('\n') || c == QLatin1Char('\r') || (c == delim && !delim.isNull()))
+            return true;
+    }
+    return delimiterText.size() > 1 && text.contains(QStringView(delimiterText));
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <QByteArray>
+#include <QString>
+#include <QStringView>
+#include <QVariant>
+
+#include <vector>
+
+class QDate;
+class QTime;
+
+//
+// QtDateTimeFormat is the date/time format string parsed once,
+// it appends formatted values as UTF-8 directly into the buffer
+// instead of building a QString for every value. Formats with
+// elements it doesn't handle (time zones, fractional seconds
+// without trailing zeroes, non-latin digits of the system locale)
+// fall back to QDate/QTime/QDateTime::toString()
+//
+class QtDateTimeFormat
+{
+public:
+    enum Kind
+    {
+        Date = 1,
+        Time = 2,
+        DateTime = Date|Time
+    };
+
+    QtDateTimeFormat(const QString& format = QString(), Kind kind = DateTime);
+
+    void format(QByteArray& out, const QDate& date) const;
+    void format(QByteArray& out, const QTime& time) const;
+    void format(QByteArray& out, const QDateTime& dateTime) const;
+
+private:
+    enum Field : char
+    {
+        Literal,
+        Day, DayName,
+        Month, MonthName,
+        Year2, Year4,
+        Hour, Hour24, Minute, Second, Msec,
+        AmPm
+    };
+
+    struct Token
+    {
+        Field field;
+        char width;  // digits or name format
+        int literal; // offset in literals
+        int size;    // size in literals
+    };
+
+    void parse(const QString& format, Kind kind);
+    void addLiteral(QStringView text);
+    void formatDate(QByteArray& out, const QDate& date, const Token& token) const;
+    void formatTime(QByteArray& out, const QTime& time, const Token& token) const;
+
+    std::vector<Token> tokens;
+    QByteArray literals;
+    QString text;
+    bool native;
+    bool ampm;
+
+    // names of the system locale in UTF-8
+    QByteArray dayNames[2][8];
+    QByteArray monthNames[2][13];
+    QByteArray amPmNames[2][2];
+};
+
+
+//
+// QtCsvWriter formats fields into the UTF-8 buffer: numbers are
+// written with std::to_chars and fields are quoted only if they
+// contain the delimiter, the quote or line break, with quotes
+// doubled inside (RFC 4180)
+//
+class QtCsvWriter
+{
+public:
+    QtCsvWriter(const QString& delimiter, QChar quote, bool boolAlpha,
+                const QString& dateFormat, const QString& timeFormat);
+
+    void writeField(QByteArray& out, const QVariant& value) const;
+    void writeText(QByteArray& out, QStringView text) const;
+
+    inline void writeDelimiter(QByteArray& out) const { out.append(delimiter); }
+    inline void writeEndOfLine(QByteArray& out) const { out.append('\n'); }
+
+private:
+    bool needsQuoting(QStringView text) const;
+
+    QByteArray delimiter;
+    QString delimiterText;
+    QChar quote;
+    bool boolAlpha;
+    QtDateTimeFormat dateFormat;
+    QtDateTimeFormat timeFormat;
+    QtDateTimeFormat dateTimeFormat;
+};
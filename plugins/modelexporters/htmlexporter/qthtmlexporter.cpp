@@ -79,7 +79,6 @@ void QtTableModelHtmlExporterPrivate::storeHeader()
         cell.setFormat(format);
         QTextCursor cellCursor = cell.firstCursorPosition();
         cellCursor.insertText(headerData<Qt::DisplayRole, QString>(m, i));
-        qApp->processEvents();
     }
 }
 
@@ -90,7 +89,6 @@ void QtTableModelHtmlExporterPrivate::storeItem(QTextTable* table, const QModelI
     cell.setFormat(indexFormat(index));
     QTextCursor cellCursor = cell.firstCursorPosition();
     cellCursor.insertText(index.data(q->itemRole()).toString());
-    qApp->processEvents();
 }
 
 inline QTextCharFormat QtTableModelHtmlExporterPrivate::indexFormat(const QModelIndex &index) const
@@ -4,7 +4,6 @@
 #include <QJsonDocument>
 #include <QJsonArray>
 
-#include <QTextStream>
 #include <QVariant>
 #include <QDateTime>
 #include <QRegExp>
@@ -17,6 +16,7 @@
 #include <QDialog>
 
 #include <QtPropertyWidget>
+#include <QtTableModelSerializer>
 
 QT_METAINFO_TR(QtTableModelJsonExporter)
 {
@@ -36,13 +36,8 @@ public:
     QString dateFormat;
     QString timeFormat;
     QJsonDocument::JsonFormat jsonFormat;
-    QJsonObject json;
-    QJsonArray array;
-    QtTableModelJsonExporterPrivate(QtTableModelExporter* e);
 
     QtTableModelJsonExporterPrivate(QtTableModelJsonExporter* e);
-    inline void storeTableHeader(QJsonObject &json);
-    inline QJsonValue jsonValue(const QVariant& v) const;
 };
 
 QtTableModelJsonExporterPrivate::QtTableModelJsonExporterPrivate(QtTableModelJsonExporter *e) :
@@ -51,19 +46,128 @@ QtTableModelJsonExporterPrivate::QtTableModelJsonExporterPrivate(QtTableModelJso
     boolalpha = false;
     dateFormat = "dd-MM-yyyy";
     timeFormat = "hh.mm.ss";
+    jsonFormat = QJsonDocument::Indented;
+}
+
+
+// Writes the same document QJsonDocument would produce for
+// {"header": [...], "items": [[...], ...], "title": "..."}
+// (keys are sorted), but row by row, so the whole document
+// is never built in memory
+class QtJsonSerializer :
+        public QtTableModelSerializer
+{
+public:
+    bool storeHeader;
+    QString title;
+    QString dateFormat;
+    QString timeFormat;
+    QString dateTimeFormat;
+    QJsonDocument::JsonFormat jsonFormat;
+
+    void begin(QtTableModelWriter &writer, const QVector<QVariant> &header) Q_DECL_OVERRIDE;
+    void writeRow(QtTableModelWriter &writer, int row, const QVariant *values, int count) Q_DECL_OVERRIDE;
+    void end(QtTableModelWriter &writer) Q_DECL_OVERRIDE;
+
+private:
+    inline bool isCompact() const { return jsonFormat == QJsonDocument::Compact; }
+    inline void writeKey(QtTableModelWriter &writer, const char* key) const;
+    inline void writeArray(QtTableModelWriter &writer, const QJsonArray& array, int indent) const;
+    inline void writeJson(QtTableModelWriter &writer, const QByteArray& json) const;
+    inline QJsonValue jsonValue(const QVariant& v) const;
+
+    bool firstRow = true;
+};
+
+void QtJsonSerializer::begin(QtTableModelWriter &writer, const QVector<QVariant> &header)
+{
+    firstRow = true;
+    writer.write(isCompact() ? QLatin1String("{") : QLatin1String("{\n"));
+    if (storeHeader) {
+        QJsonArray columns;
+        for (const QVariant& v : header)
+            columns.append(QJsonValue::fromVariant(v));
+        writeKey(writer, "header");
+        writeArray(writer, columns, 1);
+        writer.write(isCompact() ? QLatin1String(",") : QLatin1String(",\n"));
+    }
+    writeKey(writer, "items");
+    writer.write(isCompact() ? QLatin1String("[") : QLatin1String("[\n"));
+}
+
+void QtJsonSerializer::writeRow(QtTableModelWriter &writer, int, const QVariant *values, int count)
+{
+    if (!firstRow)
+        writer.write(isCompact() ? QLatin1String(",") : QLatin1String(",\n"));
+    firstRow = false;
+
+    QJsonArray array;
+    for (int c = 0; c < count; ++c)
+        array.append(jsonValue(values[c]));
+    writeArray(writer, array, 2);
 }
 
-void QtTableModelJsonExporterPrivate::storeTableHeader(QJsonObject &json)
+void QtJsonSerializer::end(QtTableModelWriter &writer)
 {
-    QJsonArray columns;
-    QAbstractTableModel *m = q->model();
-    for (int i = 0, n = m->columnCount(); i < n; ++i) {
-        columns.append(QJsonValue::fromVariant(m->headerData(i, Qt::Horizontal, Qt::DisplayRole)));
+    if (isCompact()) {
+        writer.write(QLatin1String("],"));
+    } else {
+        if (!firstRow)
+            writer.write('\n');
+        writer.write(QLatin1String("    ],\n"));
     }
-    json["header"] = columns;
+
+    // the string is serialized as the single array item
+    const QByteArray json = QJsonDocument(QJsonArray{ title }).toJson(QJsonDocument::Compact);
+    writeKey(writer, "title");
+    writeJson(writer, json.mid(1, json.size() - 2));
+    writer.write(isCompact() ? QLatin1String("}") : QLatin1String("\n}\n"));
 }
 
-QJsonValue QtTableModelJsonExporterPrivate::jsonValue(const QVariant &v) const
+void QtJsonSerializer::writeKey(QtTableModelWriter &writer, const char *key) const
+{
+    if (!isCompact())
+        writer.write(QLatin1String("    "));
+    writer.write('"');
+    writer.write(QLatin1String(key));
+    writer.write(isCompact() ? QLatin1String("\":") : QLatin1String("\": "));
+}
+
+void QtJsonSerializer::writeArray(QtTableModelWriter &writer, const QJsonArray &array, int indent) const
+{
+    const QByteArray json = QJsonDocument(array).toJson(jsonFormat);
+    if (isCompact()) {
+        writeJson(writer, json);
+        return;
+    }
+
+    // indent every line of the nested array, the
+    // first one is indented by the key if any
+    QByteArray text;
+    text.reserve(json.size() * 2);
+    const QByteArray padding(indent * 4, ' ');
+    int from = 0;
+    for (int to = json.indexOf('\n'); to != -1; to = json.indexOf('\n', from)) {
+        if (from != 0 || indent > 1)
+            text.append(padding);
+        text.append(json.constData() + from, to - from);
+        from = to + 1;
+        if (from < json.size())
+            text.append('\n');
+    }
+    writeJson(writer, text);
+}
+
+void QtJsonSerializer::writeJson(QtTableModelWriter &writer, const QByteArray &json) const
+{
+    // json is always UTF-8
+    if (writer.isUtf8())
+        writer.write(json);
+    else
+        writer.write(QString::fromUtf8(json));
+}
+
+QJsonValue QtJsonSerializer::jsonValue(const QVariant &v) const
 {
     switch (v.type()) {
     case QVariant::Date:
@@ -71,7 +175,7 @@ QJsonValue QtTableModelJsonExporterPrivate::jsonValue(const QVariant &v) const
     case QVariant::Time:
         return v.value<QTime>().toString(timeFormat);
     case QVariant::DateTime:
-        return v.value<QDateTime>().toString(dateFormat + " " + timeFormat);
+        return v.value<QDateTime>().toString(dateTimeFormat);
     case QVariant::ByteArray:
         return QString(v.value<QByteArray>().toBase64());
     case QVariant::RegExp:
@@ -150,59 +254,16 @@ QStringList QtTableModelJsonExporter::fileFilter() const
     return QStringList() << "JSON files(*.json)";
 }
 
-bool QtTableModelJsonExporter::exportModel(QIODevice *device)
+QtTableModelSerializer *QtTableModelJsonExporter::createSerializer() const
 {
-    if (!beginExport(device))
-        return false;
-
-    QJsonDocument document;
-
-    d->json["title"] = tableName();
-    if (isHeaderStored()) {
-        d->storeTableHeader(d->json);
-    }
-
-    storeIndex(QModelIndex());
-
-    document.setObject(d->json);
-
-    QTextStream stream;
-    stream.setDevice(device);
-    stream.setCodec(textCodec());
-
-    stream << document.toJson(d->jsonFormat);
-
-    endExport();
-
-    d->json = QJsonObject();
-    d->array = QJsonArray();
-    return (stream.status() == QTextStream::Ok);
-}
-
-void QtTableModelJsonExporter::storeIndex(const QModelIndex &index)
-{
-    if (aborted())
-        return;
-
-    if (index.isValid()) {
-        d->array.append(d->jsonValue(index.data(itemRole())));
-        return;
-    }
-
-    QJsonArray modelData;
-    const QAbstractTableModel *m = model();
-    const int rowCount =  m->rowCount(index);
-    const int columnCount =  m->columnCount(index);
-    int step = 0;
-    for (int r = 0; r < rowCount; ++r) {
-        d->array = QJsonArray();
-        for (int c = 0; c < columnCount; ++c) {
-            storeIndex(m->index(r, c, index));
-            setProgress(++step);
-        }
-        modelData.append(d->array);
-    }
-    d->json["items"] = modelData;
+    QtJsonSerializer *serializer = new QtJsonSerializer;
+    serializer->storeHeader = isHeaderStored();
+    serializer->title = tableName();
+    serializer->dateFormat = d->dateFormat;
+    serializer->timeFormat = d->timeFormat;
+    serializer->dateTimeFormat = d->dateFormat + " " + d->timeFormat;
+    serializer->jsonFormat = d->jsonFormat;
+    return serializer;
 }
 
 QWidget *QtTableModelJsonExporter::createEditor(QDialog *parent) const
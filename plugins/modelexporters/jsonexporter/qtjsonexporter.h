@@ -48,11 +48,10 @@ public:
     Format jsonFormat() const;
 
     QStringList fileFilter() const override;
-    bool exportModel(QIODevice *device) override;
     QWidget *createEditor(QDialog *parent) const override;
 
 protected:
-    void storeIndex(const QModelIndex &index) override;
+    QtTableModelSerializer *createSerializer() const override;
 
 private:
     QScopedPointer<class QtTableModelJsonExporterPrivate> d;
@@ -0,0 +1,721 @@
+#include "qtxlsxexporter.h"
+#include "qtzipstream.h"
+#include <QtTableModelSerializer>
+#include <QVariant>
+#include <QDateTime>
+#include <QHash>
+#include <QRegularExpression>
+#include <QVector>
+#include <QCoreApplication>
+#include <QtPropertyWidget>
+#include <QDialog>
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+
+QT_METAINFO_TR(QtTableModelXlsxExporter)
+{
+    QT_TR_META("QtTableModelXlsxExporterPrivate", "Excel Workbook Export"),
+    QT_TR_META("QtTableModelXlsxExporterPrivate", "Date format"), // Формат даты
+    QT_TR_META("QtTableModelXlsxExporterPrivate", "Time format"), // Формат времени
+};
+
+
+class QtTableModelXlsxExporterPrivate
+{
+    Q_DECLARE_TR_FUNCTIONS(QtTableModelXlsxExporterPrivate)
+public:
+    QtTableModelXlsxExporter *q;
+    QString dateFormat;
+    QString timeFormat;
+
+    QtTableModelXlsxExporterPrivate(QtTableModelXlsxExporter* e)
+        : q(e)
+    {}
+};
+
+
+namespace
+{
+
+// limits of the worksheet, data beyond them is dropped
+enum
+{
+    MaxRows = 1048576,
+    MaxColumns = 16384,
+    MaxCellText = 32767
+};
+
+// shared strings table stays in memory until the end of export,
+// so it's bounded: long strings and new strings seen after the
+// table is full are written inline into the sheet
+enum
+{
+    MaxSharedText = 255,
+    MaxSharedStrings = 65536,
+    MaxSharedBytes = 4 << 20
+};
+
+// cell formats of styles.xml
+enum Style
+{
+    DefaultStyle,
+    DateStyle,
+    TimeStyle,
+    DateTimeStyle,
+    HeaderStyle
+};
+
+// julian day of 1899-12-30, the day zero of Excel
+const qint64 ExcelEpoch = 2415019;
+
+const char XmlDeclaration[] = "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n";
+const char MainNamespace[] = "http://schemas.openxmlformats.org/spreadsheetml/2006/main";
+
+const char ContentTypesXml[] =
+        "<Types xmlns=\"http://schemas.openxmlformats.org/package/2006/content-types\">"
+        "<Default Extension=\"rels\" ContentType=\"application/vnd.openxmlformats-package.relationships+xml\"/>"
+        "<Default Extension=\"xml\" ContentType=\"application/xml\"/>"
+        "<Override PartName=\"/xl/workbook.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.sheet.main+xml\"/>"
+        "<Override PartName=\"/xl/worksheets/sheet1.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.worksheet+xml\"/>"
+        "<Override PartName=\"/xl/styles.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.styles+xml\"/>"
+        "<Override PartName=\"/xl/sharedStrings.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.sharedStrings+xml\"/>"
+        "</Types>";
+
+const char RootRelsXml[] =
+        "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+        "<Relationship Id=\"rId1\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/officeDocument\" Target=\"xl/workbook.xml\"/>"
+        "</Relationships>";
+
+const char WorkbookRelsXml[] =
+        "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+        "<Relationship Id=\"rId1\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/worksheet\" Target=\"worksheets/sheet1.xml\"/>"
+        "<Relationship Id=\"rId2\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/styles\" Target=\"styles.xml\"/>"
+        "<Relationship Id=\"rId3\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/sharedStrings\" Target=\"sharedStrings.xml\"/>"
+        "</Relationships>";
+
+
+template<class _Int>
+inline void appendNumber(QByteArray& out, _Int value)
+{
+    char buf[24];
+    const auto result = std::to_chars(buf, buf + sizeof(buf), value);
+    out.append(buf, static_cast<int>(result.ptr - buf));
+}
+
+inline void appendNumber(QByteArray& out, double value)
+{
+    // shortest representation which reads back exactly
+#if defined(__cpp_lib_to_chars)
+    char buf[32];
+    const auto result = std::to_chars(buf, buf + sizeof(buf), value);
+    out.append(buf, static_cast<int>(result.ptr - buf));
+#else
+    out.append(QByteArray::number(value, 'g', 17));
+#endif
+}
+
+// appends UTF-16 text as escaped UTF-8, characters not allowed in XML are dropped
+void appendXml(QByteArray& out, QStringView text)
+{
+    // reserve the worst case at once, then write through the pointer
+    const int offset = out.size();
+    out.resize(offset + static_cast<int>(text.size()) * 6);
+    char* dst = out.data() + offset;
+
+    const QChar* src = text.data();
+    const QChar* end = src + text.size();
+    for (; src != end; ++src)
+    {
+        uint u = src->unicode();
+        if (u < 0x80)
+        {
+            switch (u)
+            {
+            case '&':  memcpy(dst, "&amp;", 5);  dst += 5; break;
+            case '<':  memcpy(dst, "&lt;", 4);   dst += 4; break;
+            case '>':  memcpy(dst, "&gt;", 4);   dst += 4; break;
+            case '"':  memcpy(dst, "&quot;", 6); dst += 6; break;
+            case '\r': memcpy(dst, "&#13;", 5);  dst += 5; break;
+            case '\t':
+            case '\n':
+                *dst++ = char(u);
+                break;
+            default:
+                if (u >= 0x20)
+                    *dst++ = char(u);
+            }
+            continue;
+        }
+
+        if (QChar::isHighSurrogate(u) && src + 1 != end && (src + 1)->isLowSurrogate())
+        {
+            u = QChar::surrogateToUcs4(ushort(u), (++src)->unicode());
+            *dst++ = char(0xf0 | (u >> 18));
+            *dst++ = char(0x80 | ((u >> 12) & 0x3f));
+            *dst++ = char(0x80 | ((u >> 6) & 0x3f));
+            *dst++ = char(0x80 | (u & 0x3f));
+            continue;
+        }
+
+        if (u == 0xfffe || u == 0xffff)
+            continue;
+
+        if (QChar::isSurrogate(u))
+            u = QChar::ReplacementCharacter;
+
+        if (u < 0x800)
+        {
+            *dst++ = char(0xc0 | (u >> 6));
+        }
+        else
+        {
+            *dst++ = char(0xe0 | (u >> 12));
+            *dst++ = char(0x80 | ((u >> 6) & 0x3f));
+        }
+        *dst++ = char(0x80 | (u & 0x3f));
+    }
+    out.resize(static_cast<int>(dst - out.data()));
+}
+
+// appends <t> element, leading and trailing spaces are kept
+void appendTextElement(QByteArray& out, QStringView text)
+{
+    if (text.front().isSpace() || text.back().isSpace())
+        out.append("<t xml:space=\"preserve\">");
+    else
+        out.append("<t>");
+    appendXml(out, text);
+    out.append("</t>");
+}
+
+// A..Z, AA..ZZ, AAA..XFD
+QByteArray columnName(int column)
+{
+    QByteArray name;
+    for (int n = column + 1; n > 0; n /= 26)
+    {
+        --n;
+        name.prepend(char('A' + n % 26));
+    }
+    return name;
+}
+
+// translates QDate/QTime format into Excel number format
+QString excelFormat(const QString& format)
+{
+    QString result;
+    const int size = format.size();
+    for (int i = 0; i < size; )
+    {
+        const QChar c = format.at(i);
+        if (c == QLatin1Char('\''))
+        {
+            // quoted text, '' stands for the quote itself
+            if (i + 1 < size && format.at(i + 1) == QLatin1Char('\''))
+            {
+                result += QLatin1String("\\'");
+                i += 2;
+                continue;
+            }
+
+            result += QLatin1Char('"');
+            int j = i + 1;
+            for (; j < size; ++j)
+            {
+                const QChar t = format.at(j);
+                if (t == QLatin1Char('\''))
+                {
+                    if (j + 1 < size && format.at(j + 1) == QLatin1Char('\''))
+                    {
+                        result += t;
+                        ++j;
+                        continue;
+                    }
+                    break;
+                }
+                if (t == QLatin1Char('"'))
+                    result += QLatin1String("\"\\\"\"");
+                else
+                    result += t;
+            }
+            result += QLatin1Char('"');
+            i = j + 1;
+            continue;
+        }
+
+        int n = 1;
+        while (i + n < size && format.at(i + n) == c)
+            ++n;
+
+        switch (c.unicode())
+        {
+        case 'd':
+            result += QString(qMin(n, 4), QLatin1Char('d'));
+            break;
+        case 'M':
+            result += QString(qMin(n, 4), QLatin1Char('m'));
+            break;
+        case 'y':
+            result += QLatin1String(n >= 4 ? "yyyy" : "yy");
+            break;
+        case 'h':
+        case 'H':
+            result += QString(qMin(n, 2), QLatin1Char('h'));
+            break;
+        case 'm':
+            result += QString(qMin(n, 2), QLatin1Char('m'));
+            break;
+        case 's':
+            result += QString(qMin(n, 2), QLatin1Char('s'));
+            break;
+        case 'z':
+            result += QLatin1String(n >= 3 ? "000" : "0");
+            break;
+        case 'a':
+        case 'A':
+            result += QLatin1String(c == QLatin1Char('a') ? "am/pm" : "AM/PM");
+            if (i + n < size && format.at(i + n).toLower() == QLatin1Char('p'))
+                ++n;
+            break;
+        case 't':
+            // time zone has no counterpart
+            break;
+        default:
+            for (int k = 0; k < n; ++k)
+            {
+                if (!QLatin1String(" -:./,()").contains(c))
+                    result += QLatin1Char('\\');
+                result += c;
+            }
+        }
+        i += n;
+    }
+    return result;
+}
+
+// sheet names are limited to 31 characters and can't contain []:*?/\ .
+QString sheetName(const QString& title)
+{
+    QString name = title;
+    name.remove(QRegularExpression(QStringLiteral("[\\[\\]:*?/\\\\]")));
+    name = name.trimmed().left(31);
+    while (name.startsWith(QLatin1Char('\'')))
+        name.remove(0, 1);
+    while (name.endsWith(QLatin1Char('\'')))
+        name.chop(1);
+    return name.isEmpty() ? QStringLiteral("Sheet1") : name;
+}
+
+}
+
+
+class QtXlsxSerializer :
+        public QtTableModelSerializer
+{
+public:
+    QtXlsxSerializer(bool header, const QString& tableName,
+                     const QString& dateFormat, const QString& timeFormat);
+
+    void begin(QtTableModelWriter &writer, const QVector<QVariant> &header) Q_DECL_OVERRIDE;
+    void writeRow(QtTableModelWriter &writer, int row, const QVariant *values, int count) Q_DECL_OVERRIDE;
+    void end(QtTableModelWriter &writer) Q_DECL_OVERRIDE;
+
+private:
+    void writePart(const char* name, const QByteArray& xml);
+    QByteArray stylesXml() const;
+    QByteArray workbookXml() const;
+
+    inline void beginRow(QByteArray& out);
+    inline void beginCell(QByteArray& out, int column, const char* type, int style);
+    void writeCell(QByteArray& out, int column, const QVariant& value);
+    void writeText(QByteArray& out, int column, const QString& text, int style);
+    void writeSerial(QByteArray& out, int column, const QDate& date, double time, int style);
+
+    bool storeHeader;
+    QString sheet;
+    QString dateFormat;
+    QString timeFormat;
+
+    QScopedPointer<QtZipStream> zip;
+    QVector<QByteArray> columnNames;
+    QByteArray rowRef;
+    int rowCount;
+
+    QHash<QString, int> sharedIndex;
+    QByteArray sharedXml;
+};
+
+
+QtXlsxSerializer::QtXlsxSerializer(bool header, const QString &tableName,
+                                   const QString &date, const QString &time)
+    : storeHeader(header)
+    , sheet(sheetName(tableName))
+    , dateFormat(excelFormat(date))
+    , timeFormat(excelFormat(time))
+    , rowCount(0)
+{
+    rowRef.reserve(16);
+}
+
+void QtXlsxSerializer::begin(QtTableModelWriter &writer, const QVector<QVariant> &header)
+{
+    zip.reset(new QtZipStream(writer));
+    if (!zip->isValid()) {
+        setErrorString(QtTableModelXlsxExporter::tr("failed to initialize compression"));
+        zip.reset();
+        return;
+    }
+
+    writePart("[Content_Types].xml", ContentTypesXml);
+    writePart("_rels/.rels", RootRelsXml);
+    writePart("xl/workbook.xml", workbookXml());
+    writePart("xl/_rels/workbook.xml.rels", WorkbookRelsXml);
+    writePart("xl/styles.xml", stylesXml());
+
+    const int columnCount = qMin(header.size(), int(MaxColumns));
+    columnNames.reserve(columnCount);
+    for (int c = 0; c < columnCount; ++c)
+        columnNames.append(columnName(c));
+
+    zip->beginEntry("xl/worksheets/sheet1.xml");
+    QByteArray& out = zip->buffer();
+    out.append(XmlDeclaration);
+    out.append("<worksheet xmlns=\"");
+    out.append(MainNamespace);
+    out.append("\">");
+    if (storeHeader) {
+        // keep column names visible while scrolling
+        out.append("<sheetViews><sheetView workbookViewId=\"0\">"
+                   "<pane ySplit=\"1\" topLeftCell=\"A2\" activePane=\"bottomLeft\" state=\"frozen\"/>"
+                   "</sheetView></sheetViews>");
+    }
+    out.append("<sheetData>");
+
+    if (storeHeader) {
+        beginRow(out);
+        for (int c = 0; c < columnCount; ++c)
+            writeText(out, c, header[c].toString(), HeaderStyle);
+        out.append("</row>");
+    }
+    zip->commit();
+}
+
+void QtXlsxSerializer::writeRow(QtTableModelWriter &, int, const QVariant *values, int count)
+{
+    if (rowCount >= MaxRows)
+        return;
+
+    QByteArray& out = zip->buffer();
+    beginRow(out);
+    count = qMin(count, columnNames.size());
+    for (int c = 0; c < count; ++c)
+        writeCell(out, c, values[c]);
+    out.append("</row>");
+    zip->commit();
+}
+
+void QtXlsxSerializer::end(QtTableModelWriter &)
+{
+    zip->buffer().append("</sheetData></worksheet>");
+    zip->endEntry();
+
+    zip->beginEntry("xl/sharedStrings.xml");
+    QByteArray& out = zip->buffer();
+    out.append(XmlDeclaration);
+    out.append("<sst xmlns=\"");
+    out.append(MainNamespace);
+    out.append("\" uniqueCount=\"");
+    appendNumber(out, sharedIndex.size());
+    out.append("\">");
+    zip->write(sharedXml);
+    zip->buffer().append("</sst>");
+    zip->endEntry();
+
+    sharedIndex.clear();
+    sharedXml.clear();
+
+    zip->finish();
+    zip.reset();
+}
+
+void QtXlsxSerializer::writePart(const char *name, const QByteArray &xml)
+{
+    zip->beginEntry(name);
+    zip->write(XmlDeclaration, int(sizeof(XmlDeclaration)) - 1);
+    zip->write(xml);
+    zip->endEntry();
+}
+
+QByteArray QtXlsxSerializer::stylesXml() const
+{
+    const QString formats[] = {
+        dateFormat,
+        timeFormat,
+        dateFormat + QLatin1Char(' ') + timeFormat
+    };
+
+    QByteArray xml;
+    xml.append("<styleSheet xmlns=\"");
+    xml.append(MainNamespace);
+    xml.append("\"><numFmts count=\"3\">");
+    for (int i = 0; i < 3; ++i) {
+        xml.append("<numFmt numFmtId=\"");
+        appendNumber(xml, 164 + i); // first id of custom formats
+        xml.append("\" formatCode=\"");
+        appendXml(xml, formats[i]);
+        xml.append("\"/>");
+    }
+    xml.append("</numFmts>"
+               "<fonts count=\"2\">"
+               "<font><sz val=\"11\"/><name val=\"Calibri\"/></font>"
+               "<font><b/><sz val=\"11\"/><name val=\"Calibri\"/></font>"
+               "</fonts>"
+               "<fills count=\"2\">"
+               "<fill><patternFill patternType=\"none\"/></fill>"
+               "<fill><patternFill patternType=\"gray125\"/></fill>"
+               "</fills>"
+               "<borders count=\"1\"><border><left/><right/><top/><bottom/><diagonal/></border></borders>"
+               "<cellStyleXfs count=\"1\"><xf numFmtId=\"0\" fontId=\"0\" fillId=\"0\" borderId=\"0\"/></cellStyleXfs>"
+               "<cellXfs count=\"5\">" // in the order of Style
+               "<xf numFmtId=\"0\" fontId=\"0\" fillId=\"0\" borderId=\"0\" xfId=\"0\"/>"
+               "<xf numFmtId=\"164\" fontId=\"0\" fillId=\"0\" borderId=\"0\" xfId=\"0\" applyNumberFormat=\"1\"/>"
+               "<xf numFmtId=\"165\" fontId=\"0\" fillId=\"0\" borderId=\"0\" xfId=\"0\" applyNumberFormat=\"1\"/>"
+               "<xf numFmtId=\"166\" fontId=\"0\" fillId=\"0\" borderId=\"0\" xfId=\"0\" applyNumberFormat=\"1\"/>"
+               "<xf numFmtId=\"0\" fontId=\"1\" fillId=\"0\" borderId=\"0\" xfId=\"0\" applyFont=\"1\"/>"
+               "</cellXfs>"
+               "<cellStyles count=\"1\"><cellStyle name=\"Normal\" xfId=\"0\" builtinId=\"0\"/></cellStyles>"
+               "</styleSheet>");
+    return xml;
+}
+
+QByteArray QtXlsxSerializer::workbookXml() const
+{
+    QByteArray xml;
+    xml.append("<workbook xmlns=\"");
+    xml.append(MainNamespace);
+    xml.append("\" xmlns:r=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships\">"
+               "<sheets><sheet name=\"");
+    appendXml(xml, sheet);
+    xml.append("\" sheetId=\"1\" r:id=\"rId1\"/></sheets></workbook>");
+    return xml;
+}
+
+void QtXlsxSerializer::beginRow(QByteArray &out)
+{
+    rowRef.resize(0);
+    appendNumber(rowRef, ++rowCount);
+    out.append("<row r=\"");
+    out.append(rowRef);
+    out.append("\">");
+}
+
+void QtXlsxSerializer::beginCell(QByteArray &out, int column, const char *type, int style)
+{
+    out.append("<c r=\"");
+    out.append(columnNames[column]);
+    out.append(rowRef);
+    out.append('"');
+    if (style != DefaultStyle) {
+        out.append(" s=\"");
+        appendNumber(out, style);
+        out.append('"');
+    }
+    if (type) {
+        out.append(" t=\"");
+        out.append(type);
+        out.append('"');
+    }
+    out.append('>');
+}
+
+void QtXlsxSerializer::writeCell(QByteArray &out, int column, const QVariant &value)
+{
+    switch (value.userType())
+    {
+    case QMetaType::UnknownType:
+        break;
+    case QMetaType::Bool:
+        beginCell(out, column, "b", DefaultStyle);
+        out.append(value.toBool() ? "<v>1</v></c>" : "<v>0</v></c>");
+        break;
+    case QMetaType::Int:
+    case QMetaType::Short:
+    case QMetaType::SChar:
+        beginCell(out, column, Q_NULLPTR, DefaultStyle);
+        out.append("<v>");
+        appendNumber(out, value.toInt());
+        out.append("</v></c>");
+        break;
+    case QMetaType::UInt:
+    case QMetaType::UShort:
+    case QMetaType::UChar:
+        beginCell(out, column, Q_NULLPTR, DefaultStyle);
+        out.append("<v>");
+        appendNumber(out, value.toUInt());
+        out.append("</v></c>");
+        break;
+    case QMetaType::LongLong:
+        beginCell(out, column, Q_NULLPTR, DefaultStyle);
+        out.append("<v>");
+        appendNumber(out, value.toLongLong());
+        out.append("</v></c>");
+        break;
+    case QMetaType::ULongLong:
+        beginCell(out, column, Q_NULLPTR, DefaultStyle);
+        out.append("<v>");
+        appendNumber(out, value.toULongLong());
+        out.append("</v></c>");
+        break;
+    case QMetaType::Double:
+    case QMetaType::Float:
+    {
+        const double d = value.toDouble();
+        if (!std::isfinite(d)) {
+            writeText(out, column, value.toString(), DefaultStyle);
+            break;
+        }
+        beginCell(out, column, Q_NULLPTR, DefaultStyle);
+        out.append("<v>");
+        appendNumber(out, d);
+        out.append("</v></c>");
+    }
+        break;
+    case QMetaType::QDate:
+    {
+        const QDate date = value.toDate();
+        if (date.isValid())
+            writeSerial(out, column, date, 0.0, DateStyle);
+    }
+        break;
+    case QMetaType::QTime:
+    {
+        const QTime time = value.toTime();
+        if (time.isValid())
+            writeSerial(out, column, QDate(), time.msecsSinceStartOfDay() / 86400000.0, TimeStyle);
+    }
+        break;
+    case QMetaType::QDateTime:
+    {
+        const QDateTime dateTime = value.toDateTime();
+        if (dateTime.isValid())
+            writeSerial(out, column, dateTime.date(), dateTime.time().msecsSinceStartOfDay() / 86400000.0, DateTimeStyle);
+    }
+        break;
+    default:
+        writeText(out, column, value.toString(), DefaultStyle);
+    }
+}
+
+void QtXlsxSerializer::writeText(QByteArray &out, int column, const QString &text, int style)
+{
+    if (text.isEmpty())
+        return;
+
+    QStringView view(text);
+    if (view.size() > MaxCellText)
+        view = view.left(MaxCellText);
+
+    if (text.size() <= MaxSharedText) {
+        int index = sharedIndex.value(text, -1);
+        if (index < 0 && sharedIndex.size() < MaxSharedStrings && sharedXml.size() < MaxSharedBytes) {
+            index = sharedIndex.size();
+            sharedIndex.insert(text, index);
+            sharedXml.append("<si>");
+            appendTextElement(sharedXml, view);
+            sharedXml.append("</si>");
+        }
+
+        if (index >= 0) {
+            beginCell(out, column, "s", style);
+            out.append("<v>");
+            appendNumber(out, index);
+            out.append("</v></c>");
+            return;
+        }
+    }
+
+    beginCell(out, column, "inlineStr", style);
+    out.append("<is>");
+    appendTextElement(out, view);
+    out.append("</is></c>");
+}
+
+void QtXlsxSerializer::writeSerial(QByteArray &out, int column, const QDate &date, double time, int style)
+{
+    qint64 days = 0;
+    if (date.isValid()) {
+        days = date.toJulianDay() - ExcelEpoch;
+        // Excel counts nonexistent 1900-02-29 and has nothing before 1900
+        if (days < 61)
+            --days;
+        if (days < 1) {
+            writeText(out, column, date.toString(Qt::ISODate), style);
+            return;
+        }
+    }
+
+    beginCell(out, column, Q_NULLPTR, style);
+    out.append("<v>");
+    if (time == 0.0)
+        appendNumber(out, days);
+    else
+        appendNumber(out, double(days) + time);
+    out.append("</v></c>");
+}
+
+
+
+QtTableModelXlsxExporter::QtTableModelXlsxExporter(QAbstractTableModel* model) :
+    QtTableModelExporter(model),
+    d(new QtTableModelXlsxExporterPrivate(this))
+{
+    d->dateFormat = "dd.MM.yyyy";
+    d->timeFormat = "hh:mm:ss";
+}
+
+QtTableModelXlsxExporter::~QtTableModelXlsxExporter()
+{
+}
+
+void QtTableModelXlsxExporter::setDateFormat(const QString& format)
+{
+    d->dateFormat = format;
+}
+
+QString QtTableModelXlsxExporter::dateFormat() const
+{
+    return d->dateFormat;
+}
+
+void QtTableModelXlsxExporter::setTimeFormat(const QString& format)
+{
+    d->timeFormat = format;
+}
+
+QString QtTableModelXlsxExporter::timeFormat() const
+{
+    return d->timeFormat;
+}
+
+QStringList QtTableModelXlsxExporter::fileFilter() const
+{
+    return (QStringList() << tr("Excel Workbook (*.xlsx)"));
+}
+
+QtTableModelSerializer *QtTableModelXlsxExporter::createSerializer() const
+{
+    return new QtXlsxSerializer(isHeaderStored(), tableName(), d->dateFormat, d->timeFormat);
+}
+
+QWidget *QtTableModelXlsxExporter::createEditor(QDialog *parent) const
+{
+    QtPropertyWidget* editor = new QtPropertyWidget(parent);
+    editor->setObject(const_cast<QtTableModelXlsxExporter*>(this));
+    editor->setClassFilter(QStringLiteral("^(?!QObject$).*"));
+    QObject::connect(parent, SIGNAL(accepted()), editor, SLOT(submit()));
+    QObject::connect(parent, SIGNAL(rejected()), editor, SLOT(revert()));
+    return editor;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <QtTableModelExporter>
+
+//
+// QtTableModelXlsxExporter writes Office Open XML workbook
+// on its own, without Microsoft Excel installed. The sheet is
+// streamed row by row into the deflated zip entry, so memory
+// use doesn't depend on the number of rows
+//
+class QtTableModelXlsxExporter :
+        public QtTableModelExporter
+{
+    Q_OBJECT
+    Q_CLASSINFO("QtTableModelXlsxExporter", "Excel Workbook Export")
+
+    Q_PROPERTY(QString dateFormat READ dateFormat WRITE setDateFormat)
+    Q_CLASSINFO("dateFormat", "Date format")
+
+    Q_PROPERTY(QString timeFormat READ timeFormat WRITE setTimeFormat)
+    Q_CLASSINFO("timeFormat", "Time format")
+
+public:
+    explicit QtTableModelXlsxExporter(QAbstractTableModel* model = Q_NULLPTR);
+    ~QtTableModelXlsxExporter();
+
+    void setDateFormat(const QString& format);
+    QString dateFormat() const;
+
+    void setTimeFormat(const QString& format);
+    QString timeFormat() const;
+
+    QStringList fileFilter() const;
+
+    // QtTableModelExporterPlugin interface
+    QWidget *createEditor(QDialog *parent) const;
+
+protected:
+    QtTableModelSerializer *createSerializer() const;
+
+private:
+    QScopedPointer<class QtTableModelXlsxExporterPrivate> d;
+};
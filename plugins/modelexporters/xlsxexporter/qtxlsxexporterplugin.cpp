@@ -0,0 +1,23 @@
+#include "qtxlsxexporterplugin.h"
+#include "qtxlsxexporter.h"
+
+
+QtXlsxExporterPlugin::QtXlsxExporterPlugin(QObject *parent) :
+    QObject(parent)
+{
+}
+
+QtTableModelExporter* QtXlsxExporterPlugin::create(QAbstractTableModel* model) const
+{
+    return new QtTableModelXlsxExporter(model);
+}
+
+QString QtXlsxExporterPlugin::exporterName() const
+{
+    return QStringLiteral("Excel Workbook");
+}
+
+QIcon QtXlsxExporterPlugin::icon() const
+{
+    return QIcon(":/images/export-excel");
+}
@@ -0,0 +1,191 @@
+#include <QDateTime>
+
+#include <QtTableModelSerializer>
+
+#include <zlib.h>
+
+#include "qtzipstream.h"
+
+namespace {
+
+enum : quint32
+{
+    LocalHeaderSignature = 0x04034b50,
+    DataDescriptorSignature = 0x08074b50,
+    CentralHeaderSignature = 0x02014b50,
+    EndOfDirectorySignature = 0x06054b50
+};
+
+enum : quint16
+{
+    VersionNeeded = 20,  // 2.0, deflate
+    EntryFlags = 0x0808, // data descriptor, UTF-8 names
+    MethodDeflate = 8
+};
+
+}
+
+
+QtZipStream::QtZipStream(QtTableModelWriter &w, int level)
+    : writer(w)
+    , stream(new z_stream)
+    , offset(0)
+    , open(false)
+{
+    stream->zalloc = Z_NULL;
+    stream->zfree = Z_NULL;
+    stream->opaque = Z_NULL;
+    // negative window bits produce raw deflate data without zlib header
+    valid = (deflateInit2(stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) == Z_OK);
+
+    const QDateTime now = QDateTime::currentDateTime();
+    const QDate date = now.date();
+    const QTime time = now.time();
+    dosTime = quint16((time.hour() << 11) | (time.minute() << 5) | (time.second() / 2));
+    dosDate = quint16((qMax(date.year() - 1980, 0) << 9) | (date.month() << 5) | date.day());
+
+    input.reserve(Threshold + Threshold / 4);
+}
+
+QtZipStream::~QtZipStream()
+{
+    if (valid)
+        deflateEnd(stream);
+    delete stream;
+}
+
+void QtZipStream::beginEntry(const QByteArray &name)
+{
+    Q_ASSERT(valid);
+    if (open)
+        endEntry();
+
+    Entry entry;
+    entry.name = name;
+    entry.crc = 0;
+    entry.compressedSize = 0;
+    entry.size = 0;
+    entry.offset = offset;
+    entries.push_back(entry);
+
+    // sizes and checksum follow the data in the descriptor
+    writeHeader(LocalHeaderSignature);
+    write32(0);
+    write32(0);
+    write32(0);
+    write16(quint16(name.size()));
+    write16(0); // extra field
+    writer.write(name);
+    offset += quint32(name.size());
+
+    deflateReset(stream);
+    open = true;
+}
+
+void QtZipStream::endEntry()
+{
+    if (!open)
+        return;
+
+    deflateInput(Z_FINISH);
+    open = false;
+
+    const Entry& entry = entries.back();
+    write32(DataDescriptorSignature);
+    write32(entry.crc);
+    write32(entry.compressedSize);
+    write32(entry.size);
+    writer.commit();
+}
+
+void QtZipStream::finish()
+{
+    endEntry();
+
+    const quint32 directoryOffset = offset;
+    for (const Entry& entry : entries) {
+        writeHeader(CentralHeaderSignature);
+        write32(entry.crc);
+        write32(entry.compressedSize);
+        write32(entry.size);
+        write16(quint16(entry.name.size()));
+        write16(0); // extra field
+        write16(0); // comment
+        write16(0); // disk number
+        write16(0); // internal attributes
+        write32(0); // external attributes
+        write32(entry.offset);
+        writer.write(entry.name);
+        offset += quint32(entry.name.size());
+    }
+
+    const quint32 directorySize = offset - directoryOffset;
+    const quint16 count = quint16(qMin<size_t>(entries.size(), 0xffff));
+    write32(EndOfDirectorySignature);
+    write16(0); // disk number
+    write16(0); // disk with directory
+    write16(count);
+    write16(count);
+    write32(directorySize);
+    write32(directoryOffset);
+    write16(0); // comment
+    writer.commit();
+}
+
+void QtZipStream::deflateInput(int flush)
+{
+    Entry& entry = entries.back();
+    entry.crc = quint32(crc32(entry.crc, reinterpret_cast<const Bytef*>(input.constData()), uInt(input.size())));
+    entry.size += quint32(input.size());
+
+    stream->next_in = reinterpret_cast<Bytef*>(input.data());
+    stream->avail_in = uInt(input.size());
+
+    // deflate right into the writer buffer, the capacity
+    // it has reserved makes this free of reallocations
+    QByteArray& out = writer.buffer();
+    do {
+        const int used = out.size();
+        out.resize(used + ChunkSize);
+        stream->next_out = reinterpret_cast<Bytef*>(out.data() + used);
+        stream->avail_out = ChunkSize;
+        deflate(stream, flush);
+
+        const int produced = ChunkSize - int(stream->avail_out);
+        out.resize(used + produced);
+        entry.compressedSize += quint32(produced);
+        offset += quint32(produced);
+    } while (stream->avail_out == 0);
+
+    input.resize(0);
+    writer.commit();
+}
+
+void QtZipStream::writeHeader(quint32 signature)
+{
+    write32(signature);
+    if (signature == CentralHeaderSignature)
+        write16(VersionNeeded); // version made by
+    write16(VersionNeeded);
+    write16(EntryFlags);
+    write16(MethodDeflate);
+    write16(dosTime);
+    write16(dosDate);
+}
+
+void QtZipStream::write16(quint16 value)
+{
+    const char bytes[2] = { char(value & 0xff), char(value >> 8) };
+    writer.write(bytes, 2);
+    offset += 2;
+}
+
+void QtZipStream::write32(quint32 value)
+{
+    const char bytes[4] = {
+        char(value & 0xff), char((value >> 8) & 0xff),
+        char((value >> 16) & 0xff), char(value >> 24)
+    };
+    writer.write(bytes, 4);
+    offset += 4;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <QByteArray>
+#include <QtGlobal>
+
+#include <vector>
+
+class QtTableModelWriter;
+struct z_stream_s;
+
+//
+// QtZipStream writes zip archive sequentially into the table
+// model writer. Entries are deflated on the fly and followed by
+// data descriptors, so neither sizes nor checksums have to be
+// known in advance and only the central directory is kept in
+// memory until finish(). Archives over 4 GiB are not supported
+//
+class QtZipStream
+{
+    Q_DISABLE_COPY(QtZipStream)
+public:
+    explicit QtZipStream(QtTableModelWriter& writer, int level = 6);
+    ~QtZipStream();
+
+    // false if the deflate stream failed to initialize,
+    // nothing should be written into the archive then
+    inline bool isValid() const { return valid; }
+
+    void beginEntry(const QByteArray& name);
+    void endEntry();
+
+    // uncompressed data of the current entry
+    inline void write(const char* data, int size) { input.append(data, size); commit(); }
+    inline void write(const QByteArray& data) { write(data.constData(), data.size()); }
+
+    // buffer for data formatted in place, commit() should
+    // be called after every chunk (a row for instance)
+    inline QByteArray& buffer() { return input; }
+    inline void commit()
+    {
+        if (input.size() >= Threshold)
+            deflateInput(0); // Z_NO_FLUSH
+    }
+
+    // writes central directory, no entries can be added after it
+    void finish();
+
+private:
+    enum { Threshold = 64 * 1024, ChunkSize = 64 * 1024 };
+
+    struct Entry
+    {
+        QByteArray name;
+        quint32 crc;
+        quint32 compressedSize;
+        quint32 size;
+        quint32 offset;
+    };
+
+    void deflateInput(int flush);
+    void writeHeader(quint32 signature);
+    void write16(quint16 value);
+    void write32(quint32 value);
+
+    QtTableModelWriter& writer;
+    z_stream_s* stream;
+    std::vector<Entry> entries;
+    QByteArray input;
+    quint32 offset;
+    quint16 dosTime;
+    quint16 dosDate;
+    bool valid;
+    bool open;
+};
@@ -1,9 +1,11 @@
 ﻿#include "qtxmlexporter.h"
 #include <QTextCodec>
 #include <QXmlStreamWriter>
+#include <QIODevice>
 
 #include <QDialog>
 #include <QtPropertyWidget>
+#include <QtTableModelSerializer>
 
 QT_METAINFO_TR(QtTableModelXmlExporter)
 {
@@ -34,19 +36,102 @@ private:
 class QtTableModelXmlExporterPrivate
 {
 public:
-    QXmlStreamWriter xmlWriter;
-    QTextCodec *codec;
     bool autoFormat;
     QtTableModelXmlExporterPrivate();
 };
 
 
 QtTableModelXmlExporterPrivate::QtTableModelXmlExporterPrivate() :
-    codec(QTextCodec::codecForLocale()), autoFormat(true)
+    autoFormat(true)
 {
 }
 
 
+// QXmlStreamWriter output adapter
+class QtXmlWriterDevice :
+        public QIODevice
+{
+public:
+    explicit QtXmlWriterDevice(QtTableModelWriter& w)
+        : writer(w) {
+        open(QIODevice::WriteOnly);
+    }
+    bool isSequential() const Q_DECL_OVERRIDE {
+        return true;
+    }
+protected:
+    qint64 readData(char *, qint64) Q_DECL_OVERRIDE {
+        return -1;
+    }
+    qint64 writeData(const char *data, qint64 len) Q_DECL_OVERRIDE {
+        writer.write(data, static_cast<int>(len));
+        return len;
+    }
+private:
+    QtTableModelWriter& writer;
+};
+
+
+class QtXmlSerializer :
+        public QtTableModelSerializer
+{
+public:
+    QString tableName;
+    bool autoFormat;
+
+    void begin(QtTableModelWriter &writer, const QVector<QVariant> &header) Q_DECL_OVERRIDE;
+    void writeRow(QtTableModelWriter &writer, int row, const QVariant *values, int count) Q_DECL_OVERRIDE;
+    void end(QtTableModelWriter &writer) Q_DECL_OVERRIDE;
+
+private:
+    QScopedPointer<QtXmlWriterDevice> device;
+    QXmlStreamWriter xmlWriter;
+    QStringList columnNames;
+};
+
+void QtXmlSerializer::begin(QtTableModelWriter &writer, const QVector<QVariant> &header)
+{
+    QRegExp rx("^\\d+");
+
+    // element names of columns
+    columnNames.clear();
+    for (int c = 0; c < header.size(); ++c) {
+        QString headerText = header[c].toString().simplified();
+        headerText.replace(' ', '_');
+        if (headerText.isEmpty() || rx.indexIn(headerText) != -1)
+            columnNames << QString("column%1").arg(c);
+        else
+            columnNames << headerText;
+    }
+
+    device.reset(new QtXmlWriterDevice(writer));
+    xmlWriter.setDevice(device.data());
+    xmlWriter.setCodec(writer.codec());
+    xmlWriter.setAutoFormatting(autoFormat);
+    xmlWriter.writeStartDocument();
+    xmlWriter.writeStartElement("table");
+    xmlWriter.writeAttribute("name", tableName.isEmpty() ? QLatin1String("table") : tableName);
+}
+
+void QtXmlSerializer::writeRow(QtTableModelWriter &, int row, const QVariant *values, int count)
+{
+    QScopedXmlStreamElement rowElem(xmlWriter, "row");
+    xmlWriter.writeAttribute("id", QString::number(row));
+    for (int c = 0; c < count; ++c) {
+        QScopedXmlStreamElement elem(xmlWriter, columnNames[c]);
+        xmlWriter.writeCharacters(values[c].toString());
+    }
+}
+
+void QtXmlSerializer::end(QtTableModelWriter &)
+{
+    xmlWriter.writeEndElement(); // table
+    xmlWriter.writeEndDocument();
+    xmlWriter.setDevice(Q_NULLPTR);
+    device.reset();
+}
+
+
 QtTableModelXmlExporter::QtTableModelXmlExporter(QAbstractTableModel* model) :
     d(new QtTableModelXmlExporterPrivate)
 {
@@ -72,56 +157,12 @@ QStringList QtTableModelXmlExporter::fileFilter() const
     return (QStringList() << tr("XML Files (*.xml)"));
 }
 
-bool QtTableModelXmlExporter::exportModel(QIODevice *device)
-{
-    if (!beginExport(device))
-        return false;
-
-    d->xmlWriter.setDevice(device);
-    d->xmlWriter.setCodec(textCodec());
-    d->xmlWriter.setAutoFormatting(d->autoFormat);
-    d->xmlWriter.writeStartDocument();
-    {
-        QScopedXmlStreamElement tableElem(d->xmlWriter, "table");
-        d->xmlWriter.writeAttribute("name", tableName().isEmpty() ? QLatin1String("table") : tableName());
-        storeIndex();
-    }
-    d->xmlWriter.writeEndDocument();
-
-    endExport();
-    return true;
-}
-
-void QtTableModelXmlExporter::storeIndex(const QModelIndex& index)
+QtTableModelSerializer *QtTableModelXmlExporter::createSerializer() const
 {
-    const QAbstractTableModel *m = model();
-    if (index.isValid()) {
-        static QRegExp rx("^\\d+");
-
-        QString text;
-        QString headerText = m->headerData(index.column(), Qt::Horizontal, Qt::DisplayRole).toString();
-        headerText = headerText.simplified();
-        headerText.replace(' ', '_');
-        if (rx.indexIn(headerText) != -1)
-            text = QString("column%1").arg(index.column());
-        else
-            text = headerText.isEmpty() ? QStringLiteral("column%1").arg(index.column()) : headerText;
-
-        QScopedXmlStreamElement elem(d->xmlWriter, text);
-        d->xmlWriter.writeCharacters(index.data(itemRole()).toString());
-        return;
-    }
-
-    const int rowCount =  m->rowCount(index);
-    const int columnCount =  m->columnCount(index);
-    int step = 0;
-    for (int r = 0; r < rowCount; ++r) {
-        QScopedXmlStreamElement rowElem(d->xmlWriter, "row");
-        d->xmlWriter.writeAttribute("id", QString::number(r));
-        for (int c = 0; c < columnCount; ++c)
-            storeIndex(m->index(r, c, index));
-        setProgress(++step);
-    }
+    QtXmlSerializer *serializer = new QtXmlSerializer;
+    serializer->tableName = tableName();
+    serializer->autoFormat = d->autoFormat;
+    return serializer;
 }
 
 QWidget *QtTableModelXmlExporter::createEditor(QDialog *parent) const
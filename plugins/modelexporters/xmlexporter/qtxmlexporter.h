@@ -19,10 +19,11 @@ public:
 
     // QtTableModelExporter interface
     QStringList fileFilter() const override;
-    bool exportModel(QIODevice *device) override;
-    void storeIndex(const QModelIndex& index = QModelIndex()) override;
     QWidget *createEditor(QDialog *parent) const override;
 
+protected:
+    QtTableModelSerializer *createSerializer() const override;
+
 private:
     QScopedPointer<class QtTableModelXmlExporterPrivate> d;
 };
@@ -1,6 +1,7 @@
 #include "hunspellbackend.h"
 #include <unordered_map>
 #include <memory>
+#include <vector>
 
 #include <hunspell/hunspell.hxx>
 
@@ -13,6 +14,10 @@
 #include <QStandardPaths>
 #include <QDebug>
 #include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThread>
 
 #if (QT_VERSION < QT_VERSION_CHECK(5, 14, 0))
 namespace std
@@ -26,25 +31,169 @@ namespace std
 } // namespace std
 #endif
 
+namespace
+{
+    using UStringMap = std::unordered_map<QString, QString>;
+
+    // installed dictionaries, the directories are scanned
+    // once and the result is shared by all backends
+    struct DictionaryIndex
+    {
+        QMutex mutex;
+        bool scanned = false;
+        UStringMap paths;   // language -> directory
+        UStringMap aliases; // language -> language of the linked dictionary
+    };
+
+    DictionaryIndex& dictionaryIndex()
+    {
+        static DictionaryIndex index;
+        return index;
+    }
+
+    // words are converted into the same buffer
+    // of the thread, so it's allocated only once
+    std::string& wordBuffer()
+    {
+        thread_local std::string buffer;
+        return buffer;
+    }
+
+    // UTF-16 to UTF-8 conversion without QTextCodec
+    const std::string& toUtf8(const QString& word)
+    {
+        std::string& buffer = wordBuffer();
+        buffer.clear();
+        buffer.reserve(size_t(word.size()) * 3);
+
+        for (const ushort* p = word.utf16(), *end = p + word.size(); p != end; )
+        {
+            uint c = *p++;
+            if (c < 0x80)
+            {
+                buffer += char(c);
+            }
+            else if (c < 0x800)
+            {
+                buffer += char(0xc0 | (c >> 6));
+                buffer += char(0x80 | (c & 0x3f));
+            }
+            else if (QChar::isHighSurrogate(c) && p != end && QChar::isLowSurrogate(*p))
+            {
+                c = QChar::surrogateToUcs4(ushort(c), *p++);
+                buffer += char(0xf0 | (c >> 18));
+                buffer += char(0x80 | ((c >> 12) & 0x3f));
+                buffer += char(0x80 | ((c >> 6) & 0x3f));
+                buffer += char(0x80 | (c & 0x3f));
+            }
+            else
+            {
+                if (QChar::isSurrogate(c))
+                    c = QChar::ReplacementCharacter; // unpaired surrogate
+                buffer += char(0xe0 | (c >> 12));
+                buffer += char(0x80 | ((c >> 6) & 0x3f));
+                buffer += char(0x80 | (c & 0x3f));
+            }
+        }
+        return buffer;
+    }
+
+    bool isUrl(const QString& word)
+    {
+        return word.contains(QLatin1String("://")) ||
+               word.startsWith(QLatin1String("www."), Qt::CaseInsensitive) ||
+               (word.contains(QLatin1Char('@')) && word.contains(QLatin1Char('.')));
+    }
+
+    // numbers, codes with digits, all-caps abbreviations and URLs
+    // are accepted as they are, dictionaries don't know them anyway;
+    // words of scripts without case are always checked
+    bool skipSpelling(const QString& word)
+    {
+        bool letters = false;
+        bool lower = false;
+        bool upper = false;
+        for (const QChar ch : word)
+        {
+            const ushort u = ch.unicode();
+            if (u < 0x80)
+            {
+                if (u >= '0' && u <= '9')
+                    return true;
+                if (u >= 'a' && u <= 'z')
+                    letters = lower = true;
+                else if (u >= 'A' && u <= 'Z')
+                    letters = upper = true;
+            }
+            else if (ch.isDigit())
+            {
+                return true;
+            }
+            else if (ch.isLetter())
+            {
+                letters = true;
+                lower = lower || ch.isLower();
+                upper = upper || ch.isUpper() || ch.isTitleCase();
+            }
+        }
+        return !letters || (upper && !lower) || isUrl(word);
+    }
+}
+
 
 class HunspellBackendPrivate
 {
 public:
-    using UStringMap = std::unordered_map<QString, QString>;
     using HunspellUptr = std::unique_ptr<Hunspell>;
 
+    static constexpr qint64 kSweepInterval = 10000; // ms between checks for idle dictionaries
+
+    // instances of the dictionary of one language, every
+    // instance is used by a single thread at once
     struct Entry
     {
         QTextCodec* codec = nullptr;
-        HunspellUptr checker;
-
-        Entry() = default;
-        Entry(QTextCodec* codec, HunspellUptr&& speller)
-            : codec(codec)
-            , checker(std::move(speller))
-        {}
+        std::vector<HunspellUptr> idle; // instances not used at the moment
+        int instances = 0; // loaded instances, including used and being loaded ones
+        qint64 lastUsed = 0;
+        bool utf8 = false; // words are converted without the codec
+        bool available = true; // false if the dictionary isn't installed
     };
+
+    // dictionaries are loaded on the first use of the language
     std::unordered_map<QString, Entry> spellcheckers;
+    QSet<QString> appendedWords, removedWords; // replayed on every loaded dictionary
+    QMutex mutex; // the preloader fills dictionaries in the background
+    QWaitCondition released; // an instance is returned or loaded
+    int concurrency = 1; // threads using the backend at once
+    int maxInstances = 0; // instances per language, follows the concurrency if 0
+    bool updating = false; // words are applied to all instances
+
+    QElapsedTimer clock;
+    qint64 lastSweep = 0;
+    qint64 idleTimeout = 0; // ms, dictionaries are never unloaded if 0
+    QStringList preloadLanguages;
+    QScopedPointer<QThread> preloader;
+    QAtomicInt stopped;
+
+    HunspellBackendPrivate()
+    {
+        // defaults of the options, see HunspellBackend::setOption()
+#if (QT_VERSION < QT_VERSION_CHECK(5, 14, 0))
+        const auto skipEmptyParts = QString::SkipEmptyParts;
+#else
+        const auto skipEmptyParts = Qt::SkipEmptyParts;
+#endif
+        preloadLanguages = qEnvironmentVariable("QT5EXTRA_HUNSPELL_PRELOAD").split(QLatin1Char(','), skipEmptyParts);
+        idleTimeout = qint64(qEnvironmentVariableIntValue("QT5EXTRA_HUNSPELL_IDLE_TIMEOUT")) * 1000;
+        maxInstances = std::max(0, qEnvironmentVariableIntValue("QT5EXTRA_HUNSPELL_INSTANCES"));
+        clock.start();
+    }
+
+    ~HunspellBackendPrivate()
+    {
+        stopPreloader();
+    }
 
     static QString detectEncoding(const QString& affixFilePath)
     {
@@ -110,44 +259,270 @@ public:
         }
     }
 
-    void emplaceSpeller(const QString& language, const QString& dirPath)
+    static DictionaryIndex& installedDictionaries()
     {
-        if (language.isEmpty())
-            return;
+        DictionaryIndex& index = dictionaryIndex();
+
+        QMutexLocker locker(&index.mutex);
+        if (index.scanned)
+            return index;
+
+        QStringList searchDirs;
+
+        // add QStandardPaths
+        searchDirs.append(QStandardPaths::locateAll(QStandardPaths::GenericDataLocation, QLatin1String("hunspell"), QStandardPaths::LocateDirectory));
+        // add app resources
+        searchDirs.append(buildSubDirsList(qApp->applicationDirPath()));
+        // search additional user paths
+        searchDirs.append(buildSubDirsList(QLatin1String("/System/Library/Spelling")));
+        searchDirs.append(buildSubDirsList(QLatin1String("/usr/share/hunspell/")));
+        searchDirs.append(buildSubDirsList(QLatin1String("/usr/share/myspell/")));
+
+        detectInstalledLangs(searchDirs, index.paths, index.aliases);
+        index.scanned = true;
+        return index;
+    }
+
+    static bool locateDictionary(const QString& language, QString& name, QString& dirPath)
+    {
+        DictionaryIndex& index = installedDictionaries();
+
+        QMutexLocker locker(&index.mutex);
+        auto alias = index.aliases.find(language);
+        name = (alias != index.aliases.end()) ? alias->second : language;
+
+        auto it = index.paths.find(name);
+        if (it == index.paths.end())
+            return false;
 
-        const QString dictFilePath  = QDir(dirPath).absoluteFilePath(language + QLatin1String(".dic"));
-        const QString affixFilePath = QDir(dirPath).absoluteFilePath(language + QLatin1String(".aff"));
+        dirPath = it->second;
+        return true;
+    }
+
+    static HunspellUptr createSpeller(const QString& language, QTextCodec*& codec)
+    {
+        QString name, dirPath;
+        if (language.isEmpty() || !locateDictionary(language, name, dirPath))
+            return nullptr;
+
+        const QString dictFilePath  = QDir(dirPath).absoluteFilePath(name + QLatin1String(".dic"));
+        const QString affixFilePath = QDir(dirPath).absoluteFilePath(name + QLatin1String(".aff"));
 
         if (!QFileInfo::exists(dictFilePath) || !QFileInfo::exists(affixFilePath))
         {
             qWarning() << "Unable to load dictionary for" << language << "in path" << dirPath;
-            return;
+            return nullptr;
         }
 
         const QString encoding = detectEncoding(affixFilePath);
-        auto codec = QTextCodec::codecForName(encoding.toLatin1());
+        codec = QTextCodec::codecForName(encoding.toLatin1());
         auto speller = std::make_unique<Hunspell>(affixFilePath.toLocal8Bit().constData(),
                                                   dictFilePath.toLocal8Bit().constData());
 
         Q_ASSERT(speller != nullptr);
-        spellcheckers[language] = { codec, std::move(speller) };
+        return speller;
+    }
+
+    static void updateWord(const Entry& e, Hunspell& checker, const QString& word, bool append)
+    {
+        const std::string& w = encode(e, word);
+#if LIBHUNSPELL_VERSION > 150
+        if (append)
+            checker.add(w);
+        else
+            checker.remove(w);
+#else
+        if (append)
+            checker.add(w.c_str());
+        else
+            checker.remove(w.c_str());
+#endif
     }
 
-    void createSpellers(const UStringMap& languagePaths, const UStringMap& languageAliases)
+    static const std::string& encode(const Entry& e, const QString& word)
     {
-        spellcheckers.reserve(languagePaths.size());
+        if (e.utf8)
+            return toUtf8(word);
 
-        QString language;
-        for (const auto& [lang, path] : languagePaths)
+        const QByteArray bytes = e.codec->fromUnicode(word.data(), word.size());
+        std::string& buffer = wordBuffer();
+        buffer.assign(bytes.constData(), size_t(bytes.size()));
+        return buffer;
+    }
+
+    static QString decode(const Entry& e, const char* s, int n)
+    {
+        return e.utf8 ? QString::fromUtf8(s, n) : e.codec->toUnicode(s, n);
+    }
+
+    // must be called with the mutex locked, the instance
+    // must be already counted in the instances of the entry
+    void install(Entry& e, QTextCodec* codec, HunspellUptr&& checker)
+    {
+        if (!checker)
+        {
+            e.available = --e.instances > 0;
+            released.wakeAll();
+            return;
+        }
+
+        // instances of the same dictionary share the codec,
+        // it's set once, before the first instance is used
+        if (!e.codec)
+        {
+            e.codec = codec;
+            e.utf8 = codec && codec->mibEnum() == 106; // UTF-8
+        }
+        for (const auto& word : appendedWords)
+            updateWord(e, *checker, word, true);
+        for (const auto& word : removedWords)
+            updateWord(e, *checker, word, false);
+
+        e.idle.push_back(std::move(checker));
+        e.lastUsed = clock.elapsed();
+        released.wakeAll();
+    }
+
+    // must be called with the mutex locked, parsing takes long,
+    // so the mutex is unlocked while the dictionary is loaded
+    void loadInstance(Entry& e, const QString& language, QMutexLocker& locker)
+    {
+        ++e.instances;
+        locker.unlock();
+        QTextCodec* codec = nullptr;
+        HunspellUptr checker = createSpeller(language, codec);
+        locker.relock();
+        install(e, codec, std::move(checker));
+    }
+
+    // must be called with the mutex locked, takes an idle instance
+    // of the dictionary, loads a new one if all of them are in use
+    // and the limit isn't reached, otherwise waits for a free one
+    Hunspell* acquire(const QString& language, Entry*& entry, QMutexLocker& locker)
+    {
+        // entries aren't added while words are applied to them
+        while (updating)
+            released.wait(&mutex);
+
+        sweep();
+
+        Entry& e = spellcheckers[language];
+        Q_FOREVER
         {
-            auto it = languageAliases.find(language);
-            if (it != languageAliases.end())
-                language = it->second;
+            if (!updating && !e.idle.empty())
+            {
+                Hunspell* checker = e.idle.back().release();
+                e.idle.pop_back();
+                e.lastUsed = clock.elapsed();
+                entry = &e;
+                return checker;
+            }
+
+            if (!e.available)
+                return nullptr;
+
+            if (!updating && e.instances < instanceLimit())
+                loadInstance(e, language, locker);
             else
-                language = lang;
+                released.wait(&mutex);
+        }
+    }
+
+    // must be called with the mutex locked
+    int instanceLimit() const
+    {
+        return maxInstances > 0 ? maxInstances : concurrency;
+    }
+
+    void release(Entry& e, Hunspell* checker)
+    {
+        QMutexLocker locker(&mutex);
+        e.idle.emplace_back(checker);
+        released.wakeAll();
+    }
+
+    // must be called with the mutex locked, waits for instances
+    // in use, so the word is applied to all loaded instances
+    void applyWord(const QString& word, bool append)
+    {
+        while (updating)
+            released.wait(&mutex);
+
+        updating = true;
+        for (auto& [language, e] : spellcheckers)
+        {
+            while (static_cast<int>(e.idle.size()) < e.instances)
+                released.wait(&mutex);
+
+            for (auto& checker : e.idle)
+                updateWord(e, *checker, word, append);
+        }
+        updating = false;
+        released.wakeAll();
+    }
+
+    // must be called with the mutex locked
+    void sweep()
+    {
+        if (idleTimeout <= 0)
+            return;
+
+        const qint64 now = clock.elapsed();
+        if (now - lastSweep < std::min(kSweepInterval, idleTimeout))
+            return;
+
+        lastSweep = now;
+        for (auto& [language, e] : spellcheckers)
+        {
+            // dictionaries in use are kept loaded
+            if (e.instances > 0 && static_cast<int>(e.idle.size()) == e.instances && now - e.lastUsed > idleTimeout)
+            {
+                e.idle.clear(); // loaded again on the next use
+                e.instances = 0;
+            }
+        }
+    }
+
+    void preload(const QStringList& languages)
+    {
+        for (const QString& language : languages)
+        {
+            if (stopped.loadAcquire())
+                break;
+
+            QMutexLocker locker(&mutex);
+            while (updating)
+                released.wait(&mutex);
+
+            Entry& e = spellcheckers[language];
+            if (e.instances == 0 && e.available)
+                loadInstance(e, language, locker);
+        }
+    }
 
-            emplaceSpeller(language, path);
+    void startPreloader()
+    {
+        QStringList languages;
+        {
+            QMutexLocker locker(&mutex);
+            languages = preloadLanguages;
         }
+        if (languages.isEmpty() || preloader)
+            return;
+
+        stopped.storeRelease(0);
+        preloader.reset(QThread::create([this, languages]() { preload(languages); }));
+        preloader->start(QThread::LowPriority);
+    }
+
+    void stopPreloader()
+    {
+        if (!preloader)
+            return;
+
+        stopped.storeRelease(1);
+        preloader->wait();
+        preloader.reset();
     }
 };
 
@@ -160,47 +535,50 @@ HunspellBackend::~HunspellBackend() = default;
 
 bool HunspellBackend::load()
 {
-    QStringList searchDirs;
-
-    // add QStandardPaths
-    searchDirs.append(QStandardPaths::locateAll(QStandardPaths::GenericDataLocation, QLatin1String("hunspell"), QStandardPaths::LocateDirectory));
-    // add app resources
-    searchDirs.append(d->buildSubDirsList(qApp->applicationDirPath()));
-    // search additional user paths
-    searchDirs.append(d->buildSubDirsList(QLatin1String("/System/Library/Spelling")));
-    searchDirs.append(d->buildSubDirsList(QLatin1String("/usr/share/hunspell/")));
-    searchDirs.append(d->buildSubDirsList(QLatin1String("/usr/share/myspell/")));
-
-    HunspellBackendPrivate::UStringMap languagePaths, languageAliases;
-    d->detectInstalledLangs(searchDirs, languagePaths, languageAliases);
-    d->createSpellers(languagePaths, languageAliases);
+    d->installedDictionaries();
+    d->startPreloader();
     return true;
 }
 
 bool HunspellBackend::unload()
 {
+    d->stopPreloader();
+
+    QMutexLocker locker(&d->mutex);
     d->spellcheckers.clear(); // clear and release memory
     return true;
 }
 
 bool HunspellBackend::validate(const QString& word, const QStringList& langs) const
 {
-    if (langs.isEmpty())
+    if (langs.isEmpty() || skipSpelling(word))
         return true;
 
     for (const auto& tag : langs)
     {
-        auto it = d->spellcheckers.find(tag);
-        if (it == d->spellcheckers.end())
+        HunspellBackendPrivate::Entry* e = nullptr;
+        Hunspell* checker = nullptr;
+        {
+            QMutexLocker locker(&d->mutex);
+            checker = d->acquire(tag, e, locker);
+        }
+        if (!checker)
             continue;
 
-        const auto& e = it->second;
-        std::string w = e.codec->fromUnicode(word.data(), word.size()).toStdString();
+        // other threads check words with other instances meanwhile
+        const std::string& w = d->encode(*e, word);
+#if LIBHUNSPELL_VERSION > 150
+        const bool correct = checker->spell(w);
+#else
+        const bool correct = checker->spell(w.c_str());
+#endif
+        d->release(*e, checker);
+
 #if LIBHUNSPELL_VERSION > 150
-        if (!e.checker->spell(w))
+        if (!correct)
             return false;
 #else
-        if (e.checker->spell(w.data()))
+        if (correct)
             return true;
 #endif
     }
@@ -211,37 +589,43 @@ QStringList HunspellBackend::suggestions(const QString& word, int count, const Q
 {
     QSet<QString> stringSet;
     stringSet.reserve(count);
+
     for (const auto& tag : langs)
     {
-        auto it = d->spellcheckers.find(tag);
-        if (it == d->spellcheckers.end())
+        HunspellBackendPrivate::Entry* e = nullptr;
+        Hunspell* checker = nullptr;
+        {
+            QMutexLocker locker(&d->mutex);
+            checker = d->acquire(tag, e, locker);
+        }
+        if (!checker)
             continue;
 
-        const auto& e = it->second;
-        std::string w = e.codec->fromUnicode(word.data(), word.size()).toStdString();
+        const std::string& w = d->encode(*e, word);
 #if LIBHUNSPELL_VERSION > 150
-        const auto results = e.checker->suggest(w);
+        const auto results = checker->suggest(w);
         for (const auto& s : results)
         {
             if (s.size() > 0)
-                stringSet << e.codec_->toUnicode(s.data(), s.size());
+                stringSet << d->decode(*e, s.data(), int(s.size()));
             if (stringSet.size() >= count)
                 break;
         }
 #else
         char** results = nullptr;
-        int n = e.checker->suggest(&results, w.data());
+        int n = checker->suggest(&results, w.c_str());
         for (int i = 0; i < n; ++i)
         {
             const char* s = results[i];
             const int l = qstrnlen(s, 256);
             if (l > 0)
-                stringSet << e.codec->toUnicode(s, l);
+                stringSet << d->decode(*e, s, l);
             if (stringSet.size() >= count)
                 break;
         }
-        e.checker->free_list(&results, n);
+        checker->free_list(&results, n);
 #endif
+        d->release(*e, checker);
         if (stringSet.size() >= count)
             break;
     }
@@ -250,28 +634,18 @@ QStringList HunspellBackend::suggestions(const QString& word, int count, const Q
 
 void HunspellBackend::append(const QString& word)
 {
-    for (const auto& e : d->spellcheckers)
-    {
-#if LIBHUNSPELL_VERSION > 150
-        e.checker->add(e.second.codec->fromUnicode(word.data(), word.size()).toStdString());
-#else
-        const QByteArray ba = e.second.codec->fromUnicode(word.data(), word.size());
-        e.second.checker->add(ba.data());
-#endif
-    }
+    QMutexLocker locker(&d->mutex);
+    d->removedWords.remove(word);
+    d->appendedWords.insert(word);
+    d->applyWord(word, true);
 }
 
 void HunspellBackend::remove(const QString& word)
 {
-    for (const auto& e : d->spellcheckers)
-    {
-#if LIBHUNSPELL_VERSION > 150
-        e.checker->remove(e.second.codec->fromUnicode(word.data(), word.size()).toStdString());
-#else
-        const QByteArray ba = e.second.codec->fromUnicode(word.data(), word.size());
-        e.second.checker->remove(ba.data());
-#endif
-    }
+    QMutexLocker locker(&d->mutex);
+    d->appendedWords.remove(word);
+    d->removedWords.insert(word);
+    d->applyWord(word, false);
 }
 
 void HunspellBackend::ignore(const QString& _word)
@@ -281,13 +655,84 @@ void HunspellBackend::ignore(const QString& _word)
 
 QStringList HunspellBackend::supportedLanguages() const
 {
+    // installed dictionaries, whether they are loaded or not
+    DictionaryIndex& index = d->installedDictionaries();
+
+    QMutexLocker locker(&index.mutex);
     QStringList languages;
-    languages.reserve(d->spellcheckers.size());
-    for (const auto& e : d->spellcheckers)
+    languages.reserve(int(index.paths.size() + index.aliases.size()));
+    for (const auto& e : index.paths)
         languages << e.first;
+    for (const auto& e : index.aliases)
+    {
+        if (index.paths.count(e.second))
+            languages << e.first;
+    }
     return languages;
 }
 
+bool HunspellBackend::isThreadSafe() const
+{
+    return true;
+}
+
+void HunspellBackend::setPreloadLanguages(const QStringList& languages)
+{
+    QMutexLocker locker(&d->mutex);
+    d->preloadLanguages = languages;
+}
+
+QStringList HunspellBackend::preloadLanguages() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->preloadLanguages;
+}
+
+void HunspellBackend::setIdleTimeout(int seconds)
+{
+    QMutexLocker locker(&d->mutex);
+    d->idleTimeout = qint64(std::max(0, seconds)) * 1000;
+}
+
+int HunspellBackend::idleTimeout() const
+{
+    QMutexLocker locker(&d->mutex);
+    return int(d->idleTimeout / 1000);
+}
+
+void HunspellBackend::setMaxInstances(int count)
+{
+    QMutexLocker locker(&d->mutex);
+    d->maxInstances = std::max(0, count);
+    d->released.wakeAll();
+}
+
+int HunspellBackend::maxInstances() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->maxInstances;
+}
+
+bool HunspellBackend::setOption(const QString& name, const QVariant& value)
+{
+    if (name == QLatin1String("preloadLanguages"))
+        setPreloadLanguages(value.toStringList());
+    else if (name == QLatin1String("idleTimeout"))
+        setIdleTimeout(value.toInt());
+    else if (name == QLatin1String("maxInstances"))
+        setMaxInstances(value.toInt());
+    else
+        return false;
+    return true;
+}
+
+void HunspellBackend::setConcurrency(int threads)
+{
+    QMutexLocker locker(&d->mutex);
+    d->concurrency = std::max(1, threads);
+    d->released.wakeAll();
+}
+
 QList<QtSpellCheckBackend::SpellingProvider> HunspellBackend::providers() const
 {
     static QList<SpellingProvider> providerList{ { "Hunspell", "N/A", "Hunspell library" } };
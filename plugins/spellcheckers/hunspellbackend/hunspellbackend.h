@@ -2,6 +2,18 @@
 #include <QtSpellCheckBackend>
 #include <QScopedPointer>
 
+//
+// HunspellBackend loads dictionaries on the first use of the language.
+// Options (see QtSpellCheckEngine::setBackendOption()), their defaults
+// are taken from the environment variables in brackets:
+//  - "preloadLanguages": languages loaded ahead of use (QT5EXTRA_HUNSPELL_PRELOAD,
+//    comma separated)
+//  - "idleTimeout": seconds after which dictionaries not used are unloaded,
+//    never if 0 (QT5EXTRA_HUNSPELL_IDLE_TIMEOUT)
+//  - "maxInstances": copies of the dictionary loaded to check one language on
+//    several threads at once, by default as many as threads using the backend
+//    (QT5EXTRA_HUNSPELL_INSTANCES)
+//
 class HunspellBackend : public QtSpellCheckBackend
 {
     // QtSpellCheckBackend interface
@@ -17,6 +29,18 @@ public:
     void ignore(const QString& word) Q_DECL_OVERRIDE;
     QStringList supportedLanguages() const Q_DECL_OVERRIDE;
     QList<SpellingProvider> providers() const Q_DECL_OVERRIDE;
+    bool isThreadSafe() const Q_DECL_OVERRIDE;
+    void setConcurrency(int threads) Q_DECL_OVERRIDE;
+    bool setOption(const QString& name, const QVariant& value) Q_DECL_OVERRIDE;
+
+    void setPreloadLanguages(const QStringList& languages);
+    QStringList preloadLanguages() const;
+
+    void setIdleTimeout(int seconds);
+    int idleTimeout() const;
+
+    void setMaxInstances(int count);
+    int maxInstances() const;
 
 private:
     QScopedPointer<class HunspellBackendPrivate> d;
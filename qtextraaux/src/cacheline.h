@@ -10,6 +10,8 @@ namespace Qt5Extra
      * class. The main purpose of this class is to maintain the second layer of
      * CacheMap cache, i.e. store the different states and values together and
      * gives the availablity to insert, remove, update them by specified key.
+     * Modifying methods take the statistics policy of CacheMap, which is
+     * notified about inserted, replaced and evicted values of the line.
      * \tparam _Key type of secondary key (hint)
      * \tparam _Value type of stored value
      * \note this class is reenterant
@@ -33,13 +35,15 @@ namespace Qt5Extra
             : capacity_(n)
         {}
 
-        template<class... _Args>
-        void emplace(const _Key& key, _Args&&... args)
+        template<class _Stats, class... _Args>
+        void emplace(_Stats& stats, const _Key& key, _Args&&... args)
         {
             auto it = search(key);
             if (it != storage_.end())
             {
+                stats.updating(it->second);
                 *it = { key, mapped_type(std::forward<_Args>(args)...) };
+                stats.updated(it->second);
                 return;
             }
 
@@ -47,15 +51,22 @@ namespace Qt5Extra
 
             // shrink
             if (capacity_ > 0 && storage_.size() > capacity_)
+            {
+                stats.evicted(storage_.back().second);
                 storage_.pop_back();
+            }
+
+            stats.inserted(storage_.front().second);
         }
 
-        size_t erase(const _Key& key)
+        template<class _Stats>
+        size_t erase(_Stats& stats, const _Key& key)
         {
             auto it = search(key);
             if (it == storage_.end())
                 return 0;
 
+            stats.erased(it->second);
             std::swap(*it, storage_.back());
             it = --storage_.end();
             storage_.erase(it);
@@ -63,10 +74,14 @@ namespace Qt5Extra
             return 1;
         }
 
-        void resize(size_t n)
+        template<class _Stats>
+        void resize(_Stats& stats, size_t n)
         {
-            while (storage_.size() > n)
+            while (n > 0 && storage_.size() > n)
+            {
+                stats.evicted(storage_.back().second);
                 storage_.pop_back();
+            }
 
             capacity_ = n;
         }
@@ -111,6 +126,9 @@ namespace Qt5Extra
 
         bool empty() const noexcept { return storage_.empty(); }
 
+        auto begin() const noexcept { return storage_.cbegin(); }
+        auto end() const noexcept { return storage_.cend(); }
+
     private:
         auto search(const _Key& k) const noexcept
         {
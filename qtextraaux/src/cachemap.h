@@ -10,18 +10,54 @@ namespace Qt5Extra
      * \tparam _Key type of primary part of the key
      * \tparam _Hint type of variable part of the key
      * \tparam _Value type of stored object
+     * \tparam _Stats type of statistics policy (defaulted to NoCacheStats,
+     * that collects nothing), counters are kept per stored object
      *
      * \note this class is reenterant
      */
     template<
         class _Key,
         class _Hint,
-        class _Value
+        class _Value,
+        class _Stats = NoCacheStats
     >
     class CacheMap
     {
         using cache_line = CacheLine<_Hint, _Value>;
-        using lookup_type = LRUCache<_Key, cache_line>;
+
+        // translates the events of primary cache into the events of objects
+        // the lines hold, lookups are counted by the cache map itself
+        struct line_stats : _Stats
+        {
+            void hit() const noexcept {}
+            void miss() const noexcept {}
+
+            void inserted(const cache_line& line)
+            {
+                if constexpr (_Stats::enabled)
+                    for (const auto& e : line)
+                        _Stats::inserted(e.second);
+            }
+
+            void evicted(const cache_line& line)
+            {
+                if constexpr (_Stats::enabled)
+                    for (const auto& e : line)
+                        _Stats::evicted(e.second);
+            }
+
+            void erased(const cache_line& line)
+            {
+                if constexpr (_Stats::enabled)
+                    for (const auto& e : line)
+                        _Stats::erased(e.second);
+            }
+        };
+
+        using lookup_type = LRUCache<
+            _Key, cache_line, std::hash<_Key>, std::equal_to<_Key>,
+            std::allocator<std::pair<const _Key, cache_line>>, line_stats
+        >;
 
     public:
         using key_type = _Key;
@@ -70,10 +106,14 @@ namespace Qt5Extra
         bool find(const key_type& key, const hint_type& hint, value_type& result) const
         {
             auto it = cache_.find(key);
-            if (it == cache_.end())
+            if (it == cache_.end() || !it->second.find(hint, result))
+            {
+                stats().miss();
                 return false;
+            }
 
-            return it->second.find(hint, result);
+            stats().hit();
+            return true;
         }
 
         /*!
@@ -96,10 +136,14 @@ namespace Qt5Extra
         bool find_if(_Pred pred, const key_type& key, value_type& result) const
         {
             auto it = cache_.find(key);
-            if (it == cache_.end())
+            if (it == cache_.end() || !it->second.find_if(pred, result))
+            {
+                stats().miss();
                 return false;
+            }
 
-            return it->second.find_if(pred, result);
+            stats().hit();
+            return true;
         }
 
         /*!
@@ -112,7 +156,7 @@ namespace Qt5Extra
         void insert(const key_type& key, const hint_type& hint, const value_type& value)
         {
             auto result = cache_.emplace(key, cache_line{ depth_ });
-            result.first->second.emplace(hint, value);
+            result.first->second.emplace(stats(), hint, value);
         }
 
         /*!
@@ -125,7 +169,7 @@ namespace Qt5Extra
         void insert(const key_type& key, const hint_type& hint, value_type&& value)
         {
             auto result = cache_.emplace(key, cache_line{ depth_ });
-            result.first->second.emplace(hint, std::forward<value_type>(value));
+            result.first->second.emplace(stats(), hint, std::forward<value_type>(value));
         }
 
         /*!
@@ -139,7 +183,7 @@ namespace Qt5Extra
         void emplace(const key_type& key, const hint_type& hint, _Args&&... args)
         {
             auto result = cache_.emplace(key, cache_line{ depth_ });
-            result.first->second.emplace(hint, std::forward<_Args>(args)...);
+            result.first->second.emplace(stats(), hint, std::forward<_Args>(args)...);
         }
 
         /*!
@@ -165,7 +209,7 @@ namespace Qt5Extra
             if (it == cache_.end())
                 return 0;
 
-            const size_t n = it->second.erase(hint);
+            const size_t n = it->second.erase(stats(), hint);
             if (it->second.empty())
                 cache_.erase(it);
             return n;
@@ -215,7 +259,7 @@ namespace Qt5Extra
         {
             depth_ = n;
             for (auto& s : cache_)
-                s.resize(n);
+                s.second.resize(stats(), n);
         }
 
         /*!
@@ -289,6 +333,29 @@ namespace Qt5Extra
             return cache_.count(key) > 0;
         }
 
+        /*!
+         * \brief Get the counters collected by statistics policy.
+         *
+         * \return cache statistics, all zeros if policy collects nothing
+         */
+        CacheStatistics statistics() const noexcept
+        {
+            return cache_.statistics();
+        }
+
+        /*!
+         * \brief Reset the counters of statistics policy,
+         * except the current occupancy of the cache.
+         */
+        void resetStatistics() noexcept
+        {
+            cache_.reset_statistics();
+        }
+
+    private:
+        _Stats& stats() noexcept { return cache_.stats(); }
+        const _Stats& stats() const noexcept { return cache_.stats(); }
+
     private:
         lookup_type cache_;
         size_t depth_ = 0;
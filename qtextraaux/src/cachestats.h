@@ -0,0 +1,173 @@
+#pragma once
+#include <cstddef>
+#include <algorithm>
+
+namespace Qt5Extra
+{
+    /*!
+     * \brief The CacheStatistics struct holds the counters
+     * collected by the CacheStats<> policy.
+     */
+    struct CacheStatistics
+    {
+        size_t hits = 0;      // lookups that found the entity
+        size_t misses = 0;    // lookups that found nothing
+        size_t inserts = 0;   // entities inserted
+        size_t evictions = 0; // entities evicted due to the capacity limit
+        size_t size = 0;      // current number of entities
+        size_t peakSize = 0;  // maximal number of entities ever cached
+        size_t bytes = 0;     // current weight of entities
+        size_t peakBytes = 0; // maximal weight of entities ever cached
+
+        /*!
+         * \brief hitRate return the ratio of hits to all lookups
+         * \return hit rate in range [0, 1], 0 if there were no lookups
+         */
+        double hitRate() const noexcept
+        {
+            const size_t lookups = hits + misses;
+            return lookups > 0 ? double(hits) / double(lookups) : 0.0;
+        }
+    };
+
+    /*!
+     * \brief The NoCacheStats class is the default statistics policy
+     * of LRUCache<> and CacheMap<> classes, which collects nothing.
+     * \detail All hooks are empty, so they are optimized out completely
+     * and the policy takes no storage as it's an empty base class.
+     */
+    struct NoCacheStats
+    {
+        static constexpr bool enabled = false;
+
+        void hit() const noexcept {}
+        void miss() const noexcept {}
+
+        template<class _Value>
+        void inserted(const _Value&) noexcept {}
+
+        template<class _Value>
+        void evicted(const _Value&) noexcept {}
+
+        template<class _Value>
+        void erased(const _Value&) noexcept {}
+
+        template<class _Value>
+        void updating(const _Value&) noexcept {}
+
+        template<class _Value>
+        void updated(const _Value&) noexcept {}
+
+        void cleared() noexcept {}
+
+        void reset() noexcept {}
+
+        CacheStatistics statistics() const noexcept { return {}; }
+    };
+
+    /*!
+     * \brief The NoWeigher class is the default weigher of CacheStats<>
+     * policy, the weight of entities (bytes) isn't counted.
+     */
+    struct NoWeigher
+    {
+        template<class _Value>
+        size_t operator()(const _Value&) const noexcept { return 0; }
+    };
+
+    /*!
+     * \brief The CacheStats<> class is the statistics policy of
+     * LRUCache<> and CacheMap<> classes, which counts hits, misses,
+     * inserts and evictions and tracks the occupancy of the cache.
+     *
+     * \detail Only find() is counted as a lookup, count() and contains()
+     * are not, so probing the cache doesn't skew the hit rate. The weight
+     * of entity is taken when it's inserted and removed, so the value
+     * modified in-place must be replaced with assign() to be reweighed.
+     *
+     * \tparam _Weigher type of unary functor returning the weight
+     * (e.g. number of bytes) of the cached value
+     */
+    template<class _Weigher = NoWeigher>
+    class CacheStats : private _Weigher
+    {
+    public:
+        static constexpr bool enabled = true;
+
+        CacheStats() = default;
+
+        explicit CacheStats(const _Weigher& weigher)
+            : _Weigher(weigher)
+        {}
+
+        void hit() const noexcept { ++counters.hits; }
+        void miss() const noexcept { ++counters.misses; }
+
+        template<class _Value>
+        void inserted(const _Value& value)
+        {
+            ++counters.inserts;
+            ++counters.size;
+            counters.peakSize = std::max(counters.peakSize, counters.size);
+            acquire(value);
+        }
+
+        template<class _Value>
+        void evicted(const _Value& value)
+        {
+            ++counters.evictions;
+            erased(value);
+        }
+
+        template<class _Value>
+        void erased(const _Value& value)
+        {
+            --counters.size;
+            release(value);
+        }
+
+        template<class _Value>
+        void updating(const _Value& value) { release(value); }
+
+        template<class _Value>
+        void updated(const _Value& value) { acquire(value); }
+
+        void cleared() noexcept
+        {
+            counters.size = 0;
+            counters.bytes = 0;
+        }
+
+        /*!
+         * \brief reset reset counters, except the current occupancy
+         */
+        void reset() noexcept
+        {
+            const size_t size = counters.size;
+            const size_t bytes = counters.bytes;
+            counters = CacheStatistics{};
+            counters.size = counters.peakSize = size;
+            counters.bytes = counters.peakBytes = bytes;
+        }
+
+        const CacheStatistics& statistics() const noexcept { return counters; }
+
+    private:
+        template<class _Value>
+        void acquire(const _Value& value)
+        {
+            counters.bytes += _Weigher::operator()(value);
+            counters.peakBytes = std::max(counters.peakBytes, counters.bytes);
+        }
+
+        template<class _Value>
+        void release(const _Value& value)
+        {
+            const size_t weight = _Weigher::operator()(value);
+            counters.bytes -= std::min(weight, counters.bytes);
+        }
+
+    private:
+        mutable CacheStatistics counters;
+    };
+} // end namespace Qt5Extra
@@ -1,4 +1,5 @@
 #pragma once
+#include <QMetaType>
 
 struct IndexRange
 {
@@ -54,3 +55,6 @@ struct IndexRange
         return !(*this == other);
     }
 };
+
+Q_DECLARE_TYPEINFO(IndexRange, Q_MOVABLE_TYPE);
+Q_DECLARE_METATYPE(IndexRange)
@@ -0,0 +1,398 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Qt5Extra
+{
+    /*!
+     * \brief The IndexSet class provide the ordered set of
+     * indices with order statistics.
+     *
+     * \details Besides logarithmic insertion, removal and
+     * lookup, IndexSet allows to find the index by its position
+     * (and vice versa) and to shift all indices starting from the
+     * given one. This makes it suitable to keep a subset of model
+     * rows in sync with insertion and removal of the model rows
+     * without touching every subsequent row.
+     * Implemented as a treap with lazily propagated shifts, where
+     * all nodes are allocated from the single pool.
+     */
+    class IndexSet
+    {
+        static constexpr int nil = -1;
+
+        struct Node
+        {
+            int key;
+            int shift; // pending shift of the whole subtree
+            int left;
+            int right;
+            int size;
+            uint32_t priority;
+        };
+
+    public:
+        static constexpr int npos = -1;
+
+        IndexSet() = default;
+        IndexSet(const IndexSet&) = default;
+        IndexSet& operator=(const IndexSet&) = default;
+
+        IndexSet(IndexSet&& other) noexcept
+            : nodes(std::move(other.nodes))
+            , freeNodes(std::move(other.freeNodes))
+            , root(std::exchange(other.root, nil))
+            , seed(other.seed)
+        {}
+
+        IndexSet& operator=(IndexSet&& other) noexcept
+        {
+            nodes = std::move(other.nodes);
+            freeNodes = std::move(other.freeNodes);
+            root = std::exchange(other.root, nil);
+            seed = other.seed;
+            return *this;
+        }
+
+        template<class _It>
+        IndexSet(_It first, _It last)
+        {
+            assign(first, last);
+        }
+
+        inline int size() const noexcept
+        {
+            return sizeOf(root);
+        }
+
+        inline bool empty() const noexcept
+        {
+            return root == nil;
+        }
+
+        void clear()
+        {
+            nodes.clear();
+            freeNodes.clear();
+            root = nil;
+        }
+
+        /*!
+         * \brief assign replace content of the set with
+         * sorted range of unique indices in linear time
+         */
+        template<class _It>
+        void assign(_It first, _It last)
+        {
+            clear();
+            // build the treap along its right spine
+            std::vector<int> spine;
+            for (; first != last; ++first)
+            {
+                const int n = allocate(*first);
+                int child = nil;
+                while (!spine.empty() && nodes[spine.back()].priority < nodes[n].priority)
+                {
+                    child = spine.back();
+                    spine.pop_back();
+                }
+                nodes[n].left = child;
+                if (!spine.empty())
+                    nodes[spine.back()].right = n;
+                spine.push_back(n);
+            }
+            root = spine.empty() ? nil : spine.front();
+            updateSizes(root);
+        }
+
+        /*!
+         * \brief at return index at position pos
+         */
+        int at(int pos) const
+        {
+            int acc = 0;
+            for (int t = root; t != nil; )
+            {
+                const Node& node = nodes[t];
+                acc += node.shift;
+                const int n = sizeOf(node.left);
+                if (pos < n)
+                {
+                    t = node.left;
+                }
+                else if (pos == n)
+                {
+                    return node.key + acc;
+                }
+                else
+                {
+                    pos -= n + 1;
+                    t = node.right;
+                }
+            }
+            return npos;
+        }
+
+        /*!
+         * \brief lowerBound return number of indices less than key
+         */
+        int lowerBound(int key) const
+        {
+            int acc = 0;
+            int count = 0;
+            for (int t = root; t != nil; )
+            {
+                const Node& node = nodes[t];
+                acc += node.shift;
+                if (node.key + acc < key)
+                {
+                    count += sizeOf(node.left) + 1;
+                    t = node.right;
+                }
+                else
+                {
+                    t = node.left;
+                }
+            }
+            return count;
+        }
+
+        /*!
+         * \brief indexOf return position of index key
+         * or npos if key is not in the set
+         */
+        int indexOf(int key) const
+        {
+            int acc = 0;
+            int count = 0;
+            for (int t = root; t != nil; )
+            {
+                const Node& node = nodes[t];
+                acc += node.shift;
+                const int k = node.key + acc;
+                if (k == key)
+                    return count + sizeOf(node.left);
+
+                if (k < key)
+                {
+                    count += sizeOf(node.left) + 1;
+                    t = node.right;
+                }
+                else
+                {
+                    t = node.left;
+                }
+            }
+            return npos;
+        }
+
+        inline bool contains(int key) const
+        {
+            return indexOf(key) != npos;
+        }
+
+        /*!
+         * \brief insert insert index key
+         * \return position of the key and flag
+         * indicating whether key was inserted
+         */
+        std::pair<int, bool> insert(int key)
+        {
+            const int pos = lowerBound(key);
+            if (pos < size() && at(pos) == key)
+                return { pos, false };
+
+            int l, r;
+            split(root, key, l, r);
+            root = merge(merge(l, allocate(key)), r);
+            return { pos, true };
+        }
+
+        /*!
+         * \brief erase remove index key
+         * \return position of removed key or npos
+         */
+        int erase(int key)
+        {
+            const int pos = indexOf(key);
+            if (pos != npos)
+                erase(key, key + 1);
+            return pos;
+        }
+
+        /*!
+         * \brief erase remove all indices in range [first, last)
+         * \return number of removed indices
+         */
+        int erase(int first, int last)
+        {
+            if (first >= last)
+                return 0;
+
+            int l, m, r;
+            split(root, first, l, m);
+            split(m, last, m, r);
+            const int count = sizeOf(m);
+            release(m);
+            root = merge(l, r);
+            return count;
+        }
+
+        /*!
+         * \brief shift add delta to all indices greater or equal
+         * to from; shifted indices must not collide with others
+         */
+        void shift(int from, int delta)
+        {
+            if (delta == 0)
+                return;
+
+            int l, r;
+            split(root, from, l, r);
+            if (r != nil)
+                nodes[r].shift += delta;
+            root = merge(l, r);
+        }
+
+        /*!
+         * \brief forEach call fn for every index in ascending order
+         */
+        template<class _Fn>
+        void forEach(_Fn&& fn) const
+        {
+            visit(root, 0, fn);
+        }
+
+        std::vector<int> toVector() const
+        {
+            std::vector<int> result;
+            result.reserve(size());
+            forEach([&result](int key) { result.push_back(key); });
+            return result;
+        }
+
+    private:
+        inline int sizeOf(int t) const noexcept
+        {
+            return t == nil ? 0 : nodes[t].size;
+        }
+
+        int allocate(int key)
+        {
+            // xorshift is enough for treap priorities
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+
+            const Node node = { key, 0, nil, nil, 1, seed };
+            if (freeNodes.empty())
+            {
+                nodes.push_back(node);
+                return static_cast<int>(nodes.size() - 1);
+            }
+            const int t = freeNodes.back();
+            freeNodes.pop_back();
+            nodes[t] = node;
+            return t;
+        }
+
+        void release(int t)
+        {
+            if (t == nil)
+                return;
+            release(nodes[t].left);
+            release(nodes[t].right);
+            freeNodes.push_back(t);
+        }
+
+        int updateSizes(int t)
+        {
+            if (t == nil)
+                return 0;
+            nodes[t].size = updateSizes(nodes[t].left) + updateSizes(nodes[t].right) + 1;
+            return nodes[t].size;
+        }
+
+        inline void update(int t) noexcept
+        {
+            nodes[t].size = sizeOf(nodes[t].left) + sizeOf(nodes[t].right) + 1;
+        }
+
+        inline void push(int t) noexcept
+        {
+            Node& node = nodes[t];
+            if (node.shift == 0)
+                return;
+            node.key += node.shift;
+            if (node.left != nil)
+                nodes[node.left].shift += node.shift;
+            if (node.right != nil)
+                nodes[node.right].shift += node.shift;
+            node.shift = 0;
+        }
+
+        // split t into indices less than key and the rest
+        void split(int t, int key, int& l, int& r)
+        {
+            if (t == nil)
+            {
+                l = r = nil;
+                return;
+            }
+
+            push(t);
+            if (nodes[t].key < key)
+            {
+                split(nodes[t].right, key, nodes[t].right, r);
+                l = t;
+            }
+            else
+            {
+                split(nodes[t].left, key, l, nodes[t].left);
+                r = t;
+            }
+            update(t);
+        }
+
+        int merge(int l, int r)
+        {
+            if (l == nil)
+                return r;
+            if (r == nil)
+                return l;
+
+            if (nodes[l].priority > nodes[r].priority)
+            {
+                push(l);
+                nodes[l].right = merge(nodes[l].right, r);
+                update(l);
+                return l;
+            }
+            else
+            {
+                push(r);
+                nodes[r].left = merge(l, nodes[r].left);
+                update(r);
+                return r;
+            }
+        }
+
+        template<class _Fn>
+        void visit(int t, int acc, _Fn& fn) const
+        {
+            if (t == nil)
+                return;
+            acc += nodes[t].shift;
+            visit(nodes[t].left, acc, fn);
+            fn(nodes[t].key + acc);
+            visit(nodes[t].right, acc, fn);
+        }
+
+    private:
+        std::vector<Node> nodes;
+        std::vector<int> freeNodes;
+        int root = nil;
+        uint32_t seed = 2463534242u;
+    };
+}
@@ -2,6 +2,8 @@
 #include <unordered_map>
 #include <list>
 
+#include "cachestats.h"
+
 namespace Qt5Extra
 {
     /*!
@@ -13,6 +15,7 @@ namespace Qt5Extra
      * \tparam _Hasher type of key hasher (defaulted to std::hash<_Key>)
      * \tparam _KeyEq type of key equality comparator (defaulted to std::equal_to<_Key>)
      * \tparam _Alloc type of memory allocator (defaulted to std::allocator<std::pair<const _Key, _Value>>)
+     * \tparam _Stats type of statistics policy (defaulted to NoCacheStats, that collects nothing)
      *
      */
     template<
@@ -20,9 +23,10 @@ namespace Qt5Extra
         class _Value,
         class _Hasher = std::hash<_Key>,
         class _KeyEq = std::equal_to<_Key>,
-        class _Alloc = std::allocator<std::pair<const _Key, _Value>>
+        class _Alloc = std::allocator<std::pair<const _Key, _Value>>,
+        class _Stats = NoCacheStats
     >
-    class LRUCache
+    class LRUCache : private _Stats // policy is usually empty
     {
     public:
         using key_type = _Key;
@@ -30,6 +34,7 @@ namespace Qt5Extra
         using value_type = std::pair<const key_type, mapped_type>;
         using key_equal = _KeyEq;
         using hasher = _Hasher;
+        using stats_policy = _Stats;
 
         using node_list = std::list<value_type, _Alloc>;
 
@@ -113,6 +118,16 @@ namespace Qt5Extra
                 evict();
         }
 
+        // evicts least recently used entities, so one more fits in
+        void makeRoom()
+        {
+            if (limit == kUnlimited)
+                return;
+
+            while(!list.empty() && list.size() >= limit)
+                evict();
+        }
+
         /*!
          * \brief operator [] index operator overload
          * \param key
@@ -126,12 +141,17 @@ namespace Qt5Extra
         {
             auto it = lookup.find(key_pointer(key));
             if (it != lookup.end())
+            {
+                _Stats::hit();
                 return it->second->second;
+            }
 
-            shrink(); // evict last used element on overflow
+            _Stats::miss();
+            makeRoom(); // evict last used element on overflow
 
             auto nodeIt = list.emplace(list.begin(), key, mapped_type{});
             lookup[key_pointer(nodeIt->first)] = nodeIt;
+            _Stats::inserted(nodeIt->second);
             return nodeIt->second;
         }
 
@@ -146,18 +166,39 @@ namespace Qt5Extra
         template<class... _Args>
         std::pair<iterator, bool> emplace(_Args&&... args)
         {
-            value_type val(std::forward<_Args>(args)...);
-            auto it = lookup.find(key_pointer(val.first));
+            // construct the node only once aside: arguments may be moved-from
+            // after that, and the node is spliced in without reallocation
+            node_list node(list.get_allocator());
+            auto nodeIt = node.emplace(node.begin(), std::forward<_Args>(args)...);
+            auto it = lookup.find(key_pointer(nodeIt->first));
             if (it != lookup.end())
                 return { it->second, false };
 
-            shrink(); // evict last used element on overflow
-
-            auto nodeIt = list.emplace(list.begin(), std::forward<_Args>(args)...);
+            makeRoom(); // evict last used element on overflow
+            list.splice(list.begin(), node, nodeIt);
             lookup[key_pointer(nodeIt->first)] = nodeIt;
+            _Stats::inserted(nodeIt->second);
             return { nodeIt, true };
         }
 
+        /*!
+         * \brief assign replace the value of entity pointed by iterator
+         * and move the entity to front
+         * \param it iterator pointing to interesting entity
+         * \param value new value of entity
+         * \return result iterator pointing to same element
+         * \note unlike the assignment through iterator, the replaced
+         * value is reweighed by statistics policy
+         */
+        template<class _Arg>
+        iterator assign(iterator it, _Arg&& value)
+        {
+            _Stats::updating(it->second);
+            it->second = std::forward<_Arg>(value);
+            _Stats::updated(it->second);
+            return move_font(it);
+        }
+
         /*!
          * \brief move_font move entity with specified key to front
          * if it's found in cache
@@ -200,6 +241,7 @@ namespace Qt5Extra
             if (it != lookup.end())
             {
                 auto nodeIt = it->second;
+                _Stats::erased(nodeIt->second);
                 lookup.erase(it);
                 list.erase(nodeIt);
                 return 1;
@@ -214,6 +256,7 @@ namespace Qt5Extra
          */
         iterator erase(iterator it)
         {
+            _Stats::erased(it->second);
             lookup.erase(key_pointer(it->first));
             return list.erase(it);
         }
@@ -225,6 +268,20 @@ namespace Qt5Extra
         {
             lookup.clear();
             list.clear();
+            _Stats::cleared();
+        }
+
+        /*!
+         * \brief evict evict least recently used entity from cache
+         */
+        void evict()
+        {
+            if (list.empty())
+                return;
+
+            _Stats::evicted(list.back().second);
+            lookup.erase(key_pointer(list.back().first));
+            list.pop_back();
         }
 
         /*!
@@ -256,6 +313,7 @@ namespace Qt5Extra
          * \brief count return  number of entities in cache with specified key
          * \param key key to find
          * \return number of entities that matches the key
+         * \note unlike find() it isn't counted as a lookup by statistics policy
          */
         size_t count(const key_type& key) const noexcept { return lookup.count(key_pointer(key)); }
 
@@ -275,7 +333,14 @@ namespace Qt5Extra
         const_iterator find(const key_type& key) const
         {
             auto it = lookup.find(key_pointer(key));
-            return it != lookup.end() ? const_iterator{ it->second } : list.end();
+            if (it == lookup.end())
+            {
+                _Stats::miss();
+                return list.end();
+            }
+
+            _Stats::hit();
+            return it->second;
         }
 
         /*!
@@ -287,7 +352,14 @@ namespace Qt5Extra
         iterator find(const key_type& key)
         {
             auto it = lookup.find(key_pointer(key));
-            return it != lookup.end() ? it->second : list.end();
+            if (it == lookup.end())
+            {
+                _Stats::miss();
+                return list.end();
+            }
+
+            _Stats::hit();
+            return it->second;
         }
 
         /*!
@@ -323,19 +395,31 @@ namespace Qt5Extra
         const_iterator cbegin() const { return list.begin(); }
         const_iterator cend() const { return list.end(); }
 
-    private:
         /*!
-         * \brief evict evict last used element from cache
+         * \brief statistics return counters collected by statistics policy
+         * \return cache statistics, all zeros if policy collects nothing
          */
-        void evict()
-        {
-            if (list.empty())
-                return;
+        CacheStatistics statistics() const noexcept { return _Stats::statistics(); }
 
-            lookup.erase(key_pointer(list.back().first));
-            list.pop_back();
-        }
+        /*!
+         * \brief reset_statistics reset counters of statistics policy,
+         * except the current occupancy of the cache
+         */
+        void reset_statistics() noexcept { _Stats::reset(); }
 
+        /*!
+         * \brief stats return statistics policy
+         * \return constant reference to statistics policy
+         */
+        const stats_policy& stats() const noexcept { return *this; }
+
+        /*!
+         * \brief stats return statistics policy
+         * \return mutable reference to statistics policy
+         */
+        stats_policy& stats() noexcept { return *this; }
+
+    private:
         /*!
          * \brief key_pointer return non-const pointer to key
          * \param k reference to key
@@ -9,10 +9,13 @@
 #include <QInputMethodEvent>
 #include <QCoreApplication>
 
+#include <algorithm>
+
 class QtMisspellHighlighterPrivate
 {
 public:
     QTextCharFormat format;
+    QList<QTextEdit::ExtraSelection> selections; // cursors follow edits of the document
     QtSpellChecker* checker = nullptr;
     bool enabled = true;
 
@@ -27,10 +30,8 @@ public:
 #endif
     }
 
-    void formatRanges(QtTextControl& widget, const IndexRange* ranges, int n)
+    void appendRanges(QTextDocument* document, const IndexRange* ranges, int n)
     {
-        QList<QTextEdit::ExtraSelection> extra;
-        QTextDocument* document = widget.document();
         for (auto r = ranges, end = ranges + n; r != end; ++r)
         {
             QTextEdit::ExtraSelection selection;
@@ -39,9 +40,33 @@ public:
             cursor.movePosition(QTextCursor::NextCharacter, QTextCursor::KeepAnchor, r->length);
             selection.cursor = cursor;
             selection.format = format;
-            extra << selection;
+            selections << selection;
         }
-        widget.setExtraSelections(extra);
+    }
+
+    void formatRanges(QtTextControl& widget, const IndexRange* ranges, int n)
+    {
+        selections.clear();
+        appendRanges(widget.document(), ranges, n);
+        widget.setExtraSelections(selections);
+    }
+
+    void updateRanges(QtTextControl& widget, const IndexRange& range, const IndexRange* ranges, int n)
+    {
+        QTextDocument* document = widget.document();
+        const int last = range.offset + range.length;
+
+        // selections of removed words collapse, they are dropped as well
+        auto outdated = [&](const QTextEdit::ExtraSelection& s)
+        {
+            const QTextCursor& c = s.cursor;
+            return c.document() != document || !c.hasSelection() ||
+                   (c.selectionStart() < last && c.selectionEnd() > range.offset);
+        };
+        selections.erase(std::remove_if(selections.begin(), selections.end(), outdated), selections.end());
+
+        appendRanges(document, ranges, n);
+        widget.setExtraSelections(selections);
     }
 
     void sendEvent(QWidget* target, int cursorPos, const IndexRange* ranges, int n)
@@ -91,6 +116,9 @@ void QtMisspellHighlighter::setFormat(const QTextCharFormat& format)
         return;
 
     d->format = format;
+    for (auto& selection : d->selections)
+        selection.format = format;
+
     Q_EMIT formatChanged();
 }
 
@@ -110,6 +138,18 @@ void QtMisspellHighlighter::reset()
         d->sendEvent(target, -1, nullptr, 0);
 }
 
+void QtMisspellHighlighter::update(const IndexRange& range, const IndexRange* ranges, int size)
+{
+    auto& target = d->checker->target();
+    if (!target || !isEnabled())
+        return;
+
+    if (target.document())
+        d->updateRanges(target, range, ranges, size);
+    else
+        highlight(ranges, size); // input method formats are replaced at once
+}
+
 void QtMisspellHighlighter::highlight(const IndexRange* ranges, int size)
 {
     auto& target = d->checker->target();
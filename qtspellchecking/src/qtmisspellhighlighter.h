@@ -27,6 +27,9 @@ public:
     virtual void reset();
     virtual void highlight(const IndexRange* ranges, int size);
 
+    // replaces highlighting of the range only, the rest is kept as is
+    virtual void update(const IndexRange& range, const IndexRange* ranges, int size);
+
 Q_SIGNALS:
     void formatChanged();
     void enabledChanged(bool);
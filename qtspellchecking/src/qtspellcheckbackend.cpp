@@ -47,3 +47,17 @@ QList<QtSpellCheckBackend::SpellingProvider> QtSpellCheckBackend::providers() co
     return {};
 }
 
+bool QtSpellCheckBackend::isThreadSafe() const
+{
+    return false;
+}
+
+void QtSpellCheckBackend::setConcurrency(int)
+{
+}
+
+bool QtSpellCheckBackend::setOption(const QString&, const QVariant&)
+{
+    return false;
+}
+
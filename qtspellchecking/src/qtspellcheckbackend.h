@@ -1,6 +1,7 @@
 #pragma once
 #include <QSet>
 #include <QString>
+#include <QVariant>
 
 #include <QtSpellChecking>
 
@@ -26,5 +27,17 @@ public:
     virtual bool contains(const QString&) const;
     virtual QStringList supportedLanguages() const;
     virtual QList<SpellingProvider> providers() const;
+
+    // thread-safe backend may be used by several threads at once, so
+    // QtSpellCheckEngine shares a single instance between its workers
+    virtual bool isThreadSafe() const;
+
+    // number of threads using the thread-safe backend at once,
+    // QtSpellCheckEngine sets it to the number of its workers
+    virtual void setConcurrency(int threads);
+
+    // backend specific option, returns false if the option isn't supported;
+    // QtSpellCheckEngine applies options set with setBackendOption()
+    virtual bool setOption(const QString& name, const QVariant& value);
 };
 
@@ -1,12 +1,16 @@
 #include "qtspellcheckengine.h"
 #include "qtspellcheckbackend.h"
 #include "qtspellcheckbackendfactory.h"
+#include "qtspellingcache.h"
 #include <QWaitCondition>
 #include <QMutex>
 #include <QLocale>
 #include <QString>
 #include <QSet>
+#include <QHash>
+#include <algorithm>
 #include <deque>
+#include <memory>
 
 namespace
 {
@@ -15,11 +19,11 @@ namespace
         enum
         {
             None = -1,
-            SpellWord = 0,
-            AppendWord,
+            AppendWord = 0,
             RemoveWord,
             IgnoreWord,
-            Suggestions
+            Suggestions,
+            ChangeBackend
         };
 
         QStringList languages;
@@ -154,130 +158,377 @@ namespace
         size_t current = 0;
         bool valid = true;
     };
+
+    // tokens of one spell() call, shared by its chunks
+    struct SpellBatch
+    {
+        QObject* receiver = nullptr;
+        QStringList languages;
+        int languageSet = 0; // id of languages in the verdict cache
+        QVector<QtSpellCheckEngine::Token> tokens;
+        std::vector<QVector<IndexRange>> results; // misspelled ranges of every chunk
+        QAtomicInt pending;  // chunks not checked yet
+        QAtomicInt canceled;
+    };
+
+    using SpellBatchPtr = std::shared_ptr<SpellBatch>;
+
+    // range of tokens checked by one worker at once
+    struct SpellChunk
+    {
+        SpellBatchPtr batch;
+        int index = 0;
+        int first = 0;
+        int last = 0;
+    };
 }
 
 
 class QtSpellCheckEnginePrivate
 {
 public:
-    static constexpr size_t kMaxCacheCapacity = 1024;
+    static constexpr size_t kMaxCacheCapacity = 65536;
     static constexpr size_t kPreallocReceivers = 4; // preallocated number of queues for receivers
     static constexpr int kMinSuggests = 1;
     static constexpr int kMaxSuggests = 10;
+    static constexpr int kMaxWorkers = 4;
+    static constexpr int kMinChunkSize = 64; // tokens
 
-    using MisspelledCache = QSet<QString>;
+    struct SpellWorker
+    {
+        QScopedPointer<QThread> thread;
+        std::shared_ptr<QtSpellCheckBackend> backend;
+        std::vector<SpellCheckEvent> updates; // dictionary changes not applied yet, guarded by poolMutex
+        bool shared = false; // backend of the engine thread, loaded and updated by it
+    };
 
     QtSpellCheckEngine* q;
-    QScopedPointer<QtSpellCheckBackend> backend;
-    QString preferredBackend, currentBackend;
+    std::shared_ptr<QtSpellCheckBackend> backend; // of the engine thread, workers share it if it's thread-safe
+    QString preferredBackend, currentBackend; // guarded by mtx
+    QVariantHash backendOptions; // guarded by mtx
+    QStringList supportedLanguages; // of the current backend, guarded by mtx
+    QtSpellingCache cache{ kMaxCacheCapacity }; // verdicts shared by all workers
+    QString cacheFile; // guarded by mtx
     SpellEventBroker queueBroker;
     QMutex mtx;
     QWaitCondition cv;
     bool ready = false;
     bool interrupted = false;
 
+    // worker pool, started and stopped by the engine thread
+    std::vector<std::unique_ptr<SpellWorker>> workers;
+    std::deque<SpellChunk> chunks;
+    std::vector<SpellBatchPtr> batches; // batches with chunks in progress
+    QMutex poolMutex;
+    QWaitCondition poolCv;
+    bool poolStopped = false;
+    const int workerCount;
+
     explicit QtSpellCheckEnginePrivate(QtSpellCheckEngine* engine)
         : q(engine)
+        , workerCount(std::clamp(QThread::idealThreadCount(), 1, kMaxWorkers))
     {
-        createBackend();
+        resetBackend();
     }
 
-    void createBackend()
+    // Replaces the backend of the engine thread and publishes its name
+    // and languages, so other threads never touch the backend itself
+    void resetBackend()
     {
+        QString name;
+        std::shared_ptr<QtSpellCheckBackend> created(createBackend(&name));
+        const QStringList languages = created->supportedLanguages();
+        backend.swap(created);
+
+        QMutexLocker locker(&mtx);
+        currentBackend = name;
+        supportedLanguages = languages;
+    }
+
+    QtSpellCheckBackend* createBackend(QString* name = nullptr)
+    {
+        QString preferred;
+        QVariantHash options;
+        {
+            QMutexLocker locker(&mtx);
+            preferred = preferredBackend;
+            options = backendOptions;
+        }
+
         auto& factoryInstance = QtSpellCheckBackendFactory::instance();
-        if (!preferredBackend.isEmpty())
+        QtSpellCheckBackend* result = nullptr;
+        QString backendName;
+        if (!preferred.isEmpty())
         {
-            currentBackend = preferredBackend;
-            backend.reset(factoryInstance.createBackend(preferredBackend));
+            backendName = preferred;
+            result = factoryInstance.createBackend(preferred);
         }
-        if (!backend)
+        if (!result)
         {
-            currentBackend = factoryInstance.platformBackend();
-            backend.reset(factoryInstance.createBackend(factoryInstance.platformBackend()));
+            backendName = factoryInstance.platformBackend();
+            result = factoryInstance.createBackend(factoryInstance.platformBackend());
         }
-        if (!backend)
+        if (!result)
         {
-            currentBackend.clear();
-            backend.reset(new QtSpellCheckBackend);
+            backendName.clear();
+            result = new QtSpellCheckBackend;
         }
+        for (auto it = options.cbegin(); it != options.cend(); ++it)
+            result->setOption(it.key(), it.value());
+
+        if (name)
+            *name = backendName;
+        return result;
     }
 
-    static void updateCache(MisspelledCache& cache, const QString& word)
+    void startWorkers()
     {
-        cache.insert(word);
-        if (cache.size() < kMaxCacheCapacity)
-            return;
+        poolStopped = false;
+        workers.reserve(workerCount);
 
-        auto it = cache.cbegin();
-        while (cache.size() >= kMaxCacheCapacity) // make room for new entries
+        // thread-safe backend is shared by all workers, it's told
+        // how many of them may check words in one language at once
+        const bool shared = backend->isThreadSafe();
+        if (shared)
+            backend->setConcurrency(workerCount);
+
+        for (int i = 0; i < workerCount; ++i)
         {
-            while (it != cache.cend() && *it == word)
-                ++it;
-            it = cache.erase(it);
+            auto worker = std::make_unique<SpellWorker>();
+            worker->shared = shared;
+            if (worker->shared)
+                worker->backend = backend;
+            else
+                worker->backend.reset(createBackend());
+            worker->thread.reset(QThread::create([this, w = worker.get()]() { runWorker(*w); }));
+            worker->thread->start();
+            workers.push_back(std::move(worker));
         }
     }
 
-    void processSpellEvent(QObject* object, const SpellCheckEvent& event, MisspelledCache& cache)
+    void stopWorkers()
     {
+        {
+            QMutexLocker locker(&poolMutex);
+            poolStopped = true;
+        }
+        poolCv.wakeAll();
+
+        for (auto& worker : workers)
+            worker->thread->wait();
+        workers.clear();
+    }
+
+    void runWorker(SpellWorker& worker)
+    {
+        if (!worker.shared)
+            worker.backend->load();
+
+        std::vector<SpellCheckEvent> updates;
+        SpellChunk chunk;
+        Q_FOREVER
+        {
+            {
+                QMutexLocker locker(&poolMutex);
+                while (!poolStopped && chunks.empty() && worker.updates.empty())
+                    poolCv.wait(&poolMutex);
+
+                if (poolStopped)
+                    break;
+
+                // changes posted before the chunk are applied before it
+                updates.swap(worker.updates);
+                if (!chunks.empty())
+                {
+                    chunk = std::move(chunks.front());
+                    chunks.pop_front();
+                }
+            }
+
+            for (const auto& event : updates)
+                applyUpdate(worker, event);
+            updates.clear();
+
+            if (chunk.batch)
+            {
+                spellChunk(worker, chunk);
+                chunk = {};
+            }
+        }
+
+        if (!worker.shared)
+            worker.backend->unload();
+    }
+
+    void applyUpdate(SpellWorker& worker, const SpellCheckEvent& event)
+    {
+        // the verdict might be cached by a chunk checked in between
+        cache.remove(event.word);
+
+        // shared backend is already updated by the engine thread
+        if (worker.shared)
+            return;
+
         switch (event.type)
         {
-        case SpellCheckEvent::SpellWord:
-            spellEvent(object, event, cache);
-            break;
         case SpellCheckEvent::AppendWord:
-            supplyEvent(event, cache);
+            worker.backend->append(event.word);
             break;
         case SpellCheckEvent::RemoveWord:
-            discardEvent(event, cache);
+            worker.backend->remove(event.word);
             break;
         case SpellCheckEvent::IgnoreWord:
-            ignoreEvent(event, cache);
-            break;
-        case SpellCheckEvent::Suggestions:
-            suggestionsEvent(object, event);
+            worker.backend->ignore(event.word);
             break;
         default:
             break;
         }
     }
 
-    void spellEvent(QObject* object, const SpellCheckEvent& event, MisspelledCache& cache)
+    void spellChunk(SpellWorker& worker, const SpellChunk& chunk)
     {
-        if (!backend || event.word.isEmpty() || event.offset < 0) // poisoned message detected
+        SpellBatch& batch = *chunk.batch;
+        // every chunk owns its slot, so results are collected without locking
+        QVector<IndexRange>& misspelled = batch.results[chunk.index];
+        for (int i = chunk.first; i < chunk.last; ++i)
+        {
+            if (batch.canceled.loadAcquire())
+                return;
+
+            const auto& token = batch.tokens[i];
+            if (token.word.isEmpty() || token.offset < 0)
+                continue;
+
+            auto verdict = cache.lookup(batch.languageSet, token.word);
+            if (verdict == QtSpellingCache::Unknown)
+            {
+                const bool correct = worker.backend->validate(token.word, batch.languages);
+                cache.insert(batch.languageSet, token.word, correct);
+                verdict = correct ? QtSpellingCache::Correct : QtSpellingCache::Misspelled;
+            }
+
+            if (verdict == QtSpellingCache::Misspelled)
+                misspelled.push_back({ token.offset, token.word.length() });
+        }
+
+        // the last finished chunk delivers the whole batch
+        if (batch.pending.fetchAndSubOrdered(1) != 1)
+            return;
+
         {
-            Q_EMIT q->completed(object);
+            QMutexLocker locker(&poolMutex);
+            batches.erase(std::remove(batches.begin(), batches.end(), chunk.batch), batches.end());
+        }
+
+        if (batch.canceled.loadAcquire())
             return;
+
+        QVector<IndexRange> ranges;
+        if (batch.results.size() == 1)
+        {
+            ranges.swap(batch.results.front());
+        }
+        else
+        {
+            int total = 0;
+            for (const auto& r : batch.results)
+                total += r.size();
+
+            ranges.reserve(total);
+            for (const auto& r : batch.results)
+                ranges += r;
+        }
+        Q_EMIT q->completed(batch.receiver, ranges);
+    }
+
+    void postBatch(const SpellBatchPtr& batch)
+    {
+        // several chunks per worker even out words of different cost
+        const int count = batch->tokens.size();
+        const int parts = workerCount * 2;
+        const int chunkSize = std::max(kMinChunkSize, (count + parts - 1) / parts);
+        const int chunkCount = std::max(1, (count + chunkSize - 1) / chunkSize);
+        batch->results.resize(chunkCount);
+        batch->pending.storeRelease(chunkCount);
+
+        {
+            QMutexLocker locker(&poolMutex);
+            batches.push_back(batch);
+            for (int i = 0; i < chunkCount; ++i)
+                chunks.push_back({ batch, i, i * chunkSize, std::min(count, (i + 1) * chunkSize) });
         }
+        poolCv.wakeAll();
+    }
 
-        if (cache.contains(event.word))
+    void discardBatches(QObject* object)
+    {
+        QMutexLocker locker(&poolMutex);
+        for (const auto& batch : batches)
         {
-            Q_EMIT q->misspelled(object, event.word, event.offset);
+            if (batch->receiver == object)
+                batch->canceled.storeRelease(1);
         }
-        else if (!backend->validate(event.word, event.languages))
+
+        auto isCanceled = [](const auto& b) { return b->canceled.loadAcquire() != 0; };
+        batches.erase(std::remove_if(batches.begin(), batches.end(), isCanceled), batches.end());
+        chunks.erase(std::remove_if(chunks.begin(), chunks.end(), [&](const SpellChunk& c) { return isCanceled(c.batch); }), chunks.end());
+    }
+
+    void broadcastUpdate(const SpellCheckEvent& event)
+    {
         {
-            updateCache(cache, event.word);
-            Q_EMIT q->misspelled(object, event.word, event.offset);
+            QMutexLocker locker(&poolMutex);
+            for (auto& worker : workers)
+                worker->updates.push_back(event);
         }
+        poolCv.wakeAll();
     }
 
-    void supplyEvent(const SpellCheckEvent& event, MisspelledCache& cache)
+    void processSpellEvent(QObject* object, const SpellCheckEvent& event)
+    {
+        switch (event.type)
+        {
+        case SpellCheckEvent::AppendWord:
+            supplyEvent(event);
+            break;
+        case SpellCheckEvent::RemoveWord:
+            discardEvent(event);
+            break;
+        case SpellCheckEvent::IgnoreWord:
+            ignoreEvent(event);
+            break;
+        case SpellCheckEvent::Suggestions:
+            suggestionsEvent(object, event);
+            break;
+        case SpellCheckEvent::ChangeBackend:
+            changeBackendEvent();
+            break;
+        default:
+            break;
+        }
+    }
+
+    void supplyEvent(const SpellCheckEvent& event)
     {
-        cache.remove(event.word);
         backend->append(event.word);
+        cache.remove(event.word);
+        broadcastUpdate(event);
         Q_EMIT q->appended(event.word);
     }
 
-    void discardEvent(const SpellCheckEvent& event, MisspelledCache& cache)
+    void discardEvent(const SpellCheckEvent& event)
     {
-        updateCache(cache, event.word);
         backend->remove(event.word);
+        cache.remove(event.word);
+        broadcastUpdate(event);
         Q_EMIT q->removed(event.word);
     }
 
-    void ignoreEvent(const SpellCheckEvent& event, MisspelledCache& cache)
+    void ignoreEvent(const SpellCheckEvent& event)
     {
-        cache.remove(event.word);
         backend->ignore(event.word);
+        cache.remove(event.word);
+        broadcastUpdate(event);
         Q_EMIT q->ignored(event.word);
     }
 
@@ -301,6 +552,34 @@ public:
         Q_EMIT q->suggestsFound(object, event.word, results, actions);
     }
 
+    void changeBackendEvent()
+    {
+        // queued chunks survive the restart and go to the new workers
+        stopWorkers();
+        backend->unload();
+        saveCache();
+        cache.clear();
+
+        resetBackend();
+        loadCache();
+        backend->load();
+        startWorkers();
+    }
+
+    void loadCache()
+    {
+        QMutexLocker locker(&mtx);
+        if (!cacheFile.isEmpty())
+            cache.load(cacheFile, currentBackend);
+    }
+
+    void saveCache()
+    {
+        QMutexLocker locker(&mtx);
+        if (!cacheFile.isEmpty())
+            cache.save(cacheFile, currentBackend);
+    }
+
     void postSpellEvent(QObject* receiver, int type, const QStringList& langs, const QString& word, int offset = -1, int count = 0)
     {
         if (!q->isRunning())
@@ -343,37 +622,118 @@ QtSpellCheckEngine& QtSpellCheckEngine::instance()
 
 void QtSpellCheckEngine::setPrefferedBackend(const QString& backend)
 {
-    d->preferredBackend = backend;
+    {
+        QMutexLocker locker(&d->mtx);
+        d->preferredBackend = backend;
+    }
+
+    if (isRunning())
+    {
+        // backends are owned by the running threads
+        d->postSpellEvent(nullptr, SpellCheckEvent::ChangeBackend, {}, {});
+        return;
+    }
+
+    d->resetBackend();
+}
+
+void QtSpellCheckEngine::setBackendOption(const QString& name, const QVariant& value)
+{
+    {
+        QMutexLocker locker(&d->mtx);
+        auto it = d->backendOptions.constFind(name);
+        if (it != d->backendOptions.cend() && *it == value)
+            return;
+
+        d->backendOptions.insert(name, value);
+    }
+
+    if (isRunning())
+    {
+        // backends are owned by the running threads
+        d->postSpellEvent(nullptr, SpellCheckEvent::ChangeBackend, {}, {});
+        return;
+    }
+
+    d->resetBackend();
+}
+
+QVariant QtSpellCheckEngine::backendOption(const QString& name) const
+{
     QMutexLocker locker(&d->mtx);
-    d->createBackend();
+    return d->backendOptions.value(name);
 }
 
 QString QtSpellCheckEngine::preferredBackend() const
 {
+    QMutexLocker locker(&d->mtx);
     return d->preferredBackend;
 }
 
 QString QtSpellCheckEngine::backendName() const
 {
+    QMutexLocker locker(&d->mtx);
     return d->currentBackend;
 }
 
 QStringList QtSpellCheckEngine::supportedLanguages() const
 {
-    return d->backend ? d->backend->supportedLanguages() : QStringList{};
+    QMutexLocker locker(&d->mtx);
+    return d->supportedLanguages;
 }
 
-void QtSpellCheckEngine::spell(const QString& word, int offset, const QStringList& langs, QObject* receiver)
+int QtSpellCheckEngine::workerCount() const
 {
-    if (!d->backend)
-        return;
+    return d->workerCount;
+}
+
+void QtSpellCheckEngine::setCacheFile(const QString& fileName)
+{
+    {
+        QMutexLocker locker(&d->mtx);
+        if (d->cacheFile == fileName)
+            return;
 
-    d->postSpellEvent(receiver, SpellCheckEvent::SpellWord, langs, word, offset);
+        d->cacheFile = fileName;
+    }
+
+    // otherwise the cache is loaded once the engine starts
+    if (isRunning())
+        d->loadCache();
+}
+
+QString QtSpellCheckEngine::cacheFile() const
+{
+    QMutexLocker locker(&d->mtx);
+    return d->cacheFile;
+}
+
+void QtSpellCheckEngine::clearCache()
+{
+    d->cache.clear();
+}
+
+void QtSpellCheckEngine::spell(const QVector<Token>& tokens, const QStringList& langs, QObject* receiver)
+{
+    if (!isRunning())
+        start();
+
+    auto batch = std::make_shared<SpellBatch>();
+    batch->receiver = receiver;
+    batch->languages = langs;
+    batch->languageSet = d->cache.languageSet(langs);
+    batch->tokens = tokens;
+    d->postBatch(batch);
+}
+
+void QtSpellCheckEngine::spell(const QString& word, int offset, const QStringList& langs, QObject* receiver)
+{
+    spell(QVector<Token>{ { word, offset } }, langs, receiver);
 }
 
 void QtSpellCheckEngine::requestSuggests(const QString& word, int count, const QStringList& langs, QObject* receiver)
 {
-    if (word.isEmpty() || !d->backend)
+    if (word.isEmpty())
         return;
 
     d->postSpellEvent(receiver, SpellCheckEvent::Suggestions, langs, word, -1, std::clamp(count, d->kMinSuggests, d->kMaxSuggests));
@@ -381,7 +741,7 @@ void QtSpellCheckEngine::requestSuggests(const QString& word, int count, const Q
 
 void QtSpellCheckEngine::append(const QString& word)
 {
-    if (word.isEmpty() || !d->backend)
+    if (word.isEmpty())
         return;
 
     d->postSpellEvent(nullptr, SpellCheckEvent::AppendWord, {}, word);
@@ -389,7 +749,7 @@ void QtSpellCheckEngine::append(const QString& word)
 
 void QtSpellCheckEngine::remove(const QString& word)
 {
-    if (word.isEmpty() || !d->backend)
+    if (word.isEmpty())
         return;
 
     d->postSpellEvent(nullptr, SpellCheckEvent::RemoveWord, {}, word);
@@ -397,7 +757,7 @@ void QtSpellCheckEngine::remove(const QString& word)
 
 void QtSpellCheckEngine::ignore(const QString& word)
 {
-    if (word.isEmpty() || !d->backend)
+    if (word.isEmpty())
         return;
 
     d->postSpellEvent(nullptr, SpellCheckEvent::IgnoreWord, {}, word);
@@ -406,25 +766,23 @@ void QtSpellCheckEngine::ignore(const QString& word)
 void QtSpellCheckEngine::run()
 {
     qRegisterMetaType<QtSpellCheckEngine::SpellingActions>("SpellCheckEngine::SpellingActions");
+    qRegisterMetaType<QVector<IndexRange>>();
 
     d->ready = false;
     d->interrupted = false;
 
-    if (d->backend)
-        d->backend->load();
-
+    d->backend->load();
+    d->loadCache();
+    d->startWorkers();
     d->queueBroker.reserve(d->kPreallocReceivers);
 
-    QtSpellCheckEnginePrivate::MisspelledCache misspellingsCache;
-    misspellingsCache.reserve(d->kMaxCacheCapacity);
-
     QObject* receiver = nullptr;
     SpellCheckEvent event;
     Q_FOREVER
     {
         if (d->queueBroker.tryPop(event, receiver))
         {
-            d->processSpellEvent(receiver, event, misspellingsCache);
+            d->processSpellEvent(receiver, event);
             continue;
         }
 
@@ -446,12 +804,15 @@ void QtSpellCheckEngine::run()
         d->cv.notify_one();
     }
 
-    if (d->backend)
-        d->backend->unload();
+    d->stopWorkers();
+    d->backend->unload();
+
+    d->saveCache();
 }
 
 void QtSpellCheckEngine::cancel(QObject* object)
 {
+    d->discardBatches(object);
     {
         QMutexLocker lk(&d->mtx);
         d->queueBroker.discard(object);
@@ -460,4 +821,3 @@ void QtSpellCheckEngine::cancel(QObject* object)
 
     d->cv.notify_one();
 }
-
@@ -1,12 +1,25 @@
 #pragma once
 #include <QThread>
 #include <QSet>
+#include <QVector>
+#include <QVariant>
+
+#include <IndexRange> // from Qt5Extra aux
 
 #include <QtSpellChecking>
 
 class QtSpellChecker;
 class QtSpellCheckBackend;
 
+//
+// QtSpellCheckEngine is the shared spell checking service. Words are
+// checked by the pool of worker threads, so large batches are split
+// across the cores. Dictionary changes and suggestions are handled by
+// the engine thread. A thread-safe backend is shared by the engine
+// thread and all workers, otherwise every worker owns its own backend
+// instance, so such backend keeps its dictionaries in memory up to
+// workerCount() + 1 times
+//
 class QTSPELLCHECKING_EXPORT QtSpellCheckEngine : public QThread
 {
     Q_OBJECT
@@ -25,6 +38,12 @@ public:
     Q_DECLARE_FLAGS(SpellingActions, SpellingAction)
     Q_FLAG(SpellingActions)
 
+    struct Token
+    {
+        QString word;
+        int offset = -1;
+    };
+
     ~QtSpellCheckEngine() Q_DECL_OVERRIDE;
 
     static QtSpellCheckEngine& instance();
@@ -35,6 +54,23 @@ public:
     QString backendName() const;
     QStringList supportedLanguages() const;
 
+    // options are passed to every backend created by the engine
+    // (see QtSpellCheckBackend::setOption()), the running engine
+    // recreates its backends to apply them
+    void setBackendOption(const QString& name, const QVariant& value);
+    QVariant backendOption(const QString& name) const;
+
+    int workerCount() const;
+
+    // spelling verdicts are kept between sessions in the cache file,
+    // it's loaded when the engine starts and saved when it stops
+    void setCacheFile(const QString& fileName);
+    QString cacheFile() const;
+    void clearCache();
+
+    // completed() delivers ranges of all misspelled
+    // tokens of the batch, once it is checked entirely
+    void spell(const QVector<Token>& tokens, const QStringList& langs = {}, QObject* receiver = nullptr);
     void spell(const QString& word, int offset, const QStringList& langs = {}, QObject* receiver = nullptr);
     void requestSuggests(const QString& word, int count, const QStringList& langs = {}, QObject* receiver = nullptr);
     void append(const QString& word);
@@ -43,8 +79,7 @@ public:
     void cancel(QObject* object);
 
 Q_SIGNALS:
-    void misspelled(QObject* object, const QString& word, int offset);
-    void completed(QObject* object);
+    void completed(QObject* object, const QVector<IndexRange>& misspelled);
     void appended(const QString& word);
     void removed(const QString& word);
     void ignored(const QString& word);
@@ -57,5 +92,6 @@ private:
     QScopedPointer<class QtSpellCheckEnginePrivate> d;
 };
 
+Q_DECLARE_TYPEINFO(QtSpellCheckEngine::Token, Q_MOVABLE_TYPE);
 Q_DECLARE_OPERATORS_FOR_FLAGS(QtSpellCheckEngine::SpellingActions)
 Q_DECLARE_METATYPE(QtSpellCheckEngine::SpellingActions)
@@ -14,6 +14,8 @@
 
 #include <QTextFormat>
 #include <QTextBlock>
+#include <QHash>
+#include <QTextDocument>
 #include <QScrollBar>
 #include <QEvent>
 #include <QTimer>
@@ -54,6 +56,29 @@ namespace
             return false;
         }
     };
+
+    // misspelled ranges of the block, offsets are relative to the block,
+    // so they stay valid when the text above the block is edited
+    struct SpellBlockState
+    {
+        QVector<IndexRange> misspelled;
+        int revision = -1;   // of the block, tells apart blocks reusing the index
+        int generation = -1; // the block is dirty unless it matches the checker
+    };
+
+    // follows the edit of the block: ranges after it are shifted, touched ones are dropped
+    void shiftRanges(QVector<IndexRange>& ranges, int position, int removed, int added)
+    {
+        auto touched = [=](const IndexRange& r) { return r.offset <= position + removed && r.offset + r.length >= position; };
+        ranges.erase(std::remove_if(ranges.begin(), ranges.end(), touched), ranges.end());
+
+        const int delta = added - removed;
+        for (auto& r : ranges)
+        {
+            if (r.offset > position)
+                r += delta;
+        }
+    }
 }
 
 
@@ -70,10 +95,18 @@ public:
     QPointer<QtMisspellHighlighter> highlighter;
     QPointer<QtSpellCompleter> corrector;
     QtTextControl target;
+    QPointer<QTextDocument> document;
     QStringSet languages;
-    QVector<IndexRange> misspelledRanges;
+    QVector<IndexRange> misspelledRanges; // widgets without document only
     IndexRange visibleRange;
-    QtTextTokenizer tokenizer;
+    std::vector<QTextBlock> pendingBlocks; // blocks of the batch in progress
+    QHash<int, SpellBlockState> blockStates; // by QTextBlock::fragmentIndex(), user data is left to clients
+    int generation = 0;
+    int contentRevision = 0;
+    int pendingRevision = -1;
+    bool batchInFlight = false;
+    bool rescanQueued = false;
+    bool rescanPending = false;
     SpellCheckFilter filter;
     bool hightlightActive = false;
     bool enabled = true;
@@ -98,8 +131,57 @@ public:
         return { offset, length };
     }
 
+    const SpellBlockState* blockState(const QTextBlock& block) const
+    {
+        auto it = blockStates.constFind(block.fragmentIndex());
+        if (it == blockStates.cend() || it->revision != block.revision())
+            return nullptr;
+        return &(*it);
+    }
+
+    SpellBlockState* blockState(const QTextBlock& block)
+    {
+        return const_cast<SpellBlockState*>(qAsConst(*this).blockState(block));
+    }
+
+    SpellBlockState& resetBlockState(const QTextBlock& block)
+    {
+        SpellBlockState& state = blockStates[block.fragmentIndex()];
+        state.misspelled.clear();
+        state.revision = block.revision();
+        state.generation = generation;
+        return state;
+    }
+
+    // states of removed blocks are dropped once they outnumber live ones
+    void pruneBlockStates()
+    {
+        if (blockStates.size() <= 2 * document->blockCount())
+            return;
+
+        QSet<int> live;
+        live.reserve(document->blockCount());
+        for (QTextBlock block = document->begin(); block.isValid(); block = block.next())
+            live.insert(block.fragmentIndex());
+
+        for (auto it = blockStates.begin(); it != blockStates.end(); )
+            it = live.contains(it.key()) ? std::next(it) : blockStates.erase(it);
+    }
+
     bool containsMisspelled(const IndexRange& range) const
     {
+        if (document)
+        {
+            const QTextBlock block = document->findBlock(range.offset);
+            const SpellBlockState* data = blockState(block);
+            if (!data)
+                return false;
+
+            const IndexRange local{ range.offset - block.position(), range.length };
+            return std::any_of(data->misspelled.cbegin(), data->misspelled.cend(),
+                               [local](const auto& r) { return r.contains(local); });
+        }
+
         if (misspelledRanges.empty())
             return false;
 
@@ -116,54 +198,194 @@ public:
         }
     }
 
-    template<class T>
-    void rescanContent(const T& content, const IndexRange& range)
+    void rescanText(const QString& content, const IndexRange& range)
     {
-        static QStringList systemLangs = Qt5Extra::systemLanguages();
+        if (content.isEmpty())
+            return;
+
+        combineLanguages(detector.identify(content.midRef(range.offset, range.length)));
 
-        QStringList langs;
-        if constexpr(std::is_same_v<T, QTextDocument*>)
+        misspelledRanges.clear();
+        QtSpellCheckEngine::instance().cancel(q);
+
+        // the whole range goes to the engine as one batch
+        QVector<QtSpellCheckEngine::Token> tokens;
+        auto handler = [&tokens](QStringView word, int offset)
         {
-            if (!content || range.length == 0)
-                return;
+            tokens.push_back({ word.toString(), offset });
+        };
+
+        if (IndexRange{ 0, content.size() }.contains(range))
+            QtTextTokenizer::tokenize(QStringView{ content }.mid(range.offset, range.length), range.offset, filter, handler);
 
-            langs = detector.identify(content->toPlainText().midRef(range.offset, range.length));
+        QtSpellCheckEngine::instance().spell(tokens, languages.toList(), q);
+    }
+
+    void rescanBlocks()
+    {
+        // results can't be told apart from the ones of a canceled batch,
+        // so one batch is checked at a time and the next pass waits for it
+        if (batchInFlight)
+        {
+            rescanQueued = true;
+            return;
         }
-        else if constexpr(std::is_same_v<T, QString>)
+
+        if (visibleRange.offset < 0 || visibleRange.length <= 0)
+            return;
+
+        QTextBlock block = document->findBlock(visibleRange.offset);
+        QTextBlock lastBlock = document->findBlock(visibleRange.offset + visibleRange.length - 1);
+        if (!lastBlock.isValid())
+            lastBlock = document->lastBlock();
+
+        pendingBlocks.clear();
+
+        QVector<QtSpellCheckEngine::Token> tokens;
+        auto handler = [&tokens](QStringView word, int offset)
         {
-            if (content.isEmpty())
-                return;
+            tokens.push_back({ word.toString(), offset });
+        };
 
-            langs = detector.identify(content.midRef(range.offset, range.length));
-        }
-        else
+        // text of dirty blocks is copied once, it's tokenized
+        // by fragments and passed to the language detector
+        QString text;
+        const bool documentAccepted = filter.documentAccepted(*document);
+        for (; block.isValid(); block = block.next())
         {
-            qCritical() << "[QtSpellCheckerPrivate]: invalid content type";
+            const SpellBlockState* data = blockState(block);
+            if (!data || data->generation != generation)
+            {
+                pendingBlocks.push_back(block);
+                const int start = text.size();
+                text += block.text();
+                if (documentAccepted && filter.blockAccepted(block))
+                {
+                    const QStringView blockText = QStringView{ text }.mid(start);
+                    const int blockPosition = block.position();
+                    for (auto it = block.begin(); !(it.atEnd()); ++it)
+                    {
+                        const QTextFragment fragment = it.fragment();
+                        if (filter.fragmentAccepted(fragment))
+                            QtTextTokenizer::tokenize(blockText.mid(fragment.position() - blockPosition, fragment.length()), fragment.position(), filter, handler);
+                    }
+                }
+                text += QChar::LineFeed;
+            }
+
+            if (block == lastBlock)
+                break;
+        }
+
+        if (pendingBlocks.empty())
+            return;
+
+        combineLanguages(detector.identify(QStringRef(&text)));
+
+        pendingRevision = contentRevision;
+        batchInFlight = true;
+        QtSpellCheckEngine::instance().spell(tokens, languages.toList(), q);
+    }
+
+    void applyBlockResults(const QVector<IndexRange>& misspelled)
+    {
+        batchInFlight = false;
+        if (std::exchange(rescanQueued, false) && enabled)
+            QMetaObject::invokeMethod(q, [this]() { q->update(); }, Qt::QueuedConnection);
+
+        // offsets of the batch are stale once the document is edited,
+        // its blocks are still dirty and will be checked by the next pass
+        if (!enabled || pendingRevision != contentRevision || pendingBlocks.empty())
             return;
+
+        const QTextBlock firstBlock = pendingBlocks.front();
+        const QTextBlock lastBlock = pendingBlocks.back();
+        const IndexRange span{ firstBlock.position(), lastBlock.position() + lastBlock.length() - firstBlock.position() };
+
+        // ranges of the whole span: results of the checked blocks
+        // and cached ranges of the clean blocks in between
+        QVector<IndexRange> ranges;
+        auto result = misspelled.cbegin();
+        auto pending = pendingBlocks.cbegin();
+        for (QTextBlock block = firstBlock; block.isValid(); block = block.next())
+        {
+            const int position = block.position();
+            if (pending != pendingBlocks.cend() && *pending == block)
+            {
+                ++pending;
+                SpellBlockState& data = resetBlockState(block);
+                for (const int end = position + block.length(); result != misspelled.cend() && result->offset < end; ++result)
+                {
+                    ranges.push_back(*result);
+                    data.misspelled.push_back({ result->offset - position, result->length });
+                }
+            }
+            else if (const SpellBlockState* data = blockState(block))
+            {
+                for (const auto& r : data->misspelled)
+                    ranges.push_back({ r.offset + position, r.length });
+            }
+
+            if (block == lastBlock)
+                break;
         }
+        pendingBlocks.clear();
+        pruneBlockStates();
 
-        combineLanguages(langs);
+        if (highlighter)
+            highlighter->update(span, ranges.constData(), ranges.size());
+    }
 
-        misspelledRanges.clear();
-        QtSpellCheckEngine::instance().cancel(q);
+    void onContentsChange(int position, int removed, int added)
+    {
+        ++contentRevision;
 
-        QtTextTokenizer::TokenHandler handler = [this](QStringView word, int offset)
+        QTextBlock block = document->findBlock(position);
+        const QTextBlock lastBlock = document->findBlock(position + added);
+        auto edited = blockStates.find(block.fragmentIndex());
+        if (edited != blockStates.end())
         {
-            QtSpellCheckEngine::instance().spell(word.toString(), offset, languages.toList(), q);
-        };
+            // the edit has changed revision of the block
+            shiftRanges(edited->misspelled, position - block.position(), removed, added);
+            edited->revision = block.revision();
+        }
+
+        // only the edited blocks are checked again, the rest keep their results
+        for (; block.isValid(); block = block.next())
+        {
+            if (SpellBlockState* data = blockState(block))
+                data->generation = -1;
 
-        tokenizer(content, range, filter, handler);
+            if (block == lastBlock)
+                break;
+        }
+
+        // edits come in bursts, they are checked at once
+        if (rescanPending)
+            return;
 
-        QtSpellCheckEngine::instance().spell({}, -1, {}, q);
+        rescanPending = true;
+        QMetaObject::invokeMethod(q, [this]()
+        {
+            rescanPending = false;
+            q->update();
+        }, Qt::QueuedConnection);
     }
 
-    void rescan()
+    void update()
     {
         visibleRange = target.visibleTextRange();
-        if (QTextDocument* document = target.document())
-            rescanContent<QTextDocument*>(document, visibleRange);
+        if (document)
+            rescanBlocks();
         else
-            rescanContent<QString>(target.text(), visibleRange);
+            rescanText(target.text(), visibleRange);
+    }
+
+    void rescan()
+    {
+        // every block becomes dirty at once
+        ++generation;
+        update();
     }
 
     void onKeyReleaseEvent(QKeyEvent* e)
@@ -189,7 +411,6 @@ QtSpellChecker::QtSpellChecker(QWidget* widget)
     : QObject(widget)
     , d(new QtSpellCheckerPrivate(this))
 {
-    connect(&QtSpellCheckEngine::instance(), &QtSpellCheckEngine::misspelled, this, &QtSpellChecker::onMisspelled);
     connect(&QtSpellCheckEngine::instance(), &QtSpellCheckEngine::completed, this, &QtSpellChecker::onCompleted);
     connect(&QtSpellCheckEngine::instance(), &QtSpellCheckEngine::appended, this, &QtSpellChecker::rescan);
     connect(&QtSpellCheckEngine::instance(), &QtSpellCheckEngine::removed, this, &QtSpellChecker::rescan);
@@ -275,10 +496,19 @@ void QtSpellChecker::setWidget(QWidget *w)
             viewport->removeEventFilter(this);
 
         disconnect(d->target, 0, this, 0);
+        disconnect(&d->target, 0, this, 0);
+        if (d->document)
+            disconnect(d->document, 0, this, 0);
         QtSpellCheckEngine::instance().cancel(this);
     }
 
     d->target.reset(w);
+    d->document = d->target.document();
+    d->pendingBlocks.clear();
+    d->blockStates.clear();
+    d->batchInFlight = false;
+    d->rescanQueued = false;
+    ++d->generation;
     if (!d->target)
         return;
 
@@ -287,7 +517,15 @@ void QtSpellChecker::setWidget(QWidget *w)
         viewport->installEventFilter(this);
 
     connect(d->target, &QObject::destroyed, this, [this]() { setWidget(nullptr); });
-    connect(&d->target, &QtTextControl::textChanged, this, &QtSpellChecker::rescan);
+    if (d->document)
+    {
+        connect(d->document, &QTextDocument::contentsChange, this,
+                [this](int position, int removed, int added) { d->onContentsChange(position, removed, added); });
+    }
+    else
+    {
+        connect(&d->target, &QtTextControl::textChanged, this, &QtSpellChecker::rescan);
+    }
 
     if (QScrollBar* vbar = d->target.scrollBar(Qt::Vertical))
         connect(vbar, &QScrollBar::valueChanged, this, &QtSpellChecker::update);
@@ -349,25 +587,28 @@ void QtSpellChecker::update()
     if (!d->enabled || !d->target || d->hightlightActive)
         return;
 
-    if (d->target.visibleTextRange() != d->visibleRange)
-        d->rescan();
+    // clean blocks are skipped, so documents are checked on every call
+    if (d->document || d->target.visibleTextRange() != d->visibleRange)
+        d->update();
 }
 
-void QtSpellChecker::onMisspelled(QObject* receiver, const QString& word, int offset)
+void QtSpellChecker::onCompleted(QObject* receiver, const QVector<IndexRange>& misspelled)
 {
-    if (receiver != this || !d->enabled || !d->target)
+    if (receiver != this || !d->target)
         return;
 
-    if (d->target)
-        d->misspelledRanges.push_back({ offset, word.length() });
-}
+    QScopedValueRollback guard(d->hightlightActive, true);
+    if (d->document)
+    {
+        d->applyBlockResults(misspelled);
+        return;
+    }
 
-void QtSpellChecker::onCompleted(QObject* receiver)
-{
-    if (receiver != this || !d->enabled || !d->highlighter)
+    if (!d->enabled || !d->highlighter)
         return;
 
-    QScopedValueRollback guard(d->hightlightActive, true);
+    d->misspelledRanges = misspelled; // in the order of tokens
+
     d->highlighter->reset();
     d->highlighter->highlight(d->misspelledRanges.constData(), d->misspelledRanges.size());
 }
@@ -2,10 +2,11 @@
 #include <QObject>
 #include <QRect>
 #include <QString>
+#include <QVector>
 
 #include <QtSpellChecking>
 
-struct IndexRange;
+#include <IndexRange> // from Qt5Extra aux
 
 class QEvent;
 class QWidget;
@@ -49,8 +50,7 @@ public Q_SLOTS:
     void update();
 
 private Q_SLOTS:
-    void onMisspelled(QObject* receiver, const QString& word, int offset);
-    void onCompleted(QObject* receiver);
+    void onCompleted(QObject* receiver, const QVector<IndexRange>& misspelled);
 
 Q_SIGNALS:
     void minPrefixLengthChanged(int);
@@ -0,0 +1,189 @@
+#include "qtspellingcache.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+
+#include <algorithm>
+
+namespace
+{
+    constexpr quint32 kFileMagic = 0x51535043; // QSPC
+    constexpr quint32 kFileVersion = 1;
+
+#if (QT_VERSION < QT_VERSION_CHECK(5, 14, 0))
+    constexpr auto kSkipEmptyParts = QString::SkipEmptyParts;
+#else
+    constexpr auto kSkipEmptyParts = Qt::SkipEmptyParts;
+#endif
+
+    QString canonicalLanguages(QStringList languages)
+    {
+        std::sort(languages.begin(), languages.end());
+        languages.erase(std::unique(languages.begin(), languages.end()), languages.end());
+        return languages.join(QLatin1Char(','));
+    }
+}
+
+
+QtSpellingCache::QtSpellingCache(size_t capacity)
+{
+    const size_t shardCapacity = std::max<size_t>(1, capacity / kShardCount);
+    for (auto& shard : shards)
+        shard.resize(shardCapacity);
+}
+
+int QtSpellingCache::languageSet(const QStringList& languages)
+{
+    const QString name = canonicalLanguages(languages);
+
+    QMutexLocker locker(&languageMutex);
+    auto it = languageIds.constFind(name);
+    if (it != languageIds.cend())
+        return *it;
+
+    const int id = int(languageNames.size());
+    languageNames.push_back(name);
+    languageIds.insert(name, id);
+    return id;
+}
+
+QtSpellingCache::Verdict QtSpellingCache::lookup(int languages, const QString& word)
+{
+    const Key key{ languages, word };
+    const size_t index = shardOf(key);
+
+    QMutexLocker locker(&shardMutex[index]);
+    Shard& shard = shards[index];
+    auto it = shard.find(key);
+    if (it == shard.end())
+        return Unknown;
+
+    shard.move_font(it);
+    return it->second ? Correct : Misspelled;
+}
+
+void QtSpellingCache::insert(int languages, const QString& word, bool correct)
+{
+    Key key{ languages, word };
+    const size_t index = shardOf(key);
+
+    QMutexLocker locker(&shardMutex[index]);
+    auto result = shards[index].emplace(std::move(key), correct);
+    if (!result.second)
+        result.first->second = correct;
+}
+
+void QtSpellingCache::remove(const QString& word)
+{
+    int count = 0;
+    {
+        QMutexLocker locker(&languageMutex);
+        count = int(languageNames.size());
+    }
+
+    for (int languages = 0; languages < count; ++languages)
+    {
+        const Key key{ languages, word };
+        const size_t index = shardOf(key);
+
+        QMutexLocker locker(&shardMutex[index]);
+        shards[index].erase(key);
+    }
+}
+
+void QtSpellingCache::clear()
+{
+    for (int i = 0; i < kShardCount; ++i)
+    {
+        QMutexLocker locker(&shardMutex[i]);
+        shards[i].clear();
+    }
+}
+
+bool QtSpellingCache::load(const QString& fileName, const QString& backend)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly) || file.size() <= 0)
+        return false;
+
+    // strings are copied out of the mapping, so it's released right after parsing
+    uchar* data = file.map(0, file.size());
+    if (!data)
+        return false;
+
+    const QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char*>(data), int(file.size()));
+    QDataStream in(bytes);
+    in.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic = 0, version = 0;
+    QString savedBackend;
+    QStringList languages;
+    in >> magic >> version >> savedBackend >> languages;
+    if (in.status() != QDataStream::Ok || magic != kFileMagic || version != kFileVersion || savedBackend != backend)
+    {
+        file.unmap(data);
+        return false;
+    }
+
+    // ids of language sets are assigned on the fly, so they are mapped
+    std::vector<int> languageMap;
+    languageMap.reserve(languages.size());
+    for (const QString& name : languages)
+        languageMap.push_back(languageSet(name.split(QLatin1Char(','), kSkipEmptyParts)));
+
+    quint32 count = 0;
+    in >> count;
+
+    qint32 set = 0;
+    bool correct = false;
+    QString word;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i)
+    {
+        in >> set >> correct >> word;
+        if (in.status() != QDataStream::Ok || set < 0 || size_t(set) >= languageMap.size())
+            break;
+
+        insert(languageMap[set], word, correct);
+    }
+
+    file.unmap(data);
+    return in.status() == QDataStream::Ok;
+}
+
+bool QtSpellingCache::save(const QString& fileName, const QString& backend) const
+{
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_12);
+
+    {
+        QMutexLocker locker(&languageMutex);
+        out << kFileMagic << kFileVersion << backend
+            << QStringList(languageNames.begin(), languageNames.end());
+    }
+
+    // snapshot of every shard, least recently used first,
+    // so loading the entries back restores their order
+    std::vector<std::pair<Key, bool>> entries;
+    for (int i = 0; i < kShardCount; ++i)
+    {
+        QMutexLocker locker(&shardMutex[i]);
+        const Shard& shard = shards[i];
+        entries.reserve(entries.size() + shard.size());
+        for (auto it = shard.cend(); it != shard.cbegin(); )
+        {
+            --it;
+            entries.emplace_back(it->first, it->second);
+        }
+    }
+
+    out << quint32(entries.size());
+    for (const auto& [key, correct] : entries)
+        out << qint32(key.languages) << correct << key.word;
+
+    return out.status() == QDataStream::Ok && file.commit();
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+
+#include <array>
+#include <vector>
+
+#include <LRUCache> // from Qt5Extra aux
+
+//
+// QtSpellingCache keeps spelling verdicts, both correct and misspelled,
+// keyed by the language set and the word. It's shared by all spell
+// check workers, so it's split into shards, each one with its own
+// lock and LRU list. The cache can be saved to the file and loaded
+// back (the file is memory mapped), verdicts are valid only for the
+// backend they were saved with
+//
+class QtSpellingCache
+{
+    Q_DISABLE_COPY(QtSpellingCache)
+public:
+    enum Verdict
+    {
+        Unknown = -1,
+        Misspelled = 0,
+        Correct = 1
+    };
+
+    explicit QtSpellingCache(size_t capacity);
+
+    // returns id of the language set, regardless of the order of languages
+    int languageSet(const QStringList& languages);
+
+    Verdict lookup(int languages, const QString& word);
+    void insert(int languages, const QString& word, bool correct);
+
+    // forgets the word for every language set
+    void remove(const QString& word);
+    void clear();
+
+    bool load(const QString& fileName, const QString& backend);
+    bool save(const QString& fileName, const QString& backend) const;
+
+private:
+    static constexpr int kShardCount = 16;
+
+    struct Key
+    {
+        int languages;
+        QString word;
+
+        inline bool operator==(const Key& other) const
+        {
+            return languages == other.languages && word == other.word;
+        }
+    };
+
+    struct KeyHash
+    {
+        inline size_t operator()(const Key& key) const
+        {
+            return qHash(key.word, uint(key.languages));
+        }
+    };
+
+    using Shard = Qt5Extra::LRUCache<Key, bool, KeyHash>;
+
+    inline size_t shardOf(const Key& key) const { return KeyHash()(key) % kShardCount; }
+
+    std::array<Shard, kShardCount> shards;
+    mutable std::array<QMutex, kShardCount> shardMutex;
+
+    QHash<QString, int> languageIds;
+    std::vector<QString> languageNames;
+    mutable QMutex languageMutex;
+};
@@ -1,6 +1,142 @@
 #include "qtbasiclangdetector.h"
+#include "qttrigramprofiles.h"
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <numeric>
+
+namespace
+{
+    constexpr int kBuckets = 2048; // power of two
+    constexpr int kLanguageCount = int(std::size(kTrigramProfiles));
+    constexpr int kMaxResults = 3;
+    constexpr int kMaxLength = 16384; // chars of the text taken into account
+    constexpr int kMinTrigrams = 4;
+    constexpr double kRankRatio = 0.8; // languages scored close to the best one are reported as well
+
+    using Weights = std::array<quint8, kBuckets>;
+    using WeightTable = std::array<Weights, kLanguageCount>;
+
+    constexpr quint32 trigramBucket(char16_t a, char16_t b, char16_t c)
+    {
+        constexpr quint32 kPrime = 0x01000193;
+        quint32 h = a;
+        h = (h * kPrime) ^ b;
+        h = (h * kPrime) ^ c;
+        h ^= h >> 15;
+        h *= 0x2c1b3c6d;
+        h ^= h >> 12;
+        return h & (kBuckets - 1);
+    }
+
+    constexpr int trigramCount(const char16_t* trigrams)
+    {
+        int n = 0;
+        while (trigrams[n] != 0)
+            ++n;
+        return n / 3;
+    }
+
+    // weight of the trigram falls linearly with its rank in the profile
+    constexpr WeightTable buildWeights()
+    {
+        WeightTable table{};
+        for (int l = 0; l < kLanguageCount; ++l)
+        {
+            const char16_t* t = kTrigramProfiles[l].trigrams;
+            const int count = trigramCount(t);
+            for (int rank = 0; rank < count; ++rank, t += 3)
+            {
+                const quint32 bucket = trigramBucket(t[0], t[1], t[2]);
+                const int weight = 255 - (255 * rank) / count;
+                if (table[l][bucket] < weight)
+                    table[l][bucket] = quint8(weight);
+            }
+        }
+        return table;
+    }
+
+    constexpr WeightTable kWeights = buildWeights();
+
+    const QString& languageName(int index)
+    {
+        static const auto names = []()
+        {
+            std::array<QString, kLanguageCount> result;
+            for (int l = 0; l < kLanguageCount; ++l)
+                result[l] = QLocale(kTrigramProfiles[l].language).name();
+            return result;
+        }();
+        return names[index];
+    }
+}
+
 
 QStringList QtBasicLangDetector::identify(const QStringRef& text) const
 {
-    return {};
+    // there is a trigram per char at most, so the length limit keeps counts in 16 bits
+    std::array<quint16, kBuckets> histogram{};
+    int total = 0;
+
+    // words are lowercased and padded with spaces, like the profiles
+    const char16_t space = u' ';
+    char16_t prev2 = space, prev1 = space;
+    int wordLength = 0;
+    for (const QChar ch : text.left(kMaxLength))
+    {
+        if (ch.isLetter())
+        {
+            const char16_t c = ch.toLower().unicode();
+            if (wordLength > 0)
+            {
+                ++histogram[trigramBucket(prev2, prev1, c)];
+                ++total;
+            }
+            prev2 = prev1;
+            prev1 = c;
+            ++wordLength;
+        }
+        else if (wordLength > 0)
+        {
+            ++histogram[trigramBucket(prev2, prev1, space)];
+            ++total;
+            prev2 = prev1 = space;
+            wordLength = 0;
+        }
+    }
+
+    if (wordLength > 0)
+    {
+        ++histogram[trigramBucket(prev2, prev1, space)];
+        ++total;
+    }
+
+    if (total < kMinTrigrams)
+        return {};
+
+    // dense dot products over contiguous arrays, so compilers vectorize them
+    std::array<quint32, kLanguageCount> scores{};
+    for (int l = 0; l < kLanguageCount; ++l)
+    {
+        const Weights& weights = kWeights[l];
+        quint32 score = 0;
+        for (int b = 0; b < kBuckets; ++b)
+            score += quint32(int(histogram[b]) * int(weights[b]));
+        scores[l] = score;
+    }
+
+    std::array<int, kLanguageCount> order;
+    std::iota(order.begin(), order.end(), 0);
+    std::partial_sort(order.begin(), order.begin() + kMaxResults, order.end(),
+                      [&scores](int lhs, int rhs) { return scores[lhs] > scores[rhs]; });
+
+    const quint32 best = scores[order.front()];
+    if (best == 0)
+        return {};
+
+    QStringList languages;
+    for (int i = 0; i < kMaxResults && scores[order[i]] >= best * kRankRatio; ++i)
+        languages << languageName(order[i]);
+    return languages;
 }
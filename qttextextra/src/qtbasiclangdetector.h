@@ -1,6 +1,11 @@
 #pragma once
 #include "qtlanguagedetector.h"
 
+//
+// QtBasicLangDetector is the builtin detector, it doesn't need any
+// plugin. Trigrams of the text are compared with the embedded profiles
+// of common languages, the best matching languages come first
+//
 class QtBasicLangDetector
     : public QtLanguageDetector
 {
@@ -5,114 +5,56 @@
 #include <QTextFragment>
 
 #include <IndexRange>
-#include <AlgExt>
 
-namespace
+void QtTextTokenizer::scanDocument(QTextDocument* document,
+                                   const IndexRange& range,
+                                   const QtTokenFilter& filter,
+                                   FragmentCallback callback,
+                                   void* context)
 {
-    using StringIterator = QString::const_iterator;
-    using IterSpan = std::pair<StringIterator, StringIterator>;
-    using TokenHandler = QtTextTokenizer::TokenHandler;
-
-    enum class DelimiterCategory
-    {
-        GraphemeChar = 0, // a grapheme text char: not a delimiter at all
-        LineDelimiter, // CR/LF at most cases
-        WordDelimiter, // spaces at most cases
-        SegmentDelimiter, // space and punctuation at most cases
-    };
-
-    DelimiterCategory delimiterCategory(QChar ch) Q_DECL_NOTHROW
-    {
-        const bool isLineFeed = ch == QChar::LineFeed || ch == QChar::LineSeparator;
-        if (isLineFeed)
-            return DelimiterCategory::LineDelimiter;
-        if (ch.isSpace() || isLineFeed)
-            return DelimiterCategory::WordDelimiter;
-        if (!ch.isLetterOrNumber())
-            return DelimiterCategory::SegmentDelimiter;
-        return DelimiterCategory::GraphemeChar;
-    }
-
-    void scanSegment(const QString& text,
-                     int offset,
-                     const IterSpan& span,
-                     const QtTokenFilter& filter,
-                     TokenHandler& output)
-    {
-        const int pos = std::distance(text.cbegin(), span.first);
-        QStringView segment{ span.first, span.second };
-        if (filter.segmentAccepted(segment))
-            output(segment, offset + pos);
-    }
-
-    void scanWord(const QString& text,
-                  int offset,
-                  const IterSpan& span,
-                  const QtTokenFilter& filter,
-                  TokenHandler& output)
-    {
-        using Qt5Extra::filter_reduce;
-
-        if (!filter.wordAccepted(QStringView{ span.first, span.second }))
-            return;
-
-        filter_reduce(span.first, span.second,
-            [](QChar c) { return delimiterCategory(c) == DelimiterCategory::SegmentDelimiter; },
-            [offset, &text, &filter, &output](auto _first, auto _last) { scanSegment(text, offset, { _first, _last }, filter, output); });
-    }
-
-
-    void scanLine(const QString& text,
-                  int offset,
-                  const QtTokenFilter& filter,
-                  TokenHandler& output)
-    {
-        using Qt5Extra::filter_reduce;
-
-        if (!filter.lineAccepted(text))
-            return;
-
-        filter_reduce(std::cbegin(text), std::cend(text),
-            [](QChar _ch) { return delimiterCategory(_ch) == DelimiterCategory::WordDelimiter; },
-            [offset, &text, &filter, &output](auto _first, auto _last) { scanWord(text, offset, { _first, _last }, filter, output); });
-    }
+    if (!document || !filter.documentAccepted(*document))
+        return;
 
+    QTextBlock block = document->findBlock(range.offset);
+    QTextBlock lastBlock = document->findBlock(range.offset + range.length);
+    if (!lastBlock.isValid())
+        lastBlock = document->lastBlock();
 
-
-    void scanFragment(const QTextFragment& fragment,
-                      const IndexRange& range,
-                      const QtTokenFilter& filter,
-                      TokenHandler& output)
-    {
-        if (!filter.fragmentAccepted(fragment))
-            return;
-
-        IndexRange fragmentRange{ fragment.position(), fragment.length() };
-        if (range.intersects(fragmentRange))
-            scanLine(fragment.text(), fragmentRange.offset, filter, output);
-    }
-
-    void scanBlock(const QTextBlock& _block,
-                              const IndexRange& range,
-                              const QtTokenFilter& filter,
-                              TokenHandler& _output)
+    const int rangeEnd = range.offset + range.length;
+    for (; block.isValid(); block = block.next())
     {
-        if (!filter.blockAccepted(_block))
-            return;
+        if (filter.blockAccepted(block))
+        {
+            QString text; // fragments are views over the block text
+            const int blockPosition = block.position();
+            for (auto it = block.begin(); !(it.atEnd()); ++it)
+            {
+                const QTextFragment fragment = it.fragment();
+                if (!filter.fragmentAccepted(fragment))
+                    continue;
+
+                const int position = fragment.position();
+                if (position >= rangeEnd || position + fragment.length() <= range.offset)
+                    continue;
+
+                if (text.isNull())
+                    text = block.text();
+
+                callback(context, QStringView{ text }.mid(position - blockPosition, fragment.length()), position);
+            }
+        }
 
-        for (auto it = _block.begin(); !(it.atEnd()); ++it)
-            scanFragment(it.fragment(), range, filter, _output);
+        if (block == lastBlock)
+            break;
     }
-} // end anon namespace
-
+}
 
 QStringList QtTextTokenizer::operator()(QTextDocument* document,
                                         const IndexRange& range,
                                         const QtTokenFilter& filter)
 {
     QStringList result;
-    TokenHandler handler = [&result](QStringView _sv, int) { result.push_back(_sv.toString()); };
-    (*this)(document, range, filter, handler);
+    tokenize(document, range, filter, [&result](QStringView _sv, int) { result.push_back(_sv.toString()); });
     return result;
 }
 
@@ -132,27 +74,7 @@ QtTextTokenizer::TokenHandler& QtTextTokenizer::operator()(QTextDocument* docume
                                                            const QtTokenFilter& filter,
                                                            QtTextTokenizer::TokenHandler& output)
 {
-    if (document && filter.documentAccepted(*document))
-    {
-        QTextCursor cursor(document);
-
-        cursor.setPosition(range.offset);
-        QTextBlock currentBlock = cursor.block();
-
-        cursor.movePosition(QTextCursor::NextCharacter, QTextCursor::MoveAnchor, range.length);
-        const QTextBlock lastBlock = cursor.block();
-
-        if (!currentBlock.isValid() || !lastBlock.isValid())
-            return output;
-
-        for (; ; currentBlock = currentBlock.next())
-        {
-            scanBlock(currentBlock, range, filter, output);
-
-            if (currentBlock == lastBlock)
-                break;
-        }
-    }
+    tokenize(document, range, filter, output);
     return output;
 }
 
@@ -165,14 +87,13 @@ QtTextTokenizer::TokenHandler& QtTextTokenizer::operator()(const QString& text,
     if (text.isEmpty() || !IndexRange{ 0, text.size() }.contains(range))
         return output;
 
-    const QString txt = text.mid(range.offset, range.length);
     if (format == Qt::PlainText || (format == Qt::AutoText && !Qt::mightBeRichText(text)))
     {
-        scanLine(txt, range.offset, filter, output);
+        tokenize(QStringView{ text }.mid(range.offset, range.length), range.offset, filter, output);
         return output;
     }
 
     QTextDocument document;
-    document.setHtml(txt);
+    document.setHtml(text.mid(range.offset, range.length));
     return (*this)(&document, range, filter, output);
 }
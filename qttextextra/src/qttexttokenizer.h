@@ -1,17 +1,33 @@
 #pragma once
 #include <functional>
+#include <array>
 #include <QString>
 #include <QStringView>
 
 #include <QtTextExtra>
 
+#include "qttokenfilter.h"
+
 struct IndexRange;
 class QTextDocument;
-class QtTokenFilter;
 
+//
+// QtTextTokenizer splits the text into words and segments of words,
+// rejected ones are filtered out by QtTokenFilter. The tokenize()
+// templates don't copy the text: tokens are passed to the handler
+// as views over the source buffer, valid only during the call
+//
 class QTTEXTEXTRA_EXPORT QtTextTokenizer
 {
 public:
+    enum class Delimiter : quint8
+    {
+        None = 0, // a grapheme text char: not a delimiter at all
+        Line,     // CR/LF at most cases
+        Word,     // spaces at most cases
+        Segment   // punctuation at most cases
+    };
+
     class TokenHandler
     {
     public:
@@ -31,6 +47,15 @@ public:
         Handler handler;
     };
 
+    // calls handler(QStringView token, int offset) for every accepted token,
+    // offset is the position of the token in the text plus the given offset
+    template<class _Handler>
+    static void tokenize(QStringView text, int offset, const QtTokenFilter& filter, _Handler&& handler);
+
+    template<class _Handler>
+    static void tokenize(QTextDocument* document, const IndexRange& range, const QtTokenFilter& filter, _Handler&& handler);
+
+    static Delimiter delimiter(QChar ch) noexcept;
 
     TokenHandler& operator()(QTextDocument* document,
                              const IndexRange& range,
@@ -51,4 +76,111 @@ public:
                            const IndexRange& range,
                            const QtTokenFilter& filter,
                            Qt::TextFormat format = Qt::AutoText);
+
+private:
+    using FragmentCallback = void (*)(void* context, QStringView text, int offset);
+
+    // walks accepted fragments of the range, the text of every block is taken once
+    static void scanDocument(QTextDocument* document,
+                             const IndexRange& range,
+                             const QtTokenFilter& filter,
+                             FragmentCallback callback,
+                             void* context);
+
+    static constexpr std::array<Delimiter, 256> latin1Delimiters()
+    {
+        std::array<Delimiter, 256> table{};
+        for (int c = 0; c < 256; ++c)
+        {
+            const bool digit = (c >= '0' && c <= '9') || c == 0xb2 || c == 0xb3 || c == 0xb9 || (c >= 0xbc && c <= 0xbe);
+            const bool letter = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                                c == 0xaa || c == 0xb5 || c == 0xba ||
+                                (c >= 0xc0 && c != 0xd7 && c != 0xf7);
+            if (c == '\n')
+                table[c] = Delimiter::Line;
+            else if ((c >= 0x09 && c <= 0x0d) || c == ' ' || c == 0x85 || c == 0xa0)
+                table[c] = Delimiter::Word;
+            else if (!digit && !letter)
+                table[c] = Delimiter::Segment;
+        }
+        return table;
+    }
 };
+
+
+inline QtTextTokenizer::Delimiter QtTextTokenizer::delimiter(QChar ch) noexcept
+{
+    // Latin-1 is classified by the table, the rest
+    // of the BMP falls back to the Unicode properties
+    static constexpr std::array<Delimiter, 256> kLatin1Delimiters = latin1Delimiters();
+
+    const ushort u = ch.unicode();
+    if (u < 256)
+        return kLatin1Delimiters[u];
+    if (u == QChar::LineSeparator)
+        return Delimiter::Line;
+    if (ch.isSpace())
+        return Delimiter::Word;
+    if (!ch.isLetterOrNumber() && !ch.isMark())
+        return Delimiter::Segment;
+    return Delimiter::None;
+}
+
+template<class _Handler>
+void QtTextTokenizer::tokenize(QStringView text, int offset, const QtTokenFilter& filter, _Handler&& handler)
+{
+    if (text.isEmpty() || !filter.lineAccepted(text))
+        return;
+
+    auto isWordDelimiter = [](QChar ch)
+    {
+        const Delimiter d = delimiter(ch);
+        return d == Delimiter::Word || d == Delimiter::Line;
+    };
+    auto isSegmentDelimiter = [](QChar ch) { return delimiter(ch) == Delimiter::Segment; };
+
+    const QChar* const first = text.begin();
+    const QChar* const last = text.end();
+    for (const QChar* it = first; it != last; )
+    {
+        while (it != last && isWordDelimiter(*it))
+            ++it;
+
+        const QChar* wordBegin = it;
+        while (it != last && !isWordDelimiter(*it))
+            ++it;
+
+        if (wordBegin == it || !filter.wordAccepted(QStringView{ wordBegin, it }))
+            continue;
+
+        // words are split into segments by punctuation
+        for (const QChar* s = wordBegin; s != it; )
+        {
+            while (s != it && isSegmentDelimiter(*s))
+                ++s;
+
+            const QChar* segmentBegin = s;
+            while (s != it && !isSegmentDelimiter(*s))
+                ++s;
+
+            const QStringView segment{ segmentBegin, s };
+            if (!segment.isEmpty() && filter.segmentAccepted(segment))
+                handler(segment, offset + int(segmentBegin - first));
+        }
+    }
+}
+
+template<class _Handler>
+void QtTextTokenizer::tokenize(QTextDocument* document, const IndexRange& range, const QtTokenFilter& filter, _Handler&& handler)
+{
+    auto scanFragment = [&filter, &handler](QStringView text, int offset)
+    {
+        tokenize(text, offset, filter, handler);
+    };
+
+    using Scanner = decltype(scanFragment);
+    scanDocument(document, range, filter, [](void* context, QStringView text, int offset)
+    {
+        (*static_cast<Scanner*>(context))(text, offset);
+    }, &scanFragment);
+}
@@ -0,0 +1,376 @@
+#pragma once
+#include <QLocale>
+
+//
+// Trigram profiles of the builtin language detector: the most frequent
+// trigrams of every language, from the most frequent one. Words are
+// lowercased and padded with a space on both sides, so " th" is the
+// beginning of a word. The profiles were collected from translation
+// catalogs of free software, weights are derived from them at compile time
+//
+struct QtTrigramProfile
+{
+    QLocale::Language language;
+    const char16_t* trigrams;
+};
+
+static constexpr QtTrigramProfile kTrigramProfiles[] =
+{
+    { QLocale::English,
+      u"ed " u" th" u"ng " u"ing" u" in" u"the" u" re" u"le " u" co" u" to"
+      u" no" u"on " u"or " u"he " u"ile" u"to " u"ion" u"es " u"er " u"not"
+      u"ot " u" fi" u"tio" u"is " u" fo" u"for" u"fil" u"nd " u"ent" u"in "
+      u" pa" u"and" u"an " u" of" u"te " u" is" u"of " u" ma" u" se" u"ter"
+      u"se " u"ect" u" an" u"ate" u"re " u" ca" u" a " u"nt " u" pr" u"ati"
+      u" us" u" de" u"it " u"ge " u"al " u"st " u"th " u" ch" u" un" u" di"
+      u"rea" u"ted" u" st" u"con" u"ame" u"me " u" li" u"val" u" ex" u"com"
+      u"use" u"ry " u" be" u" ar" u" wi" u"ut " u"age" u"ali" u"id " u"ang"
+      u"nam" u"tin" u"ble" u"ver" u"ess" u"sta" u"can" u" na" u" op" u"ith"
+      u"res" u"as " u" al" u" su" u"rec" u"ail" u"en " u"ead" u" ke" u"lin"
+      u" on" u"all" u"wit" u"at " u"err" u"ch " u" do" u"et " u"tor" u" si"
+      u"out" u"abl" u"ire" u"ne " u"ve " u"ts " u"ly " u"ist" u" or" u"int"
+      u" lo" u"cha" u"ack" u"ort" u"ste" u"key" u"led" u"ce " u"ad " u" fa"
+      u"ine" u"cat" u"rin" u" so" u" me" u"ld " u"pec" u"ns " u" en" u"lid"
+      u"ll " u"mat" u" mo" u"ers" u" er" u"no " u"omm" u"han" u"pti" u"rro"
+      u"ror" u" gi" u"pro" u"man" u" ba" u"ign" u"nte" u"ica" u" va" u"be " },
+    { QLocale::German,
+      u"en " u"er " u"ich" u"sch" u"ein" u" de" u"der" u"cht" u"den" u"che"
+      u"ung" u"ht " u" be" u"te " u" ni" u"ie " u"nic" u"es " u" au" u"nde"
+      u"ver" u"ch " u" un" u" da" u" di" u"in " u" ei" u"die" u"ben" u"gen"
+      u" we" u"ert" u" ve" u"ier" u"ten" u"rde" u"on " u"ate" u"ist" u"zei"
+      u" in" u"nte" u"dat" u"ine" u" an" u"it " u" vo" u" ge" u"st " u"ng "
+      u"wer" u"ter" u"rt " u" si" u"ere" u"ers" u"tei" u" zu" u"end" u"nge"
+      u"ste" u"isc" u"eic" u"ren" u"ion" u"nen" u"ent" u"ehl" u"feh" u" ko"
+      u" er" u"aus" u"ige" u"ne " u"hen" u" fe" u" is" u"nd " u"sse" u" f\u00fc"
+      u"erd" u"eit" u"mit" u"chl" u"sie" u"tio" u"f\u00fcr" u"\u00fcr " u"und" u"ei "
+      u"auf" u"bei" u"ber" u"le " u" wi" u"ann" u"von" u" ke" u" pa" u"nn "
+      u" re" u"kan" u" mi" u"geb" u"ebe" u"tig" u"ell" u"sta" u"men" u"des"
+      u"kei" u"et " u" sc" u"ese" u"ges" u"hle" u"len" u"rei" u" ze" u"abe"
+      u"nnt" u"rte" u"kon" u"de " u"ang" u"sen" u"im " u" al" u"ern" u" st"
+      u" ka" u"and" u"wen" u"ge " u"lle" u"sel" u"erw" u"ler" u"rd " u"erz"
+      u"run" u"lti" u"hre" u" en" u"nis" u" se" u"he " u"rze" u"\u00fclt" u"lic"
+      u"g\u00fcl" u"her" u"wir" u"uf " u"lis" u"lte" u"ame" u"\u00fcss" u"ode" u"ind" },
+    { QLocale::French,
+      u" de" u"de " u"es " u"le " u"ion" u"er " u"on " u" le" u"tio" u"re "
+      u"ur " u"ent" u" co" u" pa" u"nt " u" la" u"ne " u" in" u"la " u"les"
+      u"ns " u"fic" u" un" u"que" u"our" u" no" u" d " u"ich" u"eur" u" l "
+      u"te " u"chi" u"ati" u"ier" u" po" u" en" u"ble" u"pas" u" re" u" fi"
+      u"as " u"men" u"ue " u" d\u00e9" u"est" u" es" u"con" u"lis" u"st " u"che"
+      u"res" u"des" u"tre" u"cti" u"un " u"hie" u"pou" u"ect" u"du " u"en "
+      u" su" u"dan" u" se" u"ans" u" r\u00e9" u"com" u" li" u"et " u"ssi" u" du"
+      u"ire" u"ant" u" da" u" \u00e0 " u"uti" u" ma" u"ibl" u"rs " u"ge " u" pr"
+      u"par" u" im" u"onn" u"\u00e9e " u" ch" u"pos" u"ts " u"ili" u"ess" u"til"
+      u"ons" u"eme" u" au" u"iqu" u"age" u"val" u"nte" u"ign" u"mpo" u"se "
+      u" so" u"une" u" ut" u"it " u" n " u"ist" u"imp" u"ter" u"ali" u"ver"
+      u"rre" u"ten" u"ont" u"ec " u"cha" u" ne" u"ise" u"and" u"sib" u"nom"
+      u"ce " u" op" u"omm" u"oss" u"ide" u" av" u"ers" u"ut " u"is " u"lle"
+      u"str" u" mo" u"sio" u"nde" u" ex" u"ifi" u"us " u"me " u"ser" u"ar "
+      u" ar" u" va" u" tr" u"ave" u" ou" u"ert" u"ort" u"non" u" pe" u"err"
+      u"tte" u"ntr" u" si" u"aut" u" qu" u" do" u" et" u"man" u"ran" u"ure" },
+    { QLocale::Spanish,
+      u" de" u"de " u"do " u" no" u" se" u"el " u" co" u"no " u"os " u"\u00f3n "
+      u"es " u" el" u"i\u00f3n" u" es" u" en" u" la" u"se " u"ar " u"la " u"ent"
+      u" re" u"con" u"ci\u00f3" u"en " u"ra " u"ado" u" in" u" pa" u" un" u"or "
+      u"as " u"te " u"to " u"est" u"par" u"da " u"ro " u"nte" u"al " u"ara"
+      u"fic" u"ica" u"aci" u"tra" u"ero" u"ta " u"com" u" pu" u"que" u"ido"
+      u" fi" u"str" u"des" u"un " u" ca" u"sta" u"er " u"era" u"ada" u"ion"
+      u"cio" u"per" u"na " u"men" u"rec" u" pr" u" di" u"cci" u" si" u" al"
+      u"ede" u" lo" u"ist" u"ida" u"lid" u"on " u" ar" u"ien" u"ndo" u"ntr"
+      u"res" u"che" u"esp" u"pue" u"nto" u"ued" u"and" u"del" u"lo " u"re "
+      u"los" u"nes" u" op" u"por" u"ect" u"ivo" u"rad" u" a " u"one" u"her"
+      u"ich" u"io " u"ter" u"cad" u" po" u"esc" u"arc" u"ue " u" qu" u"ont"
+      u"rio" u"ecc" u"den" u"ali" u"enc" u"car" u"ble" u"bre" u"ene" u"ten"
+      u"vo " u"una" u"mit" u"tro" u"dos" u"err" u"spe" u"pro" u" ha" u" ex"
+      u" so" u"\u00e1li" u" us" u"v\u00e1l" u" fa" u"dir" u"rch" u"omb" u"tos" u"nci"
+      u"ifi" u"mbr" u"rma" u"ma " u" ti" u"ori" u"nom" u"ina" u"chi" u"las"
+      u" va" u" er" u"hiv" u" y " u"ran" u"si\u00f3" u" ma" u"sec" u"ire" u"le " },
+    { QLocale::Italian,
+      u"to " u"le " u" di" u"re " u" co" u"ion" u" no" u"di " u"on " u"ne "
+      u" de" u"one" u"zio" u"ent" u"ile" u"non" u" in" u"ta " u"la " u"del"
+      u" ri" u"con" u"ato" u"il " u"ti " u" il" u"te " u"nte" u" fi" u"ell"
+      u"per" u"pos" u"sta" u" un" u"are" u"er " u"ica" u" pe" u"men" u"mpo"
+      u"fil" u"bil" u"ssi" u" se" u" im" u" es" u"azi" u"un " u"el " u"ess"
+      u"imp" u"ali" u" \u00e8 " u" la" u"chi" u"com" u"ibi" u"lo " u"ett" u"est"
+      u" st" u"lla" u" ne" u" re" u" pr" u" al" u"oss" u"no " u" da" u" so"
+      u"ere" u"sib" u"ore" u" l " u"tat" u"ll " u"in " u"che" u"so " u"ati"
+      u"nti" u"ni " u"do " u" ch" u" su" u"fic" u"na " u"ome" u"ifi" u"ro "
+      u"ten" u"ese" u"val" u"ter" u"ver" u"all" u"io " u"ra " u" va" u"me "
+      u"li " u" pa" u" le" u" si" u"oni" u"ata" u"ale" u" ma" u"ca " u"se "
+      u"seg" u"ina" u"tto" u"nto" u"att" u"tte" u"sci" u"err" u"and" u"ire"
+      u"ita" u" ca" u"tor" u"eri" u"cor" u"tro" u" i " u"cat" u"it " u"nel"
+      u" mo" u"ura" u"ma " u"ggi" u"ono" u" sc" u"sio" u"pre" u"ost" u"rat"
+      u" me" u" us" u"da " u"izz" u"ric" u"ran" u"ont" u" tr" u"str" u" qu"
+      u"he " u" op" u" er" u" a " u"rma" u"ito" u"ame" u"zza" u"agg" u"ndi" },
+    { QLocale::Portuguese,
+      u" de" u"de " u"\u00e3o " u"do " u" co" u"os " u" pa" u"da " u"ado" u"ra "
+      u"ar " u"\u00e7\u00e3o" u" se" u"ro " u" a " u"fic" u"as " u"ent" u" in" u"n\u00e3o"
+      u"es " u" n\u00e3" u"em " u" fi" u"com" u"par" u" re" u" o " u" es" u"eir"
+      u"ara" u"iro" u"che" u"nte" u"ich" u"con" u"te " u"er " u"to " u"hei"
+      u" no" u"or " u"ada" u" um" u"a\u00e7\u00e3" u"ica" u" do" u"tra" u"ta " u" po"
+      u" pr" u" ca" u"ido" u"sta" u" li" u"men" u"ter" u"est" u" fo" u"rad"
+      u"ont" u"um " u"ma " u"dos" u"el " u"pos" u"vel" u" da" u" en" u" em"
+      u"des" u"ver" u"ist" u"al " u" \u00e9 " u" im" u"que" u"\u00edve" u"mpo" u"por"
+      u"ntr" u"for" u" ex" u"res" u"ia " u"ome" u"imp" u"esp" u" ma" u"no "
+      u" te" u"ou " u"me " u" fa" u"iza" u" ta" u"liz" u"ida" u" di" u"nto"
+      u"cad" u"\u00f5es" u"eci" u"io " u"s\u00e3o" u"ess" u"oss" u"nom" u"man" u" e "
+      u"fin" u"ini" u" ar" u"om " u"ir " u"efi" u" qu" u"s\u00edv" u" su" u" op"
+      u"ss\u00ed" u"pre" u"spe" u"era" u" ve" u"err" u"esc" u"po " u"and" u"ura"
+      u" ou" u"lid" u"def" u"alh" u"so " u"\u00e7\u00f5e" u"pro" u"ha " u" us" u"ina"
+      u" ao" u" er" u"tad" u"rma" u"ifi" u" al" u" mo" u"ao " u"rro" u"ser"
+      u" si" u"per" u"dad" u"ali" u"ndo" u"se " u"orm" u"lo " u"uma" u"lin" },
+    { QLocale::Dutch,
+      u"en " u"et " u"de " u"an " u" ge" u" de" u"sta" u"and" u"ver" u" be"
+      u"een" u" va" u"van" u" in" u"nie" u" ni" u"est" u" op" u"nde" u" ve"
+      u"er " u"tan" u" he" u"iet" u"is " u"bes" u"aar" u" is" u"oor" u"ken"
+      u"ie " u"ing" u"ere" u"tie" u"sch" u"den" u"te " u" ee" u"ege" u" on"
+      u" vo" u"nd " u"aan" u"het" u"gel" u"der" u" al" u"ren" u"rde" u"nge"
+      u" te" u"gen" u"ord" u"in " u"or " u"ten" u"uit" u"ste" u"erd" u"rd "
+      u" ma" u"voo" u"eer" u"geb" u" me" u"ers" u"ng " u"naa" u"eld" u" to"
+      u" re" u"ls " u"cht" u"gev" u" wo" u"eke" u"rui" u"ar " u"wor" u" ka"
+      u"ebr" u"ent" u"ven" u"lle" u"dig" u" st" u"eve" u"el " u" en" u"men"
+      u"len" u"bru" u"uik" u"kan" u"met" u" aa" u"al " u"gee" u"ter" u"ati"
+      u" na" u" ui" u"voe" u" pa" u"es " u" wa" u"ard" u"ige" u"st " u"ond"
+      u" co" u"als" u"eli" u"ach" u"lij" u"ge " u"tal" u" bi" u"kt " u"waa"
+      u" di" u"end" u"nen" u"opt" u"ele" u"oer" u"at " u"erw" u"ns " u" of"
+      u"it " u" ar" u" do" u"tek" u"of " u"ong" u"pti" u"ijd" u"ldi" u"kke"
+      u"reg" u"all" u"isc" u"le " u"ens" u"dt " u"am " u"nt " u"taa" u"pro"
+      u"ind" u" pr" u"op " u"wij" u"pak" u"one" u"ont" u"out" u"aam" u"tel" },
+    { QLocale::Swedish,
+      u" in" u"en " u"er " u"nte" u"f\u00f6r" u"ing" u" f\u00f6" u"te " u"int" u"era"
+      u"\u00f6r " u"ter" u"et " u"ar " u"de " u" an" u"ra " u"tt " u" st" u"nde"
+      u"\u00e4nd" u"ng " u"ill" u" de" u"ll " u"nin" u"an " u" ti" u"ler" u"ta "
+      u"til" u"v\u00e4n" u" en" u" me" u"ion" u"and" u"\u00e4r " u"ade" u"fil" u"om "
+      u" i " u" ko" u" av" u"sta" u"ver" u" fi" u" ka" u"lle" u"med" u" \u00e4r"
+      u"att" u"tio" u"kti" u"nda" u" sk" u"anv" u"nv\u00e4" u" ut" u" re" u" at"
+      u"rad" u"ste" u"gen" u"tig" u"ed " u"av " u"rin" u"ell" u"kan" u"ska"
+      u"yck" u"var" u"nge" u"on " u"den" u"ad " u"fel" u" so" u" vi" u"nd "
+      u"tal" u"eri" u" va" u"som" u" fe" u"ata" u"tan" u"es " u"ist" u" om"
+      u"kom" u" p\u00e5" u"des" u"ig " u"el " u"as " u"ett" u"ent" u"der" u" l\u00e4"
+      u"nam" u"und" u"na " u"p\u00e5 " u"ka " u"at " u"ch " u"nt " u"det" u"mma"
+      u"cke" u"lti" u"ekt" u" oc" u"amn" u"ati" u"ort" u"men" u"gt " u"ga "
+      u" el" u"ilt" u"nga" u"och" u" ar" u"ngs" u"ara" u"lag" u"ser" u"all"
+      u"tta" u"nta" u"nst" u" mi" u"ile" u"igt" u" se" u"str" u"isk" u" ta"
+      u"gil" u"akt" u"dat" u" fl" u"mat" u" sa" u"skr" u" et" u"cka" u"ers"
+      u"la " u"kat" u"rt " u"kri" u" ha" u"st " u"inn" u"upp" u"agg" u"re " },
+    { QLocale::Danish,
+      u"er " u"en " u"et " u"kke" u"ke " u"for" u"ikk" u" fo" u" ik" u"til"
+      u"ere" u"ing" u"nde" u" ti" u" de" u"il " u"ter" u"de " u" in" u"or "
+      u"der" u" af" u"ler" u" er" u"fil" u"lle" u"ed " u" me" u" fi" u"es "
+      u"re " u"ver" u"ind" u"ne " u" en" u" ka" u"ng " u" st" u"end" u" i "
+      u"den" u" ud" u"sk " u"af " u"te " u"sta" u"and" u"ste" u" ko" u"ret"
+      u"an " u"ger" u"ive" u"tte" u"nge" u"ent" u"bru" u" br" u"rug" u"at "
+      u"kan" u"nte" u"med" u"gen" u"og " u"ede" u"ang" u"se " u"ion" u"els"
+      u"dig" u"und" u"ers" u"tal" u"skr" u"om " u" sk" u" ve" u"det" u"al "
+      u" re" u"ell" u"lig" u"lse" u"mme" u" so" u"nin" u"men" u"le " u"isk"
+      u" an" u"rin" u"kri" u" at" u"ig " u"lin" u"nne" u"eri" u"ejl" u"fej"
+      u"ker" u" fe" u" op" u" og" u" un" u"del" u"ata" u"yld" u"kun" u"ati"
+      u" ku" u" el" u"ldi" u"som" u"tio" u"gyl" u" ma" u"el " u"gt " u"ken"
+      u"nav" u"avn" u" li" u" p\u00e5" u"ern" u" ad" u"gle" u"on " u"kom" u"tet"
+      u"ge " u"dat" u"p\u00e5 " u"rer" u"uge" u"ren" u"ile" u"pro" u" vi" u"v\u00e6r"
+      u"giv" u"str" u"jl " u" sy" u"ndt" u" ug" u"vis" u" pa" u" et" u" fr"
+      u"ngs" u"all" u"ven" u"ugy" u"eks" u"dt " u"riv" u" pr" u"kal" u"ved" },
+    { QLocale::NorwegianBokmal,
+      u"er " u"kke" u"en " u"ke " u"et " u"ikk" u"for" u"il " u" ik" u"ing"
+      u"te " u" fo" u" er" u"til" u"or " u"ter" u" ti" u"ler" u" av" u" en"
+      u"fil" u" in" u"re " u" fi" u" me" u"ng " u"lle" u" st" u" de" u"bru"
+      u"ver" u"ruk" u" br" u"av " u"tte" u" ut" u"ent" u"ed " u"rte" u" i "
+      u"om " u"ig " u" ko" u"de " u"es " u" va" u"alg" u"val" u"ere" u" ve"
+      u"ste" u" sk" u" \u00e5 " u"ett" u"opp" u"all" u" so" u"ell" u"sta" u"dig"
+      u"nde" u"and" u"ert" u"end" u" op" u"inn" u"art" u"nge" u"nne" u"tt "
+      u"ne " u"ker" u"som" u"der" u"med" u"lar" u"ldi" u" kl" u"kla" u"og "
+      u" og" u"skr" u" p\u00e5" u"nte" u"rt " u"den" u"eil" u"lin" u"fei" u" si"
+      u"p\u00e5 " u"men" u"vis" u"rer" u"det" u" fe" u"ll " u"yld" u"gyl" u"tal"
+      u"avn" u"kri" u" ma" u" et" u" el" u"uke" u"nav" u"mme" u"rin" u"ser"
+      u"is " u"kel" u"dat" u"gen" u" se" u" li" u"el " u" le" u"sjo" u"n\u00f8k"
+      u"jon" u"se " u" re" u"tet" u"ppe" u" ug" u"nt " u"ugy" u"var" u" ka"
+      u"le " u"ata" u" hv" u"ger" u"len" u" n\u00f8" u"man" u"kom" u"vn " u" pa"
+      u"kan" u"an " u"riv" u" vi" u"\u00f8kk" u"ge " u" du" u" pr" u"lde" u"dre"
+      u"ren" u"ar " u"gt " u"utt" u"ign" u"ner" u"jen" u"ist" u"uk " u"und" },
+    { QLocale::Finnish,
+      u"en " u"ist" u"on " u"ta " u"nen" u"ine" u" ei" u"ei " u"ett" u" va"
+      u"in " u"ell" u"sto" u"ost" u"le " u" k\u00e4" u" ko" u"oit" u"tet" u" vi"
+      u"lli" u"tie" u"an " u"lin" u"sta" u"\u00e4yt" u"sa " u" tu" u"ssa" u"vir"
+      u" ol" u"edo" u" ta" u"ied" u"dos" u"rhe" u"t\u00e4 " u"irh" u"ole" u"tta"
+      u" ti" u"lle" u" on" u"k\u00e4y" u"ttu" u"itt" u" si" u"ste" u"een" u"eel"
+      u"ain" u"taa" u"tu " u"ton" u"ite" u"tee" u"itu" u"tus" u"ja " u"us "
+      u"lit" u"ali" u"ise" u"tel" u"aa " u"tt\u00e4" u" li" u"val" u"ava" u"nni"
+      u"hee" u"aan" u"nis" u"lla" u"tti" u"tte" u"tun" u"la " u" lu" u"ia "
+      u"mis" u"mat" u"men" u"ent" u"to " u" ar" u" sy" u"stu" u"rit" u"ksi"
+      u"mer" u"lis" u"ess" u"ytt" u"koh" u" sa" u"sti" u"hte" u"et " u"all"
+      u"t\u00e4\u00e4" u" mu" u"ime" u" lo" u"vai" u"m\u00e4\u00e4" u"sen" u"kis" u"imi" u"\u00e4n "
+      u"\u00e4\u00e4r" u"voi" u"ato" u" pa" u"si " u"set" u" vo" u"ala" u"\u00e4\u00e4 " u"utt"
+      u"nim" u"enn" u"its" u"lai" u"\u00e4\u00e4n" u"oli" u"joi" u"is\u00e4" u"eri" u"sym"
+      u" ku" u"eta" u"tav" u"kki" u"oso" u" ja" u" ka" u"ita" u"luk" u"oll"
+      u"soi" u"tai" u" la" u" su" u"ois" u"min" u"bol" u"mbo" u"tii" u"ymb"
+      u"tsi" u"l\u00e4 " u"ill" u" as" u"oht" u"ivi" u"iin" u"onn" u"k\u00e4s" u"ote" },
+    { QLocale::Polish,
+      u"nie" u"ie " u" ni" u" po" u"ani" u"na " u" pr" u" wy" u"ia " u" za"
+      u" na" u"nia" u"wan" u" do" u"eni" u"owa" u"sta" u"lik" u"ki " u"ny "
+      u" je" u"ch " u"pli" u" pl" u"rze" u"go " u"prz" u"ne " u"ego" u" mo"
+      u"\u00f3w " u"mo\u017c" u"est" u" w " u"st " u"\u015bci" u"pod" u"ych" u"pis" u" ko"
+      u"jes" u"wie" u"any" u"awi" u"ski" u"ji " u"\u017cna" u"o\u017cn" u"zna" u"ej "
+      u"ku " u"do " u"a\u0107 " u"rzy" u" od" u"raw" u"ost" u" li" u"u\u017cy" u"cze"
+      u"ane" u" z " u" st" u"ika" u" op" u"dan" u"czy" u" u\u017c" u"cza" u"cji"
+      u"pra" u"nyc" u"ien" u"owy" u"ier" u"ka " u"je " u" si" u"cie" u"wy "
+      u"la " u" b\u0142" u" pa" u" us" u"ent" u"kie" u"iku" u"i\u0119 " u"kat" u"wa "
+      u"si\u0119" u"no " u"tu " u"kon" u"zen" u"ja " u"pro" u" ka" u" ro" u"nik"
+      u"owe" u" in" u" re" u" i " u"czn" u" ma" u"naz" u"azw" u"kow" u"ik "
+      u"em " u"y\u0107 " u"oda" u"cja" u"za " u"neg" u"acj" u" se" u"zmi" u" zn"
+      u" ty" u"owi" u"ami" u"zy " u"pow" u"mie" u"ci " u"bra" u" kl" u"dzi"
+      u"ale" u"era" u"mia" u"ym " u"pcj" u"opc" u" ar" u" ob" u"ywa" u"d\u0142o"
+      u"tal" u"icz" u"war" u"su " u"zyt" u" wi" u"tan" u"ko " u"ak " u"ucz"
+      u"luc" u"ole" u" cz" u"bie" u"men" u"dni" u"klu" u"alo" u"zas" u"ty " },
+    { QLocale::Czech,
+      u" ne" u"n\u00ed " u" po" u" p\u0159" u" pr" u"je " u"sou" u" na" u" so" u"pro"
+      u" se" u"na " u"oub" u"en\u00ed" u"bor" u"ubo" u" je" u" vy" u"sta" u"p\u0159e"
+      u"ov\u00e1" u"ze " u"v\u00e1n" u" za" u"n\u00fd " u"n\u00e9 " u"ova" u"se " u" ch" u"\u00e1n\u00ed"
+      u"at " u"rov" u"chy" u" od" u"uje" u"hyb" u"ch " u" do" u"or " u"vat"
+      u"ce " u"pou" u"it " u"ro " u"k\u00e9 " u"p\u0159i" u"zna" u"ho " u"u\u017ei" u"ou "
+      u"ost" u"pod" u" st" u"no " u"neb" u" kl" u"lze" u"p\u0159\u00ed" u" v " u"lo "
+      u"kon" u"nel" u" ko" u"ru " u"elz" u"stu" u"oru" u"ent" u" n\u00e1" u" a "
+      u"l\u00ed\u010d" u" ve" u"lat" u"n\u00e1 " u"ou\u017e" u"ky " u"c\u00ed " u"nep" u"res" u" v\u00fd"
+      u"te " u"to " u"ba " u"men" u" ba" u"kl\u00ed" u"kaz" u"nen" u"em " u"le "
+      u"na\u010d" u"sk\u00e9" u"atn" u"en " u"ast" u"\u00fdch" u"tel" u"tav" u" ad" u"ku "
+      u"pla" u"ebo" u"ov\u00fd" u"adr" u" zn" u"ka " u" ar" u"tup" u" s " u"dre"
+      u"ny " u"bo " u"slo" u"odp" u"yba" u" ob" u"ate" u"\u0159ep" u"pis" u"vyp"
+      u" ja" u"zen" u"vol" u"\u0159i " u" re" u"tu " u" ro" u"\u00e9ho" u"\u00edna" u"str"
+      u"byl" u"p\u00edn" u" z\u00e1" u" sp" u"ov\u00e9" u"nov" u"pr\u00e1" u"ep\u00ed" u"dno" u"van"
+      u"nak" u"lov" u"hod" u"v\u00fd " u"\u0159en" u"ek " u"bal" u"ter" u"t\u00ed " u"\u010de "
+      u"odn" u" in" u"ako" u"ick" u"\u00edm " u"sti" u"\u0159\u00e1d" u"nam" u"ko " u"m\u011bn" },
+    { QLocale::Slovak,
+      u" pr" u"ie " u" po" u" ne" u"je " u"nie" u" na" u"ova" u"n\u00fd " u" s\u00fa"
+      u"n\u00e9 " u" je" u"na " u"pre" u" sa" u"s\u00fab" u"sa " u"bor" u"\u00fabo" u"van"
+      u"ov " u"i\u0165 " u" vy" u"a\u0165 " u" ni" u"ia " u"eni" u"rov" u"ba " u"pri"
+      u" ch" u"men" u"lo " u"or " u"uje" u"sta" u"nep" u" za" u"n\u00e1 " u"ka "
+      u"re " u"pod" u"kon" u" n\u00e1" u" v " u" od" u" do" u"zna" u"ani" u"ho "
+      u"chy" u"hyb" u" ak" u" re" u"pou" u"ou\u017e" u"o\u017en" u"ky " u"te " u"ost"
+      u" al" u"ch " u" ko" u"ver" u"stu" u"ent" u" mo" u"res" u" ba" u" zo"
+      u"\u00e1ci" u"bol" u"iad" u"mo\u017e" u"an\u00fd" u" in" u" sp" u"oru" u"ne " u" ve"
+      u"ru " u"om " u"ale" u"ebo" u"pr\u00ed" u"str" u" ob" u"ast" u"lat" u"zov"
+      u"sti" u"atn" u"kaz" u"pla" u"cie" u"to " u"va\u0165" u" st" u" sy" u"tor"
+      u"tav" u"ina" u"n\u00e1z" u"ri " u"yba" u"\u00e9ho" u" se" u" vo" u"en\u00fd" u"pro"
+      u"\u017en\u00e9" u"ko " u"nam" u"den" u" ad" u"tov" u"bal" u" a " u" sk" u"an\u00e9"
+      u"\u00e1zo" u"adr" u"odp" u"\u00e1va" u"\u00edka" u" z\u00e1" u"n\u00ed " u"tup" u"epo" u"alo"
+      u"hod" u"al\u00ed" u" ar" u"te\u013e" u"l\u00edk" u"nen" u"ako" u"dre" u" ho" u" v\u00fd"
+      u"oro" u"ist" u"tvo" u"u\u017ei" u"\u00fdch" u"nov" u" \u010d\u00ed" u"bo " u"slo" u"leb"
+      u"odn" u"ta " u"raz" u"dno" u"for" u"orm" u"epl" u"dar" u"ate" u"nas" },
+    { QLocale::Russian,
+      u" \u043d\u0435" u"\u0442\u044c " u"\u0435\u043d\u0438" u" \u043f\u043e" u" \u043f\u0440" u"\u043d\u0435 " u"\u0438\u0435 " u"\u043d\u0438\u0435" u"\u043f\u043e\u043b" u"\u0438\u044f "
+      u" \u0432 " u"\u0430\u0442\u044c" u" \u0437\u0430" u"\u044b\u0439 " u" \u043a\u043e" u"\u043e\u0432\u0430" u"\u043e\u043b\u044c" u"\u0441\u044f " u" \u0440\u0430" u"\u043b\u044f "
+      u"\u043d\u043e " u"\u043c\u0435\u043d" u"\u043a\u0430 " u"\u0441\u0442\u0440" u"\u0435\u0442 " u" \u0434\u043b" u"\u0430\u0439\u043b" u" \u0444\u0430" u"\u0444\u0430\u0439" u"\u043d\u0438\u044f"
+      u" \u0432\u044b" u"\u0442\u0441\u044f" u"\u043d\u044b\u0439" u"\u043f\u0435\u0440" u" \u0441\u043e" u"\u0430\u044f " u"\u0438\u0442\u044c" u" \u043d\u0430" u"\u043f\u0440\u043e" u"\u0434\u043b\u044f"
+      u"\u0430\u043d\u0438" u"\u0440\u0430\u0437" u"\u0432\u0430\u0442" u"\u0435\u0442\u0441" u"\u0440\u043e\u0432" u"\u0433\u043e " u"\u043d\u0430 " u"\u043f\u0440\u0435" u"\u0432\u0435\u0440" u"\u043d\u043d\u044b"
+      u"\u043e\u0439 " u"\u043b\u044c\u0437" u" \u043f\u0430" u" \u0438\u0441" u" \u043e\u0431" u"\u0430\u043b\u043e" u" \u043f\u0435" u"\u0441\u043f\u043e" u"\u0435\u0440\u0435" u"\u043e\u0432 "
+      u" \u0434\u043e" u"\u0443\u0434\u0430" u"\u0434\u0430\u043b" u" \u043e\u0442" u"\u0438\u0438 " u" \u0441\u0438" u" \u0443\u0434" u"\u043b\u044c\u043d" u"\u0441\u0442\u0430" u"\u0438\u0439 "
+      u"\u0440\u0435\u0434" u"\u043e\u0441\u0442" u"\u0430\u043d\u043d" u"\u0434\u0435\u043b" u"\u043e\u0433\u043e" u"\u043a\u0438 " u"\u0435\u0441\u0442" u"\u0442\u0440\u043e" u"\u043a\u043e\u043c" u" \u0440\u0435"
+      u"\u043e\u043c " u"\u0441\u0442\u0432" u" \u043a\u0430" u"\u0441\u044c " u"\u0432\u0430\u043d" u"\u044b\u0435 " u"\u043b\u0438 " u"\u043e\u0435 " u"\u0438\u0441\u043f" u" \u0441\u0442"
+      u"\u0430\u0435\u0442" u"\u0437\u043e\u0432" u"\u043d\u043e\u0432" u"\u043b\u0430 " u"\u0435\u043d\u0442" u"\u0443\u0441\u0442" u"\u0447\u0435\u043d" u"\u0441\u0442\u0438" u"\u043f\u043e\u0434" u" \u0441 "
+      u"\u043f\u0440\u0438" u" \u0438\u0437" u"\u043b\u0435\u043d" u"\u043f\u0438\u0441" u" \u0438\u043d" u"\u0441\u043a\u0430" u"\u0441\u0438\u043c" u"\u0443\u0435\u0442" u"\u0434\u0430\u043d" u"\u044b\u0445 "
+      u"\u0435\u043c\u0435" u"\u043c\u0435\u0442" u"\u0438\u0440\u043e" u"\u0442\u0435\u043b" u"\u0435\u043b\u044c" u"\u0435\u043d\u043d" u"\u0442\u0430 " u"\u043d\u0430\u0447" u"\u0438\u0441\u0442" u" \u0438\u043c"
+      u"\u043b\u043e\u0432" u"\u043e\u0441\u044c" u"\u043a\u043b\u044e" u"\u043b\u044e\u0447" u"\u0435\u0440\u0430" u" \u0438 " u"\u043b\u043e\u0441" u"\u0437\u043d\u0430" u"\u043d\u0435\u0432" u"\u044c\u0437\u043e"
+      u"\u0435\u043a\u0442" u"\u0440\u0430\u043c" u"\u0438\u0442\u0435" u"\u0432\u043e\u043b" u"\u043a\u0430\u0437" u"\u0442\u043e\u0440" u"\u043a\u0430\u0442" u"\u0440\u0430\u0432" u"\u0436\u0435\u043d" u"\u043e\u0448\u0438"
+      u"\u0442\u0435 " u"\u0434\u0435\u0440" u"\u0438\u0432\u0430" u"\u0438\u043c\u0432" u"\u043c\u043e\u0436" u"\u043d\u044b\u0435" u"\u0448\u0438\u0431" u" \u043e\u0448" u" \u043e\u043f" u"\u043c\u0432\u043e"
+      u"\u0430\u043c\u0435" u"\u0449\u0435\u043d" u"\u0437\u0430\u043f" u"\u0430\u043d\u0434" u"\u043f\u0430\u0440" u"\u0442\u0430\u043d" u"\u0435\u0440\u0436" u"\u0438\u0431\u043a" u"\u043d\u0435\u043d" u"\u0440\u0435\u043c" },
+    { QLocale::Ukrainian,
+      u" \u043d\u0435" u"\u0442\u0438 " u"\u043d\u044f " u"\u043d\u043d\u044f" u" \u043f\u043e" u" \u0432\u0438" u"\u043d\u0435 " u"\u043a\u0430 " u" \u0437\u0430" u"\u0443\u0432\u0430"
+      u"\u0438\u0439 " u"\u0435\u043d\u043d" u" \u043f\u0440" u"\u043d\u043e " u"\u0430\u043d\u043d" u"\u043f\u0435\u0440" u"\u0430\u0442\u0438" u"\u0432\u0430\u043d" u"\u043d\u0430 " u"\u0435\u0440\u0435"
+      u"\u043a\u043e\u0440" u" \u043a\u043e" u" \u043d\u0430" u"\u0456\u0432 " u" \u0434\u043e" u" \u0440\u043e" u"\u0441\u044f " u"\u0432\u0456\u0434" u" \u0443 " u"\u043e\u0440\u0438"
+      u"\u0437\u043d\u0430" u"\u0440\u043e\u0437" u"\u043b\u044f " u"\u0438\u0441\u0442" u"\u043d\u0438\u0439" u" \u043f\u0435" u"\u043e\u0433\u043e" u"\u0430\u043d\u043e" u"\u0441\u0442\u0430" u"\u043f\u0440\u043e"
+      u"\u0433\u043e " u" \u0444\u0430" u"\u0430\u0439\u043b" u"\u0444\u0430\u0439" u"\u0432\u0438\u043a" u"\u043d\u0456 " u"\u0440\u0438\u0441" u"\u0447\u0435\u043d" u"\u0438\u0442\u0438" u" \u043f\u0456"
+      u"\u0430\u043b\u043e" u"\u0434\u043b\u044f" u" \u0434\u043b" u"\u0442\u0430\u043d" u"\u0438\u043a\u043e" u"\u044c\u043a\u0430" u"\u0441\u044c\u043a" u"\u0438\u0445 " u"\u0456\u0441\u0442" u"\u0435\u043d\u043e"
+      u"\u0430\u0447\u0435" u"\u043d\u0430\u0447" u"\u043e\u043c\u0438" u" \u043f\u0430" u"\u043f\u043e\u043c" u" \u043c\u0430" u"\u0432\u0430\u0442" u" \u0441\u0438" u" \u0441\u0442" u" \u0432\u0456"
+      u"\u043f\u043e\u0432" u"\u043c\u0438\u043b" u"\u0441\u0442\u0440" u"\u0442\u044c " u" \u043c\u043e" u"\u0438\u043b\u043a" u"\u043f\u0438\u0441" u"\u043d\u0438\u0445" u"\u043e\u0440\u0435" u" \u0437 "
+      u"\u0442\u0440\u0438" u" \u0440\u0435" u"\u043f\u0456\u0434" u"\u043e\u0432\u0438" u"\u0434\u043e " u"\u0440\u0430\u043c" u"\u0435\u043a\u0442" u"\u043a\u0438 " u"\u043f\u0440\u0438" u" \u0431\u0443"
+      u"\u0432\u0434\u0430" u"\u043c\u0438 " u"\u0430\u0440\u0430" u"\u0434\u0430\u043b" u"\u0430\u043d\u0438" u"\u0434\u0430\u043d" u"\u0435\u043d\u0442" u" \u043e\u0431" u"\u043a\u0430\u0437" u"\u043b\u044c\u043d"
+      u" \u0434\u0430" u"\u0441\u0442\u0438" u"\u0440\u0435\u043a" u" \u0437\u043d" u"\u0441\u0438\u043c" u"\u0432\u043e\u043b" u"\u043b\u043e\u0441" u"\u043f\u0430\u0440" u"\u0440\u0435\u0434" u"\u0434\u0456\u043b"
+      u"\u043e\u0441\u044f" u" \u044f\u043a" u"\u0430\u043d\u0434" u"\u043a\u043e\u043c" u"\u0430\u0454 " u" \u0442\u0430" u" \u0432\u0434" u"\u0438\u043c " u"\u043e\u0441\u0442" u"\u043e\u043f\u0435"
+      u"\u0440\u0435\u0441" u"\u043e\u0432\u0430" u" \u0432\u043a" u"\u0437\u0434\u0456" u"\u043e\u0437\u0434" u"\u0438\u043c\u0432" u"\u0432\u043a\u0430" u"\u043c\u0432\u043e" u"\u0441\u0442\u043e" u" \u0456\u043d"
+      u" \u043a\u0430" u"\u043d\u043e\u0432" u"\u0432\u0435\u0440" u"\u0456\u0457 " u"\u043e\u043c " u"\u043c\u043e\u0436" u"\u043b\u0435\u043d" u"\u043a\u0442\u043d" u"\u043d\u043e\u0433" u"\u0430\u0437\u0430"
+      u"\u0437\u043c\u0456" u"\u043a\u0443 " u"\u043b\u0430 " u"\u043a\u0430\u0442" u"\u0434\u0435\u043d" u" \u0441\u043f" u"\u0432\u0430 " u"\u0430\u043c\u0435" u"\u0436\u0435\u043d" u"\u043c\u0435\u0442"
+      u"\u0437\u0430\u043f" u"\u0435\u043a\u043e" u"\u0442\u043e\u0432" u" \u0442\u0438" u"\u043b\u043a\u0430" u"\u0440\u0438\u043c" u"\u0437\u0430\u043d" u"\u043e\u0432\u0456" u"\u043c\u0435\u043d" u"\u0456\u0434 " },
+    { QLocale::Bulgarian,
+      u"\u043d\u0430 " u" \u043d\u0430" u"\u043d\u0435 " u" \u0437\u0430" u" \u043f\u0440" u"\u0430\u043d\u0435" u" \u043d\u0435" u"\u0442\u0430 " u" \u0438\u0437" u" \u043f\u043e"
+      u"\u0442\u043e " u"\u0432\u0430\u043d" u"\u0442\u0435 " u"\u0437\u0430 " u"\u0434\u0430 " u" \u0434\u0430" u"\u0438\u0442\u0435" u"\u043a\u0430 " u"\u0438\u044f " u" \u043e\u0442"
+      u"\u043d\u043e " u"\u0432\u0430 " u" \u0441\u0435" u" \u0435 " u"\u0430\u0442\u0430" u"\u0441\u0435 " u" \u043a\u043e" u"\u043f\u0440\u0435" u"\u0435\u043d " u" \u0444\u0430"
+      u"\u0435\u043d\u0438" u"\u0430\u0439\u043b" u"\u0444\u0430\u0439" u"\u0440\u0430\u043d" u" \u0441\u044a" u"\u043f\u0440\u043e" u" \u043c\u043e" u"\u043d\u0438 " u"\u0440\u0435\u0434" u"\u043c\u0435\u043d"
+      u"\u043e\u0436\u0435" u"\u0438\u0440\u0430" u"\u043c\u043e\u0436" u" \u0432 " u"\u0435\u0442\u043e" u"\u0440\u0430\u0437" u" \u0441 " u"\u043f\u0440\u0438" u"\u043e\u0442 " u"\u043f\u043e\u0434"
+      u"\u043e\u0432\u0435" u"\u0430\u0432\u0430" u"\u0438\u044f\u0442" u"\u0436\u0435 " u"\u0434\u0435\u043d" u"\u0446\u0438\u044f" u" \u043e\u043f" u"\u043d\u0438\u044f" u" \u0440\u0435" u"\u043e\u0441\u0442"
+      u" \u0440\u0430" u"\u0430\u043d\u0438" u"\u043d\u0438\u0435" u" \u0441\u0442" u"\u043f\u0440\u0430" u" \u043e\u0431" u"\u0440\u0438 " u"\u0441\u0442\u0430" u"\u0441\u043a\u0430" u"\u043a\u0438 "
+      u"\u0430\u043d\u0434" u" \u0438 " u"\u0438\u0435 " u"\u0430\u0442 " u"\u043a\u0430\u0442" u"\u043b\u0438 " u"\u043f\u043e\u043b" u" \u0438\u043c" u"\u0430\u0432\u0438" u"\u0438\u0437\u0432"
+      u"\u044a\u0442 " u" \u0434\u043e" u"\u0435\u043a\u0442" u"\u0435\u0436\u0434" u"\u0438\u043c\u0435" u"\u0437\u0432\u0430" u"\u043e\u0442\u043e" u"\u0440\u0430\u0432" u"\u0435\u043d\u0442" u"\u0435\u0441\u0442"
+      u"\u043f\u0446\u0438" u"\u043e\u043f\u0446" u"\u043d\u0430\u0442" u"\u0434\u0430\u0432" u"\u043c\u0430 " u"\u0438\u043b\u0438" u"\u043b\u0435\u043d" u"\u0438\u0437\u043f" u"\u043d\u0438\u0442" u"\u0441\u0442\u0432"
+      u"\u0445\u043e\u0434" u"\u044f\u0442\u0430" u"\u0434\u0430\u043d" u"\u043d\u0435\u0442" u"\u0435\u0442\u0435" u"\u043d\u0435\u043f" u" \u0433\u0440" u" \u0441\u0430" u"\u0436\u0434\u0430" u"\u0442\u0435\u043b"
+      u"\u043e\u0440\u0438" u" \u0438\u043d" u"\u043d\u0434\u0430" u"\u0439\u043b " u"\u0441\u0430 " u"\u0441\u043b\u0435" u"\u0442\u043e\u0440" u"\u0442\u0438 " u"\u0437\u043d\u0430" u"\u0441\u0442\u043e"
+      u"\u043b\u0435\u0434" u"\u0440\u0435\u0448" u" \u0441\u043b" u"\u043a\u043e\u043c" u" \u0431\u0435" u"\u0430\u0446\u0438" u"\u0435\u043d\u0430" u"\u0437\u0430\u0434" u"\u0442\u0430\u043d" u"\u0432\u044a\u0440"
+      u"\u0437\u0432\u0435" u"\u0434\u044a\u0440" u"\u043c\u0435 " u"\u0435\u0437 " u"\u043e\u043c\u0430" u" \u043f\u0430" u"\u044f\u0442 " u" \u0442\u043e" u"\u0430\u0442\u043e" u"\u0430\u0434\u0430"
+      u"\u043e\u043c\u0435" u"\u043c\u0430\u043d" u"\u043b\u043e\u0432" u"\u0432\u0435 " u" \u043a\u043b" u"\u0440\u0435\u043a" u"\u0432\u0438\u043b" u"\u0430\u0434\u0435" u"\u0433\u0440\u0435" u"it "
+      u"\u0432\u0435\u0436" u" \u043a\u0430" u" \u0430\u0440" u" \u0434\u0438" u"\u044f\u0432\u0430" u"\u0438\u0432\u0430" u" gi" u"\u0432\u0430\u0442" u"\u0430\u0442\u0435" u"git" },
+    { QLocale::Turkish,
+      u" bi" u"eri" u"lan" u"ir " u"in " u"en " u"lar" u" de" u"ler" u" do"
+      u"ama" u"bir" u" ya" u"an\u0131" u"an " u" ge" u" i\u00e7" u"ar\u0131" u" ve" u"yor"
+      u"ile" u" ba" u"er " u"i\u00e7i" u"sya" u"dos" u"osy" u"as\u0131" u" ol" u"ya "
+      u"or " u"ara" u" ka" u"len" u"\u00e7in" u"lam" u" ku" u"ili" u"ak " u"e\u00e7e"
+      u"de\u011f" u"s\u0131 " u"d\u0131 " u"ri " u"e\u011fi" u" sa" u"ini" u"kle" u" se" u"ar "
+      u"lla" u"\u0131la" u"lem" u" di" u"ull" u"le " u"ene" u"al\u0131" u"ste" u"kul"
+      u"ma " u"ekl" u"de " u" ha" u"\u00e7er" u"bil" u"ad\u0131" u" ye" u"eme" u"nde"
+      u" be" u"nda" u"\u015fle" u"ala" u"ni " u"esi" u"si " u"eti" u"\u0131n\u0131" u"da "
+      u"li " u"\u0131r " u"r\u0131 " u"ge\u00e7" u"ind" u" gi" u" ko" u" ta" u" ar" u"ay\u0131"
+      u"eni" u"iz " u" pa" u" bu" u"rak" u"iyo" u" al" u"l\u0131 " u"lir" u"rin"
+      u" il" u"den" u"\u0131n " u"n\u0131 " u"mad" u"d\u0131r" u"tir" u"t\u0131r" u"ola" u"yen"
+      u"ana" u"eli" u"ata" u"ik " u"iri" u" i\u015f" u"ba\u015f" u"ek " u"ne " u" ad"
+      u"i\u015fl" u"yaz" u" so" u"me " u"di " u" ay" u"ter" u"siz" u"aya" u" yo"
+      u"uru" u"ve " u"tan" u"hat" u"rsi" u"\u0131nd" u" g\u00f6" u"ers" u"ki " u"ist"
+      u"tar" u"s\u0131n" u"\u0131yo" u"izi" u"bel" u"sin" u"lma" u"\u0131r\u0131" u"la " u"se\u00e7"
+      u" da" u"ere" u"and" u"say" u"at\u0131" u"ril" u"ine" u"yal" u"edi" u"\u011fi\u015f" },
+    { QLocale::Hungarian,
+      u" a " u" ne" u"em " u"az " u" me" u" az" u" sz" u"nem" u"en " u"ele"
+      u" ki" u"\u00e1jl" u"f\u00e1j" u"tt " u"len" u"tel" u"\u00e1sa" u"meg" u"\u00e9s " u"sa "
+      u" ha" u" f\u00e1" u"gy " u"cso" u"t\u00e1s" u" ka" u" el" u" le" u"egy" u"et "
+      u"ek " u"asz" u"ara" u" be" u"n\u00e1l" u" k\u00f6" u" va" u" \u00e9r" u" eg" u"ok "
+      u"t\u00e9s" u"men" u"ak " u" hi" u"has" u"ncs" u" cs" u"sze" u"agy" u"szn"
+      u"\u00e1s " u"an " u"ssz" u"hat" u"zn\u00e1" u"es " u"\u00e9ny" u"jl " u"\u00e9se" u"ett"
+      u"lt " u" fe" u"fel" u"\u00edt\u00e1" u"s\u00edt" u" ta" u" al" u"\u00e9rt" u"ent" u"ter"
+      u"ott" u"t\u00e1r" u"sol" u"se " u"l\u00edt" u"tal" u"at " u"\u00e1ll" u" \u00e9s" u"kap"
+      u"r\u00e1s" u"t\u00f3 " u"jel" u"cs " u" fo" u"hoz" u" mi" u"ene" u"sza" u"apc"
+      u"pcs" u"v\u00e9n" u" pa" u" ke" u"ran" u"sz\u00e1" u"at\u00f3" u"for" u"ja " u"al "
+      u"het" u"ker" u"tum" u"or " u"par" u"zet" u"min" u"vag" u"net" u"hib"
+      u"eze" u"int" u"kez" u"rv\u00e9" u"ol\u00f3" u"z\u00e9s" u"\u00e1lt" u"ere" u"kor" u"anc"
+      u"rak" u"\u00e9rv" u" z " u"lat" u"\u00e1la" u" ad" u"gye" u"el " u"szt" u"nt "
+      u"z\u00e1m" u"si " u"va " u"ll\u00ed" u"\u00edt\u00e9" u"lha" u"ni " u"akt" u"mez" u"ba "
+      u"z\u00e1s" u" re" u"let" u"kar" u"sor" u"ely" u"ik " u"\u00edr\u00e1" u"l\u00e1s" u"rte"
+      u" ar" u"elm" u"\u00e1ny" u"nak" u"ez\u0151" u"s\u00e9g" u"ra " u"re " u"v\u00e1l" u"os " },
+    { QLocale::Romanian,
+      u" de" u"de " u"te " u"re " u"are" u" nu" u"ea " u"ul " u" se" u"ent"
+      u" \u00een" u"t\u0103 " u"rea" u"nu " u"le " u" co" u" fi" u"iun" u" in" u"ntr"
+      u"ste" u"est" u"ate" u" pe" u"fi\u0219" u"ier" u" re" u"at " u"z\u0103 " u"tru"
+      u" es" u"se " u"rul" u"une" u"\u00een " u" ne" u" di" u"i\u0219i" u"\u0219ie" u"ru "
+      u" a " u"\u021biu" u"oar" u"ie " u"ui " u"pen" u"az\u0103" u"num" u" pr" u"car"
+      u"la " u" po" u"eaz" u"men" u" ca" u"ele" u" la" u"lui" u"nea" u"ume"
+      u"nte" u"ulu" u" cu" u"ter" u"ere" u"int" u"ile" u"ire" u"val" u" un"
+      u"ist" u"ne " u"or " u"a\u021bi" u"tat" u"ali" u"ica" u"con" u" su" u"tor"
+      u" ex" u"c\u021bi" u"che" u" ac" u" ar" u"ect" u"sta" u" li" u"at\u0103" u"nt "
+      u"c\u0103 " u"ii " u"com" u"liz" u"cu " u"un " u"r\u0103 " u" op" u"fic" u" fo"
+      u"ili" u"iza" u"ver" u"ero" u" si" u"\u0219te" u"ri " u"ces" u" ma" u"eru"
+      u"tul" u"er " u"s\u0103 " u"ifi" u"oat" u"rec" u" st" u"uni" u"loc" u" da"
+      u"pre" u"sec" u" er" u" \u0219i" u" al" u"til" u"it " u"\u021bi " u"ia " u" o "
+      u"alo" u"imb" u"uti" u"al " u" pa" u"roa" u" va" u" ut" u"poa" u"lic"
+      u"ec\u021b" u"uri" u"pro" u"\u0219i " u"ini" u"ut " u"ori" u"ecu" u"ta " u"bil"
+      u"n\u0103 " u"str" u"p\u021bi" u" ti" u"tre" u"ar " u" sa" u"in " u"oca" u"tar" },
+    { QLocale::Greek,
+      u" \u03c4\u03bf" u"\u03bf\u03c5 " u"\u03c4\u03bf " u"\u03c3\u03b7 " u"\u03b1\u03b9 " u"\u03b7\u03c2 " u" \u03b1\u03c0" u"\u03bf\u03c2 " u" \u03b4\u03b5" u"\u03bd\u03b1 "
+      u" \u03ba\u03b1" u" \u03b1\u03c1" u"\u03c4\u03bf\u03c5" u"\u03af\u03b1 " u" \u03b1\u03bd" u"\u03b1\u03c2 " u"\u03b5\u03b9 " u"\u03b4\u03b5\u03bd" u"\u03b5\u03bd " u" \u03c3\u03c4"
+      u"\u03b9\u03ba\u03cc" u" \u03c0\u03c1" u"\u03bc\u03b1 " u"\u03c1\u03c7\u03b5" u"\u03c9\u03bd " u"\u03b9\u03b1 " u" \u03c4\u03b7" u"\u03c4\u03b9\u03ba" u"\u03b1\u03c1\u03c7" u"\u03bc\u03b1\u03c4"
+      u" \u03b4\u03b9" u"\u03c3\u03c4\u03bf" u" \u03bc\u03b5" u" \u03b5\u03c0" u"\u03ba\u03cc " u"\u03bc\u03ad\u03bd" u"\u03c7\u03b5\u03af" u" \u03c3\u03c5" u" \u03bd\u03b1" u" \u03c0\u03b1"
+      u" \u03b7 " u"\u03c3\u03b7\u03c2" u" \u03b5\u03af" u"\u03b3\u03c1\u03b1" u" \u03c5\u03c0" u"\u03c3\u03c4\u03b7" u"\u03af\u03bd\u03b1" u"\u03c4\u03b5 " u"\u03ae\u03c2 " u"\u03b5\u03af\u03bd"
+      u"\u03ba\u03b1\u03c4" u"\u03bd\u03b1\u03b9" u"\u03c4\u03b1 " u"\u03b3\u03b9\u03b1" u" \u03b3\u03b9" u"\u03b5\u03af\u03bf" u"\u03b7\u03c3\u03b7" u"\u03bf\u03c0\u03bf" u"\u03b9\u03c3\u03c4" u"\u03c0\u03c1\u03bf"
+      u"\u03b4\u03b9\u03b1" u"\u03c4\u03b1\u03b9" u"\u03b1\u03c0\u03bf" u"\u03b5\u03c0\u03b9" u"\u03c4\u03b7 " u" \u03c7\u03c1" u"\u03b7\u03bd " u"\u03b1\u03bd\u03b1" u"\u03c7\u03b5\u03b9" u" \u03b5\u03bd"
+      u"\u03bd\u03bf " u"\u03c4\u03b7\u03bd" u"\u03c5\u03c0\u03bf" u"\u03b5\u03af " u"\u03b5\u03c4\u03b1" u"\u03bb\u03bf\u03b3" u"\u03c1\u03b9\u03c3" u"\u03c1\u03b1\u03c6" u"\u03bf\u03cd " u"\u03b9\u03ba\u03ae"
+      u" \u03bc\u03b7" u"\u03c4\u03b7\u03c2" u"\u03bc\u03b5 " u"\u03b1\u03bd " u"\u03ad\u03c2 " u"\u03b1\u03c1\u03b1" u"\u03bc\u03b7 " u"\u03b1\u03c4\u03bf" u"\u03c5\u03bd\u03b1" u"\u03ba\u03ae "
+      u"\u03b4\u03c5\u03bd" u"\u03b1\u03bb\u03bb" u"\u03ce\u03bd " u"\u03b5\u03c2 " u"\u03af\u03bf " u" \u03b1\u03b4" u"\u03bc\u03b5\u03bd" u"\u03c4\u03bf\u03c2" u" \u03ba\u03bb" u"\u03b1\u03c0\u03cc"
+      u"\u03c3\u03b5 " u"\u03ad\u03bd\u03bf" u"\u03b1\u03c4\u03b9" u"\u03cc\u03c2 " u" \u03b1\u03bb" u"\u03bd\u03b1\u03bc" u"\u03c0\u03b1\u03c1" u" \u03c0\u03bf" u"\u03b1\u03c4\u03ac" u" \u03c3\u03b5"
+      u"\u03ba\u03ac " u"\u03c0\u03cc " u"\u03c3\u03c4\u03b5" u" \u03ad\u03b3" u"\u03ba\u03b1\u03b9" u"\u03c0\u03bf\u03b9" u"\u03c0\u03b5\u03c1" u"\u03b9\u03c3\u03bc" u"\u03af\u03b1\u03c2" u"\u03c4\u03c9\u03bd"
+      u"\u03b9\u03ba\u03ac" u"\u03c9\u03c3\u03b7" u"\u03bf\u03bc\u03b1" u"\u03c3\u03c4\u03b1" u" \u03b4\u03b7" u" \u03c0\u03b5" u"\u03cc\u03bd\u03bf" u"\u03af\u03bf\u03c5" u"\u03ba\u03c5\u03c1" u" \u03c4\u03b1"
+      u"\u03b9\u03bf " u"\u03bb\u03b5\u03b9" u"\u03b1\u03c4\u03b1" u"\u03b5\u03c1\u03b9" u"\u03bd\u03b1\u03c4" u"\u03b9\u03ba\u03bf" u"\u03c0\u03b9\u03bb" u"\u03b7\u03bc\u03b1" u" \u03c0\u03bb" u"\u03b4\u03b7\u03bc"
+      u"\u03c4\u03ae " u"\u03ad\u03bd\u03b1" u"\u03bd\u03b9\u03ba" u"\u03b7\u03ba\u03b5" u"\u03c3\u03c5\u03bd" u"\u03b4\u03b9\u03ba" u"\u03b3\u03ae " u"\u03bd\u03bf\u03bc" u"\u03b5\u03b9\u03b4" u"\u03ba\u03b5 "
+      u" \u03c3\u03c6" u"\u03b1\u03c5\u03c4" u"\u03b1\u03ba\u03ad" u"\u03b5\u03c4\u03b5" u"\u03bb\u03bc\u03b1" u"\u03ba\u03ad\u03c4" u"\u03c6\u03ac\u03bb" u"\u03c3\u03c6\u03ac" u"\u03ac\u03bb\u03bc" u"\u03bc\u03b5\u03c4" }
+};
@@ -7,10 +7,17 @@
 #include <QAbstractItemView>
 #include <QPointer>
 #include <QScopedValueRollback>
+#include <QElapsedTimer>
+#include <QItemSelectionModel>
+#include <QTimer>
+#include <QDataStream>
+#include <QIcon>
+#include <QImage>
 
 #include <QDebug>
 
 #include <CacheMap> // from Qt5Extra aux
+#include <CacheStats> // from Qt5Extra aux
 
 #include "qtitemwidgetdelegate.h"
 #include "qtitemwidget.h"
@@ -33,31 +40,144 @@ public:
             return !(*this == other);
         }
     };
-    using PixmapCache = Qt5Extra::CacheMap<uint64_t, Hint, QPixmap>;
+    struct PixmapWeigher
+    {
+        inline size_t operator()(const QPixmap& pixmap) const noexcept
+        {
+            return size_t(pixmap.width()) * size_t(pixmap.height()) * size_t(pixmap.depth()) / 8;
+        }
+    };
+    using PixmapCache = Qt5Extra::CacheMap<uint64_t, Hint, QPixmap, Qt5Extra::CacheStats<PixmapWeigher>>;
 
     static Q_CONSTEXPR size_t kDefaultPixmapCacheLimit = 64;
     static Q_CONSTEXPR size_t kDefaultPixmapCacheDepth = 4;
+    static Q_CONSTEXPR qint64 kPrerenderBudget = 4; // msecs per event loop pass
 
     QModelIndex currentIndex; // current model index (index that under mouse cursor)
     QModelIndex draggingIndex;
     mutable QScopedPointer<QtItemWidget> widget; // widget to embed
+    QScopedPointer<QtItemWidget> offscreenWidget; // widget to pre-render items while idle
     mutable PixmapCache pixmapCache{ kDefaultPixmapCacheLimit, kDefaultPixmapCacheDepth };
     mutable int cachedWidth = 0; // cached item width - if it's changed we will drop the pixmap cache
     mutable double dpr = 1.0;
     QtItemWidgetDelegate::Options options = QtItemWidgetDelegate::NoOptions;
     QWidget::RenderFlags flags = QWidget::DrawChildren; // widget rendering flags
 
+    // items around the last painted one are rendered into the cache while idle
+    QTimer prerenderTimer;
+    QPointer<const QAbstractItemView> prerenderView;
+    QPersistentModelIndex prerenderIndex;
+    QStyleOptionViewItem prerenderOption;
+
     static uint64_t packedIndex(const QModelIndex& index)
     {
         return uint64_t(index.row()) | (uint64_t(index.column()) << 32);
     }
 
+    static uint64_t contentHash(const QModelIndex& index);
+    static void prepareWidget(QtItemWidget* widget);
+
     void renderDirect(QPainter* painter, const QRect& rect) const;
     void renderCached(QPainter* painter, const QStyleOptionViewItem &option, const QModelIndex &index, const QtItemWidgetDelegate *delegate) const;
+    QPixmap renderPixmap(const QStyleOptionViewItem &option, const QModelIndex &index, const QtItemWidgetDelegate *delegate) const;
     void updateDevicePixelRatio(const QScreen* screen);
+
+    void schedulePrerender(const QStyleOptionViewItem &option, const QModelIndex &index);
+    void prerender(const QtItemWidgetDelegate *delegate);
+    bool prerender(const QModelIndex &index, const QtItemWidgetDelegate *delegate);
 };
 
 
+uint64_t QtItemWidgetDelegatePrivate::contentHash(const QModelIndex &index)
+{
+    // FNV-1a over roles, types and contents of the values
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](const void* data, size_t size) {
+        const uchar* bytes = static_cast<const uchar*>(data);
+        for (size_t i = 0; i < size; ++i)
+            hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    };
+
+    const QAbstractItemModel* model = index.model();
+    if (!model)
+        return hash;
+
+    // itemData() holds only the roles below Qt::UserRole,
+    // custom roles are taken from the model role names
+    QMap<int, QVariant> data = model->itemData(index);
+    const QHash<int, QByteArray> roleNames = model->roleNames();
+    for (auto it = roleNames.cbegin(); it != roleNames.cend(); ++it)
+    {
+        if (it.key() >= Qt::UserRole)
+        {
+            const QVariant value = model->data(index, it.key());
+            if (value.isValid())
+                data.insert(it.key(), value);
+        }
+    }
+
+    bool hashed = true;
+    QByteArray bytes;
+    for (auto it = data.cbegin(); it != data.cend(); ++it)
+    {
+        const int role = it.key();
+        const int type = it->userType();
+        mix(&role, sizeof(role));
+        mix(&type, sizeof(type));
+
+        // images are hashed by their cache keys, rest by serialized
+        // value or by string form if the type has no stream operators
+        qint64 imageKey = 0;
+        switch (type)
+        {
+        case QMetaType::QIcon:   imageKey = qvariant_cast<QIcon>(*it).cacheKey(); break;
+        case QMetaType::QPixmap: imageKey = qvariant_cast<QPixmap>(*it).cacheKey(); break;
+        case QMetaType::QImage:  imageKey = qvariant_cast<QImage>(*it).cacheKey(); break;
+        default:
+        {
+            bytes.clear();
+            QDataStream out(&bytes, QIODevice::WriteOnly);
+            if (QMetaType::save(out, type, it->constData()))
+            {
+                mix(bytes.constData(), size_t(bytes.size()));
+            }
+            else if (it->canConvert<QString>())
+            {
+                const QString text = it->toString();
+                mix(text.constData(), size_t(text.size()) * sizeof(QChar));
+            }
+            else
+            {
+                hashed = false;
+            }
+            continue;
+        }
+        }
+        mix(&imageKey, sizeof(imageKey));
+    }
+
+    // values that can't be hashed leave the pixmap bound to the item position
+    if (!hashed)
+    {
+        const uint64_t position = packedIndex(index);
+        mix(&position, sizeof(position));
+    }
+    return hash;
+}
+
+void QtItemWidgetDelegatePrivate::prepareWidget(QtItemWidget *widget)
+{
+    // This is a most important thing - set an
+    // Qt::WA_DontShowOnScreen attribute on widget
+    // to disable widget ability to self-render
+    widget->setAttribute(Qt::WA_DontShowOnScreen);
+    widget->setMouseTracking(true);
+    // This also important: we adjust widget size beforehand
+    // to get correct value for sizeHint() overriden method
+    widget->adjustSize();
+}
+
+
 void QtItemWidgetDelegatePrivate::renderDirect(QPainter *painter, const QRect &rect) const
 {
     painter->save();
@@ -69,12 +189,12 @@ void QtItemWidgetDelegatePrivate::renderDirect(QPainter *painter, const QRect &r
 void QtItemWidgetDelegatePrivate::renderCached(QPainter *painter, const QStyleOptionViewItem& option, const QModelIndex& index, const QtItemWidgetDelegate *delegate) const
 {
     // same as above - but use cache to speed-up things
-    const uint64_t key = packedIndex(index);
+    const uint64_t key = delegate->cacheKey(index);
     const Hint hint = { option.rect.size(), option.state };
     QPixmap pixmap;
     if (pixmapCache.find(key, hint, pixmap)) // cache hit
     {
-        qDebug() << "cacheHit for (" << index.row() << index.column() << ')';
+        pixmapCache.move_front(key); // keep painted items in cache
         painter->save();
         painter->translate(option.rect.topLeft());
         painter->drawPixmap(0, 0, pixmap); // draw pixmap from cache
@@ -82,21 +202,25 @@ void QtItemWidgetDelegatePrivate::renderCached(QPainter *painter, const QStyleOp
     }
     else // cache miss
     {
-        qDebug() << "cacheMiss for (" << index.row() << index.column() << ')';
-        delegate->updateWidgetData(index, option); // update widget data
-        pixmap = QPixmap(option.rect.size() * dpr);
-        pixmap.setDevicePixelRatio(dpr);
-        pixmap.fill(Qt::transparent);
-
-        QPainter pixmapPainter(&pixmap);
-        widget->render(&pixmapPainter, QPoint(), QRegion(), flags);
-
+        pixmap = renderPixmap(option, index, delegate);
         pixmapCache.insert(key, hint, pixmap); // cache pixmap
 
         painter->drawPixmap(option.rect.topLeft(), pixmap);
     }
 }
 
+QPixmap QtItemWidgetDelegatePrivate::renderPixmap(const QStyleOptionViewItem &option, const QModelIndex &index, const QtItemWidgetDelegate *delegate) const
+{
+    delegate->updateWidgetData(index, option); // update widget data
+    QPixmap pixmap(option.rect.size() * dpr);
+    pixmap.setDevicePixelRatio(dpr);
+    pixmap.fill(Qt::transparent);
+
+    QPainter pixmapPainter(&pixmap);
+    widget->render(&pixmapPainter, QPoint(), QRegion(), flags);
+    return pixmap;
+}
+
 void QtItemWidgetDelegatePrivate::updateDevicePixelRatio(const QScreen* screen)
 {
     if (!screen)
@@ -113,11 +237,112 @@ void QtItemWidgetDelegatePrivate::updateDevicePixelRatio(const QScreen* screen)
     }
 }
 
+void QtItemWidgetDelegatePrivate::schedulePrerender(const QStyleOptionViewItem &option, const QModelIndex &index)
+{
+    prerenderView = qobject_cast<const QAbstractItemView*>(option.widget);
+    if (!prerenderView)
+        return;
+
+    prerenderIndex = index;
+    prerenderOption = option;
+    prerenderOption.state &= ~(QStyle::State_MouseOver | QStyle::State_Selected | QStyle::State_HasFocus);
+    prerenderTimer.start();
+}
+
+void QtItemWidgetDelegatePrivate::prerender(const QtItemWidgetDelegate *delegate)
+{
+    const QAbstractItemView* view = prerenderView;
+    const QAbstractItemModel* model = prerenderIndex.model();
+    if (!view || !model || !widget || !(options & QtItemWidgetDelegate::PrerenderItems))
+        return;
+
+    // rows visible in the column of the last painted item
+    const QRect viewport = view->viewport()->rect();
+    const int x = view->visualRect(prerenderIndex).center().x();
+    const QModelIndex first = view->indexAt(QPoint(x, viewport.top()));
+    const QModelIndex last = view->indexAt(QPoint(x, viewport.bottom()));
+    if (!first.isValid())
+        return;
+
+    // idle rendering uses the widget of its own, so the state of the
+    // interactive one (hovered or current item) is kept intact; it's
+    // swapped in for the pass, since updateWidgetData() uses widget()
+    if (!offscreenWidget)
+    {
+        offscreenWidget.reset(delegate->createItemWidget());
+        if (!offscreenWidget)
+            return;
+        prepareWidget(offscreenWidget.data());
+    }
+
+    struct WidgetSwap
+    {
+        QScopedPointer<QtItemWidget>& lhs;
+        QScopedPointer<QtItemWidget>& rhs;
+        WidgetSwap(QScopedPointer<QtItemWidget>& a, QScopedPointer<QtItemWidget>& b) : lhs(a), rhs(b) { lhs.swap(rhs); }
+        ~WidgetSwap() { lhs.swap(rhs); }
+    } guard(widget, offscreenWidget);
+
+    const QModelIndex parent = prerenderIndex.parent();
+    const int column = prerenderIndex.column();
+    const int firstRow = first.row();
+    const int lastRow = last.isValid() ? last.row() : model->rowCount(parent) - 1;
+
+    // up to a screen in both directions, as long as visible items stay in the cache
+    const int visible = std::max(1, lastRow - firstRow + 1);
+    const size_t capacity = pixmapCache.capacity();
+    const size_t room = capacity > size_t(visible) ? (capacity - size_t(visible)) / 2 : 0;
+    const int span = int(std::min(size_t(visible), room));
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+    for (int i = 1; i <= span; ++i)
+    {
+        // rows below go first, since lists are mostly scrolled down
+        for (const int row : { lastRow + i, firstRow - i })
+        {
+            if (prerender(model->index(row, column, parent), delegate) && elapsed.elapsed() >= kPrerenderBudget)
+            {
+                prerenderTimer.start(); // continue after pending events are processed
+                return;
+            }
+        }
+    }
+}
+
+bool QtItemWidgetDelegatePrivate::prerender(const QModelIndex &index, const QtItemWidgetDelegate *delegate)
+{
+    if (!index.isValid() || index == currentIndex || index == draggingIndex)
+        return false;
+
+    const QAbstractItemView* view = prerenderView;
+    if (view->selectionModel() && view->selectionModel()->isSelected(index))
+        return false;
+
+    QStyleOptionViewItem option = prerenderOption;
+    option.rect = view->visualRect(index);
+    option.index = index;
+    if (option.rect.isEmpty() || delegate->renderHint(option, index) != QtItemWidgetDelegate::RenderCached)
+        return false;
+
+    const uint64_t key = delegate->cacheKey(index);
+    const Hint hint = { option.rect.size(), option.state };
+    if (pixmapCache.count(key, hint) > 0)
+        return false;
+
+    widget->clearState();
+    pixmapCache.insert(key, hint, renderPixmap(option, index, delegate));
+    return true;
+}
+
 
 QtItemWidgetDelegate::QtItemWidgetDelegate(QObject *parent)
     : QStyledItemDelegate(parent)
     , d(new QtItemWidgetDelegatePrivate)
 {
+    d->prerenderTimer.setSingleShot(true);
+    d->prerenderTimer.setInterval(0);
+    connect(&d->prerenderTimer, &QTimer::timeout, this, [this]() { d->prerender(this); });
 }
 
 QtItemWidgetDelegate::~QtItemWidgetDelegate() = default;
@@ -151,6 +376,16 @@ int QtItemWidgetDelegate::cacheLimit() const
     return d->pixmapCache.capacity();
 }
 
+QtCacheStatistics QtItemWidgetDelegate::cacheStatistics() const
+{
+    return QtCacheStatistics::fromCounters(d->pixmapCache.statistics());
+}
+
+void QtItemWidgetDelegate::resetCacheStatistics()
+{
+    d->pixmapCache.resetStatistics();
+}
+
 bool QtItemWidgetDelegate::isOverDragArea(const QStyleOptionViewItem& option, const QPoint& p) const
 {
     if (Q_UNLIKELY(d->widget == Q_NULLPTR))
@@ -236,6 +471,8 @@ void QtItemWidgetDelegate::paint(QPainter *painter, const QStyleOptionViewItem &
     else
     {
         d->renderCached(painter, option, index, this);
+        if (d->options & PrerenderItems)
+            d->schedulePrerender(option, index);
     }
 }
 
@@ -256,6 +493,13 @@ QtItemWidgetDelegate::RenderHint QtItemWidgetDelegate::renderHint(const QStyleOp
         return RenderDirect;
 }
 
+quint64 QtItemWidgetDelegate::cacheKey(const QModelIndex &index) const
+{
+    if (d->options & ContentKeyedCache)
+        return QtItemWidgetDelegatePrivate::contentHash(index);
+    return QtItemWidgetDelegatePrivate::packedIndex(index);
+}
+
 QtItemWidget *QtItemWidgetDelegate::widget() const
 {
     return d->widget.get();
@@ -283,14 +527,7 @@ void QtItemWidgetDelegate::createWidgetOnDemand() const
     if (Q_UNLIKELY(d->widget == Q_NULLPTR))
         return;
 
-    // This is a most important thing - set an
-    // Qt::WA_DontShowOnScreen attribute on widget
-    // to disable widget ability to self-render
-    d->widget->setAttribute(Qt::WA_DontShowOnScreen);
-    d->widget->setMouseTracking(true);
-    // This also important: we adjust widget size beforehand
-    // to get correct value for sizeHint() overriden method
-    d->widget->adjustSize();
+    QtItemWidgetDelegatePrivate::prepareWidget(d->widget.data());
 }
 
 void QtItemWidgetDelegate::updateWidgetData(const QModelIndex& index, const QStyleOptionViewItem& option) const
@@ -420,13 +657,12 @@ void QtItemWidgetDelegate::invalidate()
 
 void QtItemWidgetDelegate::invalidateIndex(const QModelIndex &index)
 {
-    d->pixmapCache.erase(d->packedIndex(index));
+    d->pixmapCache.erase(cacheKey(index));
 }
 
 void QtItemWidgetDelegate::invalidateRange(const QModelIndex &topLeft, const QModelIndex &bottomRight)
 {
-    const QModelIndex index = topLeft;
     for (int i = topLeft.row(), n = bottomRight.row(); i <= n; ++i)
         for (int j = topLeft.column(), m = bottomRight.column(); j <= m; ++j)
-            d->pixmapCache.erase(d->packedIndex(index));
+            d->pixmapCache.erase(cacheKey(topLeft.sibling(i, j)));
 }
@@ -2,6 +2,7 @@
 #include <QStyledItemDelegate>
 
 #include <QtWidgetsExtra>
+#include <QtCacheStatistics>
 
 class QtItemWidget;
 
@@ -27,7 +28,9 @@ public:
         AutoFillBackground = 1 << 2, // enable/disable auto-fill background of items
         StaticContents = 1 << 3, // hint for static contents
         CacheItemPixmap = 1 << 4, // enable/disable pixmap caching
-        CustomEventFilter = 1 << 5 // use QObject::eventFilter() instead of QStyleItemDelegate::editorEvent() for item event handling
+        CustomEventFilter = 1 << 5, // use QObject::eventFilter() instead of QStyleItemDelegate::editorEvent() for item event handling
+        ContentKeyedCache = 1 << 6, // key cached pixmaps by cacheKey() of item contents instead of item position
+        PrerenderItems = 1 << 7 // render items just outside of the viewport into the cache while idle
     };
     Q_DECLARE_FLAGS(Options, Option)
     Q_FLAG(Option)
@@ -41,6 +44,10 @@ public:
     void setCacheLimit(int cacheSize);
     int cacheLimit() const;
 
+    // counters of the pixmap cache, the bytes are estimated by pixmap sizes
+    QtCacheStatistics cacheStatistics() const;
+    void resetCacheStatistics();
+
     bool isOverDragArea(const QStyleOptionViewItem &option, const QPoint &p) const;
 
     void setDragIndex(const QModelIndex& index);
@@ -70,6 +77,14 @@ protected:
     virtual void updateWidgetData(const QModelIndex& index, const QStyleOptionViewItem &option) const;
     virtual RenderHint renderHint(const QStyleOptionViewItem &option, const QModelIndex &) const;
 
+    // Key of the cached pixmap of the index. It's the position of the index by default,
+    // with ContentKeyedCache option it's the hash of the item data (standard roles and
+    // roles of QAbstractItemModel::roleNames(), icons and images by their cache keys),
+    // so pixmaps survive row moves and sorting. Values that have neither stream operators
+    // nor string form keep the key bound to the position. Override it to hash the data
+    // widget consumes
+    virtual quint64 cacheKey(const QModelIndex& index) const;
+
     QtItemWidget* widget() const;
 
 protected:
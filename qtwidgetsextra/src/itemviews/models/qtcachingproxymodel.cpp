@@ -1,52 +1,456 @@
 #include <vector>
-#include <unordered_map>
+#include <algorithm>
+#include <limits>
 #include <QBasicTimer>
 #include <QTimerEvent>
+#include <QScopedValueRollback>
+#include <QSet>
+#include <QImage>
+#include <QPixmap>
+#include <QPointer>
+#include <QTimer>
+#include <QAbstractItemView>
+#include <QScrollBar>
+
+#include <LRUCache> // from Qt5Extra aux
+#include <CacheStats> // from Qt5Extra aux
+
 #include "qtcachingproxymodel.h"
 
+//
+// Flat open-addressing hash table (linear probing) that stores
+// the values of prefetched rows window. Since window is rebuilt
+// as whole on every move entries are never erased one by one,
+// so no tombstones are needed.
+//
+class QtPrefetchTable
+{
+public:
+    static Q_CONSTEXPR quint64 kEmptyKey = ~quint64(0);
+
+    struct Slot
+    {
+        quint64 key = kEmptyKey;
+        QVariant value;
+    };
+
+    void reserve(size_t n)
+    {
+        size_t capacity = 16;
+        while (capacity < n * 2) // keep load factor below 0.5
+            capacity <<= 1;
+
+        std::vector<Slot> old;
+        old.swap(slots);
+        slots.resize(capacity);
+        mask = capacity - 1;
+        count = 0;
+        for (Slot& slot : old)
+            if (slot.key != kEmptyKey)
+                insert(slot.key, std::move(slot.value));
+    }
+
+    const QVariant* find(quint64 key) const
+    {
+        if (slots.empty())
+            return Q_NULLPTR;
+
+        for (size_t i = hash(key) & mask; ; i = (i + 1) & mask)
+        {
+            const Slot& slot = slots[i];
+            if (slot.key == key)
+                return &slot.value;
+            if (slot.key == kEmptyKey)
+                return Q_NULLPTR;
+        }
+    }
+
+    QVariant* find(quint64 key)
+    {
+        return const_cast<QVariant*>(static_cast<const QtPrefetchTable*>(this)->find(key));
+    }
+
+    void insert(quint64 key, QVariant&& value)
+    {
+        if ((count + 1) * 2 > slots.size())
+            reserve(std::max<size_t>(count * 2, 8));
+
+        for (size_t i = hash(key) & mask; ; i = (i + 1) & mask)
+        {
+            Slot& slot = slots[i];
+            if (slot.key == kEmptyKey)
+            {
+                slot.key = key;
+                slot.value = std::move(value);
+                ++count;
+                return;
+            }
+            if (slot.key == key)
+            {
+                slot.value = std::move(value);
+                return;
+            }
+        }
+    }
+
+    template<class _Func>
+    void forEach(_Func func)
+    {
+        for (Slot& slot : slots)
+            if (slot.key != kEmptyKey)
+                func(slot.key, slot.value);
+    }
+
+    void clear()
+    {
+        slots.clear();
+        mask = 0;
+        count = 0;
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+private:
+    static inline size_t hash(quint64 key)
+    {
+        // 64-bit finalizer of MurmurHash3
+        key ^= key >> 33;
+        key *= Q_UINT64_C(0xff51afd7ed558ccd);
+        key ^= key >> 33;
+        key *= Q_UINT64_C(0xc4ceb9fe1a85ec53);
+        key ^= key >> 33;
+        return static_cast<size_t>(key);
+    }
+
+    std::vector<Slot> slots;
+    size_t mask = 0;
+    size_t count = 0;
+};
+
+
 class QtCachingProxyModelPrivate
 {
 public:
-    mutable std::unordered_map<quint64, QVariant> cache;
+    struct CacheEntry
+    {
+        QVariant value;
+        size_t cost;
+    };
+    struct CostWeigher
+    {
+        inline size_t operator()(const CacheEntry& entry) const noexcept { return entry.cost; }
+    };
+    using Cache = Qt5Extra::LRUCache<
+        quint64, CacheEntry, std::hash<quint64>, std::equal_to<quint64>,
+        std::allocator<std::pair<const quint64, CacheEntry>>,
+        Qt5Extra::CacheStats<CostWeigher>
+    >;
+
+    // roles and columns below this value are resolved
+    // into cache slots via direct table lookup
+    static Q_CONSTEXPR int kMaxDenseSlot = 4096;
+
+    mutable Cache cache; // most recently used values are at front
+    mutable size_t cacheCost;
+    mutable quint64 prefetchHits; // lookups served by window, cache doesn't see them
+    QtPrefetchTable window; // values of prefetched rows
+    size_t windowCost; // estimated when the window is built, if cost is limited
+    int windowFirst;
+    int windowLast;
+    int requestFirst; // rows requested by the last prefetch, window
+    int requestLast;  // may be narrower due to the cache limits
     std::vector<int> cachedRoles;
+    std::vector<int> cachedColumns;
+    std::vector<int> roleSlots; // role -> index in cachedRoles
+    std::vector<int> columnSlots; // column -> index in cachedColumns
+    QSet<int> dirtyRows; // cached rows changed since last cache update
+    QPointer<QAbstractItemView> view;
     size_t maxCacheSize;
-    int column;
+    size_t maxCacheCost;
+    int prefetchMargin;
     int interval;
     QBasicTimer timer;
     QtCachingProxyModel::CachingPolicy policy;
+    bool updating;
 
     QtCachingProxyModelPrivate()
-        : maxCacheSize(100)
-        , column(0)
+        : cacheCost(0)
+        , prefetchHits(0)
+        , windowCost(0)
+        , windowFirst(-1)
+        , windowLast(-2)
+        , requestFirst(-1)
+        , requestLast(-2)
+        , cachedColumns(1, 0)
+        , columnSlots(1, 0)
+        , maxCacheSize(100)
+        , maxCacheCost(std::numeric_limits<size_t>::max())
+        , prefetchMargin(32)
         , interval(10000)
         , policy(QtCachingProxyModel::ManualUpdate)
+        , updating(false)
     {}
 
-    inline QVariant cacheValue(int row, int role, const QVariant& value) const
+    inline QVariant cacheValue(quint64 key, const QVariant& value) const
     {
-        if (cache.size() > maxCacheSize)
-            cache.erase(cache.begin());
-
-        cache.emplace(indexate(row, role), value);
+        // emplace() rather than find(): storing the value isn't a cache lookup
+        const size_t cost = estimateCost(value);
+        auto result = cache.emplace(key, CacheEntry{ value, cost });
+        if (!result.second)
+        {
+            cacheCost -= result.first->second.cost;
+            cache.assign(result.first, CacheEntry{ value, cost });
+        }
+        cacheCost += cost;
+        shrink();
         return value;
     }
 
+    inline bool lookup(quint64 key, QVariant& result) const
+    {
+        if (const QVariant* value = window.find(key)) // prefetched
+        {
+            ++prefetchHits;
+            result = *value;
+            return true;
+        }
+
+        auto it = cache.find(key);
+        if (it == cache.end())
+            return false;
+
+        result = cache.move_font(it)->second.value; // promote to most recently used
+        return true;
+    }
+
+    inline bool isCached(int row) const
+    {
+        for (size_t c = 0; c < cachedColumns.size(); ++c)
+            for (size_t r = 0; r < cachedRoles.size(); ++r)
+                if (cache.contains(indexate(row, int(c), int(r))))
+                    return true;
+        return false;
+    }
+
+    inline bool isPrefetched(int row) const
+    {
+        return row >= windowFirst && row <= windowLast;
+    }
+
+    inline void shrink() const
+    {
+        // evict least recently used values until both limits are satisfied,
+        // prefetched rows count against the limits as well
+        while (!cache.empty() && (cache.size() + window.size() > maxCacheSize || cacheCost + windowCost > maxCacheCost))
+        {
+            cacheCost -= cache.back().second.cost;
+            cache.evict();
+        }
+    }
+
+    inline void clear()
+    {
+        cache.clear();
+        cacheCost = 0;
+        resetWindow();
+        dirtyRows.clear();
+    }
+
+    inline void resetWindow()
+    {
+        window.clear();
+        windowCost = 0;
+        windowFirst = -1;
+        windowLast = -2;
+        requestFirst = -1;
+        requestLast = -2;
+    }
+
+    inline int roleSlot(int role) const
+    {
+        return slotOf(roleSlots, cachedRoles, role);
+    }
+
+    inline int columnSlot(int column) const
+    {
+        return slotOf(columnSlots, cachedColumns, column);
+    }
+
     inline bool isCachedRole(int role) const
     {
-        return std::find(cachedRoles.begin(), cachedRoles.end(), role) != cachedRoles.end();
+        return roleSlot(role) >= 0;
+    }
+
+    inline bool isCachedColumn(int column) const
+    {
+        return columnSlot(column) >= 0;
+    }
+
+    // row occupies lower 32 bits of the key, so cached
+    // entries can be matched against row ranges cheaply
+    static inline quint64 indexate(int row, int columnSlot, int roleSlot)
+    {
+        return ((quint64)(quint32)row) | (((quint64)columnSlot) << 32) | (((quint64)roleSlot) << 48);
+    }
+
+    static inline int rowOf(quint64 key)
+    {
+        return static_cast<int>(key & 0xFFFFFFFF);
+    }
+
+    static int slotOf(const std::vector<int>& slots, const std::vector<int>& values, int value)
+    {
+        if (value >= 0 && value < static_cast<int>(slots.size()))
+            return slots[value];
+
+        if (value >= 0 && value < kMaxDenseSlot)
+            return -1;
+
+        auto it = std::find(values.begin(), values.end(), value);
+        return it != values.end() ? static_cast<int>(std::distance(values.begin(), it)) : -1;
     }
 
-    inline quint64 indexate(int row, int role) const
+    static std::vector<int> buildSlots(const std::vector<int>& values)
     {
-        return ((quint64)row) | (((quint64)role) << 32);
+        int n = 0;
+        for (int v : values)
+            if (v >= 0 && v < kMaxDenseSlot)
+                n = std::max(n, v + 1);
+
+        std::vector<int> slots(n, -1);
+        for (size_t i = 0; i < values.size(); ++i)
+            if (values[i] >= 0 && values[i] < kMaxDenseSlot && slots[values[i]] < 0)
+                slots[values[i]] = static_cast<int>(i);
+        return slots;
     }
+
+    void markDirty(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles);
+
+    void fetchRow(const QAbstractItemModel* model, const QtCachingProxyModel* q, int row, QtPrefetchTable& table) const;
+
+    static size_t estimateCost(const QVariant& value);
 };
 
+void QtCachingProxyModelPrivate::markDirty(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles)
+{
+    if (updating || (cache.empty() && window.empty()))
+        return;
+
+    if (std::none_of(cachedColumns.begin(), cachedColumns.end(),
+                     [&](int column) { return column >= topLeft.column() && column <= bottomRight.column(); }))
+        return;
+
+    if (!roles.isEmpty() && std::none_of(roles.begin(), roles.end(), [this](int role) { return isCachedRole(role); }))
+        return;
+
+    const int first = topLeft.row();
+    const int last = bottomRight.row();
+    if (static_cast<size_t>(last - first + 1) <= cache.size() + window.size())
+    {
+        for (int row = first; row <= last; ++row)
+            if (isPrefetched(row) || isCached(row))
+                dirtyRows.insert(row);
+    }
+    else
+    {
+        // changed range is wider than the cache itself:
+        // it's cheaper to walk through the cached entries
+        for (int row = std::max(first, windowFirst), n = std::min(last, windowLast); row <= n; ++row)
+            dirtyRows.insert(row);
+
+        for (const auto& entry : cache)
+        {
+            const int row = rowOf(entry.first);
+            if (row >= first && row <= last)
+                dirtyRows.insert(row);
+        }
+    }
+}
+
+void QtCachingProxyModelPrivate::fetchRow(const QAbstractItemModel* model, const QtCachingProxyModel* q, int row, QtPrefetchTable& table) const
+{
+    // fetch all cached cells of the row in one pass
+    for (size_t c = 0; c < cachedColumns.size(); ++c)
+    {
+        const QModelIndex sourceIndex = q->mapToSource(q->index(row, cachedColumns[c]));
+        if (!sourceIndex.isValid())
+            continue;
+
+        for (size_t r = 0; r < cachedRoles.size(); ++r)
+            table.insert(indexate(row, int(c), int(r)), model->data(sourceIndex, cachedRoles[r]));
+    }
+}
+
+size_t QtCachingProxyModelPrivate::estimateCost(const QVariant& value)
+{
+    size_t cost = sizeof(QVariant);
+    switch (value.userType())
+    {
+    case QMetaType::QString:
+        cost += value.toString().size() * sizeof(QChar);
+        break;
+    case QMetaType::QByteArray:
+        cost += value.toByteArray().size();
+        break;
+    case QMetaType::QStringList:
+        for (const QString& s : value.toStringList())
+            cost += sizeof(QString) + s.size() * sizeof(QChar);
+        break;
+    case QMetaType::QVariantList:
+        for (const QVariant& v : value.toList())
+            cost += estimateCost(v);
+        break;
+    case QMetaType::QVariantMap:
+    {
+        const QVariantMap map = value.toMap();
+        for (auto it = map.cbegin(); it != map.cend(); ++it)
+            cost += it.key().size() * sizeof(QChar) + estimateCost(it.value());
+        break;
+    }
+    case QMetaType::QVariantHash:
+    {
+        const QVariantHash hash = value.toHash();
+        for (auto it = hash.cbegin(); it != hash.cend(); ++it)
+            cost += it.key().size() * sizeof(QChar) + estimateCost(it.value());
+        break;
+    }
+    case QMetaType::QImage:
+        cost += static_cast<size_t>(qvariant_cast<QImage>(value).sizeInBytes());
+        break;
+    case QMetaType::QPixmap:
+    {
+        const QPixmap pixmap = qvariant_cast<QPixmap>(value);
+        cost += static_cast<size_t>(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+        break;
+    }
+    default:
+        cost += std::max(0, QMetaType::sizeOf(value.userType()));
+        break;
+    }
+    return cost;
+}
+
 
 QtCachingProxyModel::QtCachingProxyModel(QObject *parent)
     : QIdentityProxyModel(parent)
     , d(new QtCachingProxyModelPrivate)
 {
+    // Cache keys are row based, so any structural
+    // change of the model invalidates the cache
+    connect(this, &QAbstractItemModel::rowsInserted, this, &QtCachingProxyModel::clearCache);
+    connect(this, &QAbstractItemModel::rowsRemoved, this, &QtCachingProxyModel::clearCache);
+    connect(this, &QAbstractItemModel::rowsMoved, this, &QtCachingProxyModel::clearCache);
+    connect(this, &QAbstractItemModel::columnsInserted, this, &QtCachingProxyModel::clearCache);
+    connect(this, &QAbstractItemModel::columnsRemoved, this, &QtCachingProxyModel::clearCache);
+    connect(this, &QAbstractItemModel::columnsMoved, this, &QtCachingProxyModel::clearCache);
+    connect(this, &QAbstractItemModel::layoutChanged, this, &QtCachingProxyModel::clearCache);
+    connect(this, &QAbstractItemModel::modelReset, this, &QtCachingProxyModel::clearCache);
+    // Changed values are kept in cache until next update
+    connect(this, &QAbstractItemModel::dataChanged, this,
+            [this](const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles) {
+        d->markDirty(topLeft, bottomRight, roles);
+    });
 }
 
 QtCachingProxyModel::~QtCachingProxyModel()
@@ -98,8 +502,7 @@ void QtCachingProxyModel::setMaxCacheSize(int maxSize)
     if (maxSize < 0)
         maxSize = INT_MAX;
     d->maxCacheSize = static_cast<size_t>(maxSize);
-    while (d->cache.size() > d->maxCacheSize)
-        d->cache.erase(d->cache.begin()); // shrink cache to fit
+    d->shrink(); // shrink cache to fit
 }
 
 int QtCachingProxyModel::maxCacheSize() const
@@ -111,23 +514,64 @@ int QtCachingProxyModel::maxCacheSize() const
 int QtCachingProxyModel::cacheSize() const
 {
      
-    return static_cast<int>(d->cache.size());
+    return static_cast<int>(d->cache.size() + d->window.size());
+}
+
+void QtCachingProxyModel::setMaxCacheCost(qint64 maxCost)
+{
+    d->maxCacheCost = maxCost < 0 ? std::numeric_limits<size_t>::max() : static_cast<size_t>(maxCost);
+    d->shrink(); // shrink cache to fit
+    d->requestFirst = -1; // window is limited by the cost as well
+    d->requestLast = -2;
+}
+
+qint64 QtCachingProxyModel::maxCacheCost() const
+{
+    return d->maxCacheCost == std::numeric_limits<size_t>::max() ? -1 : static_cast<qint64>(d->maxCacheCost);
+}
+
+qint64 QtCachingProxyModel::cacheCost() const
+{
+    return static_cast<qint64>(d->cacheCost);
+}
+
+QtCacheStatistics QtCachingProxyModel::cacheStatistics() const
+{
+    QtCacheStatistics statistics = QtCacheStatistics::fromCounters(d->cache.statistics());
+    statistics.hits += d->prefetchHits;
+    return statistics;
+}
+
+void QtCachingProxyModel::resetCacheStatistics()
+{
+    d->cache.reset_statistics();
+    d->prefetchHits = 0;
 }
 
 void QtCachingProxyModel::setCachedColumn(int column)
 {
-     
-    if (d->column == column)
+    setCachedColumns(std::vector<int>(1, column));
+}
+
+int QtCachingProxyModel::cachedColumn() const
+{
+    return d->cachedColumns.empty() ? -1 : d->cachedColumns.front();
+}
+
+void QtCachingProxyModel::setCachedColumns(const std::vector<int>& columns)
+{
+    if (d->cachedColumns == columns)
         return;
 
     clearCache();
-    d->column = column;
+    d->cachedColumns = columns;
+    d->columnSlots = d->buildSlots(columns);
+    prefetchVisibleRows();
 }
 
-int QtCachingProxyModel::cachedColumn() const
+const std::vector<int>& QtCachingProxyModel::cachedColumns() const
 {
-     
-    return d->column;
+    return d->cachedColumns;
 }
 
 void QtCachingProxyModel::setCachedRoles(const std::vector<int> &roles)
@@ -138,6 +582,8 @@ void QtCachingProxyModel::setCachedRoles(const std::vector<int> &roles)
 
     clearCache();
     d->cachedRoles = roles;
+    d->roleSlots = d->buildSlots(roles);
+    prefetchVisibleRows();
 }
 
 const std::vector<int>& QtCachingProxyModel::cachedRoles() const
@@ -146,6 +592,50 @@ const std::vector<int>& QtCachingProxyModel::cachedRoles() const
     return d->cachedRoles;
 }
 
+void QtCachingProxyModel::setPrefetchView(QAbstractItemView* view)
+{
+    if (d->view == view)
+        return;
+
+    if (d->view)
+    {
+        d->view->viewport()->removeEventFilter(this);
+        disconnect(d->view->verticalScrollBar(), &QScrollBar::valueChanged, this, &QtCachingProxyModel::prefetchVisibleRows);
+        disconnect(d->view->verticalScrollBar(), &QScrollBar::rangeChanged, this, &QtCachingProxyModel::prefetchVisibleRows);
+    }
+
+    d->view = view;
+    d->resetWindow();
+
+    if (d->view)
+    {
+        d->view->viewport()->installEventFilter(this);
+        connect(d->view->verticalScrollBar(), &QScrollBar::valueChanged, this, &QtCachingProxyModel::prefetchVisibleRows);
+        connect(d->view->verticalScrollBar(), &QScrollBar::rangeChanged, this, &QtCachingProxyModel::prefetchVisibleRows);
+        prefetchVisibleRows();
+    }
+}
+
+QAbstractItemView* QtCachingProxyModel::prefetchView() const
+{
+    return d->view;
+}
+
+void QtCachingProxyModel::setPrefetchMargin(int rows)
+{
+    rows = std::max(0, rows);
+    if (d->prefetchMargin == rows)
+        return;
+
+    d->prefetchMargin = rows;
+    prefetchVisibleRows();
+}
+
+int QtCachingProxyModel::prefetchMargin() const
+{
+    return d->prefetchMargin;
+}
+
 void QtCachingProxyModel::setSourceModel(QAbstractItemModel *model)
 {
      
@@ -160,13 +650,16 @@ bool QtCachingProxyModel::setData(const QModelIndex &proxyIndex, const QVariant
      
     if (QIdentityProxyModel::setData(proxyIndex, value, role))
     {
-        const QVariant value = proxyIndex.data(role);
-        const quint64 idx = d->indexate(proxyIndex.row(), role);
-        auto it = d->cache.find(idx);
-        if (it != d->cache.end()) // cache hit
-            it->second = value;
-        else // cache miss
-            d->cacheValue(proxyIndex.row(), role, value);
+        const int columnSlot = d->columnSlot(proxyIndex.column());
+        const int roleSlot = d->roleSlot(role);
+        if (columnSlot < 0 || roleSlot < 0)
+            return true;
+
+        const quint64 key = d->indexate(proxyIndex.row(), columnSlot, roleSlot);
+        if (QVariant* cached = d->window.find(key))
+            *cached = QIdentityProxyModel::data(proxyIndex, role);
+        else
+            d->cacheValue(key, QIdentityProxyModel::data(proxyIndex, role));
         return true;
     }
     return false;
@@ -175,37 +668,196 @@ bool QtCachingProxyModel::setData(const QModelIndex &proxyIndex, const QVariant
 QVariant QtCachingProxyModel::data(const QModelIndex &proxyIndex, int role) const
 {
      
-    if (proxyIndex.isValid() && proxyIndex.column() == d->column && d->isCachedRole(role))
-    {
-        const quint64 idx = d->indexate(proxyIndex.row(), role);
-        auto it = d->cache.find(idx);
-        if (it != d->cache.end()) // cache hit
-            return it->second;
-        else // cache miss
-            return d->cacheValue(proxyIndex.row(), role, QIdentityProxyModel::data(proxyIndex, role));
-    }
-    return QIdentityProxyModel::data(proxyIndex, role);
+    if (!proxyIndex.isValid())
+        return QIdentityProxyModel::data(proxyIndex, role);
+
+    const int columnSlot = d->columnSlot(proxyIndex.column());
+    const int roleSlot = columnSlot < 0 ? -1 : d->roleSlot(role);
+    if (roleSlot < 0)
+        return QIdentityProxyModel::data(proxyIndex, role);
+
+    const quint64 key = d->indexate(proxyIndex.row(), columnSlot, roleSlot);
+    QVariant value;
+    if (d->lookup(key, value)) // cache hit
+        return value;
+    else // cache miss
+        return d->cacheValue(key, QIdentityProxyModel::data(proxyIndex, role));
 }
 
 void QtCachingProxyModel::clearCache()
 {
      
-    d->cache.clear();
+    d->clear();
+    if (d->view)
+        QTimer::singleShot(0, this, &QtCachingProxyModel::prefetchVisibleRows);
 }
 
 void QtCachingProxyModel::updateCache()
 {
-    // basic implementation does nothing
+    if (d->dirtyRows.isEmpty())
+        return;
+
+    // refresh only rows that was changed and still resides in
+    // cache, i.e. rows that was recently requested by views
+    int first = INT_MAX;
+    int last = -1;
+    const QSet<int> rows = std::move(d->dirtyRows);
+    d->dirtyRows.clear();
+    for (int row : rows)
+    {
+        bool refreshed = false;
+        if (d->isPrefetched(row))
+        {
+            d->fetchRow(sourceModel(), this, row, d->window);
+            refreshed = true;
+        }
+        else
+        {
+            for (size_t c = 0; c < d->cachedColumns.size(); ++c)
+            {
+                const QModelIndex proxyIndex = index(row, d->cachedColumns[c]);
+                for (size_t r = 0; r < d->cachedRoles.size(); ++r)
+                {
+                    const quint64 key = d->indexate(row, int(c), int(r));
+                    if (!d->cache.contains(key))
+                        continue;
+
+                    d->cacheValue(key, QIdentityProxyModel::data(proxyIndex, d->cachedRoles[r]));
+                    refreshed = true;
+                }
+            }
+        }
+        if (refreshed)
+        {
+            first = std::min(first, row);
+            last = std::max(last, row);
+        }
+    }
+
+    if (last < 0)
+        return;
+
+    const auto columns = std::minmax_element(d->cachedColumns.begin(), d->cachedColumns.end());
+    QScopedValueRollback<bool> guard(d->updating, true);
+    Q_EMIT dataChanged(index(first, *columns.first), index(last, *columns.second),
+                       QVector<int>(d->cachedRoles.begin(), d->cachedRoles.end()));
 }
 
 void QtCachingProxyModel::cacheIndex(const QModelIndex &index)
 {
      
-    if (index.isValid() && index.column() == d->column)
+    const int columnSlot = index.isValid() ? d->columnSlot(index.column()) : -1;
+    if (columnSlot < 0)
+        return;
+
+    for (size_t r = 0; r < d->cachedRoles.size(); ++r)
+        d->cacheValue(d->indexate(index.row(), columnSlot, int(r)), index.data(d->cachedRoles[r]));
+}
+
+void QtCachingProxyModel::prefetch(int firstRow, int lastRow)
+{
+    QAbstractItemModel* model = sourceModel();
+    if (!model || d->cachedColumns.empty() || d->cachedRoles.empty())
+        return;
+
+    const int rows = rowCount();
+    if (rows == 0)
+    {
+        d->resetWindow();
+        return;
+    }
+
+    // the window never holds more values than the cache may keep: the
+    // visible rows go first, margins get what's left of the limits
+    // once the values already cached are counted
+    const size_t rowSize = d->cachedColumns.size() * d->cachedRoles.size();
+    const int maxRows = static_cast<int>(std::min<size_t>(INT_MAX, std::max<size_t>(1, d->maxCacheSize / rowSize)));
+    const int visibleFirst = qBound(0, firstRow, rows - 1);
+    const int visibleLast = qBound(visibleFirst, lastRow, std::min(rows - 1, visibleFirst + maxRows - 1));
+    const size_t used = d->cache.size() + size_t(visibleLast - visibleFirst + 1) * rowSize;
+    const size_t spareRows = used < d->maxCacheSize ? (d->maxCacheSize - used) / rowSize : 0;
+    const int margin = static_cast<int>(std::min<size_t>(std::max(0, d->prefetchMargin), spareRows / 2));
+    const int requestFirst = std::max(0, visibleFirst - margin);
+    const int requestLast = std::min(rows - 1, visibleLast + margin);
+    if (requestFirst == d->requestFirst && requestLast == d->requestLast)
+        return;
+
+    QtPrefetchTable window = std::move(d->window);
+    QtPrefetchTable table;
+    table.reserve(size_t(visibleLast - visibleFirst + 1 + 2 * margin) * rowSize);
+
+    // values of rows that are already prefetched are kept,
+    // the source model is queried only for the new rows
+    const bool costLimited = d->maxCacheCost != std::numeric_limits<size_t>::max();
+    size_t cost = 0;
+    auto addRow = [&](int row)
+    {
+        if (d->isPrefetched(row))
+        {
+            for (size_t c = 0; c < d->cachedColumns.size(); ++c)
+            {
+                for (size_t r = 0; r < d->cachedRoles.size(); ++r)
+                {
+                    const quint64 key = d->indexate(row, int(c), int(r));
+                    if (QVariant* value = window.find(key))
+                        table.insert(key, std::move(*value));
+                }
+            }
+        }
+        else
+        {
+            d->fetchRow(model, this, row, table);
+        }
+
+        if (!costLimited)
+            return;
+
+        for (size_t c = 0; c < d->cachedColumns.size(); ++c)
+            for (size_t r = 0; r < d->cachedRoles.size(); ++r)
+                if (const QVariant* value = table.find(d->indexate(row, int(c), int(r))))
+                    cost += d->estimateCost(*value);
+    };
+
+    for (int row = visibleFirst; row <= visibleLast; ++row)
+        addRow(row);
+
+    int first = visibleFirst;
+    int last = visibleLast;
+    auto hasSpareCost = [&]() { return !costLimited || d->cacheCost + cost <= d->maxCacheCost; };
+    for (int i = 1; i <= margin && hasSpareCost(); ++i)
     {
-        for (auto role : d->cachedRoles)
-            d->cacheValue(index.row(), role, index.data(role));
+        // rows below go first, since views are mostly scrolled down
+        if (visibleLast + i < rows)
+            addRow(last = visibleLast + i);
+        if (visibleFirst - i >= 0 && hasSpareCost())
+            addRow(first = visibleFirst - i);
     }
+
+    d->window = std::move(table);
+    d->windowCost = cost;
+    d->windowFirst = first;
+    d->windowLast = last;
+    d->requestFirst = requestFirst;
+    d->requestLast = requestLast;
+    d->shrink(); // visible rows take the place of least recently used values
+}
+
+void QtCachingProxyModel::prefetchVisibleRows()
+{
+    QAbstractItemView* view = d->view;
+    if (!view || view->model() != this)
+        return;
+
+    // nothing is laid out yet (or the view is empty): guessing the
+    // rows would mean to fetch the whole model on the GUI thread
+    const QRect rect = view->viewport()->rect();
+    const QModelIndex top = view->indexAt(rect.topLeft());
+    if (!top.isValid())
+        return;
+
+    // rows don't fill the viewport, so the last row is visible
+    const QModelIndex bottom = view->indexAt(rect.bottomLeft());
+    prefetch(top.row(), bottom.isValid() ? bottom.row() : rowCount() - 1);
 }
 
 void QtCachingProxyModel::timerEvent(QTimerEvent *event)
@@ -216,3 +868,11 @@ void QtCachingProxyModel::timerEvent(QTimerEvent *event)
 
     QIdentityProxyModel::timerEvent(event);
 }
+
+bool QtCachingProxyModel::eventFilter(QObject* watched, QEvent* event)
+{
+    if (d->view && watched == d->view->viewport() && event->type() == QEvent::Resize)
+        prefetchVisibleRows();
+
+    return QIdentityProxyModel::eventFilter(watched, event);
+}
@@ -2,6 +2,9 @@
 #include <QIdentityProxyModel>
 
 #include <QtWidgetsExtra>
+#include <QtCacheStatistics>
+
+class QAbstractItemView;
 
 class QTWIDGETSEXTRA_EXPORT QtCachingProxyModel :
         public QIdentityProxyModel
@@ -29,12 +32,35 @@ public:
 
     int cacheSize() const;
 
+    // limit of estimated memory (in bytes) occupied by cached
+    // values, negative value means unlimited cache cost
+    void setMaxCacheCost(qint64 maxCost);
+    qint64 maxCacheCost() const;
+
+    qint64 cacheCost() const;
+
+    // counters of the values cache, hits include values served from
+    // prefetched rows, bytes are the estimated cost of cached values
+    QtCacheStatistics cacheStatistics() const;
+    void resetCacheStatistics();
+
     void setCachedColumn(int column);
     int cachedColumn() const;
 
+    void setCachedColumns(const std::vector<int>& columns);
+    const std::vector<int>& cachedColumns() const;
+
     void setCachedRoles(const std::vector<int>& roles);
     const std::vector<int>& cachedRoles() const;
 
+    // view which visible rows drives the prefetching
+    void setPrefetchView(QAbstractItemView* view);
+    QAbstractItemView* prefetchView() const;
+
+    // number of rows prefetched above and below the visible rows
+    void setPrefetchMargin(int rows);
+    int prefetchMargin() const;
+
     void setSourceModel(QAbstractItemModel* model) Q_DECL_OVERRIDE;
 
     bool setData(const QModelIndex &index, const QVariant &value, int role) Q_DECL_OVERRIDE;
@@ -44,9 +70,12 @@ public Q_SLOTS:
     void clearCache();
     virtual void updateCache();
     virtual void cacheIndex(const QModelIndex& index);
+    void prefetch(int firstRow, int lastRow);
+    void prefetchVisibleRows();
 
 protected:
     void timerEvent(QTimerEvent* event) Q_DECL_OVERRIDE;
+    bool eventFilter(QObject* watched, QEvent* event) Q_DECL_OVERRIDE;
 
 private:
     QScopedPointer<class QtCachingProxyModelPrivate> d;
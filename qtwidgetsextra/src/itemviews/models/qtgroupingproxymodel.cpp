@@ -1,12 +1,21 @@
 #include <QModelIndex>
 #include <QVariant>
 #include <QPointer>
+#include <QBitArray>
+#include <QHash>
+#include <QtAlgorithms>
 #include <memory>
 #include <unordered_map>
+#include <map>
 #include <deque>
 #include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <IndexSet> // from Qt5Extra aux
 
 #include "qtitemfilter.h"
+#include "qtitemfilterengine.h"
 #include "qtgroupingproxymodel.h"
 
 namespace
@@ -68,6 +77,37 @@ namespace
         std::unique_ptr<QtAbstractItemFilter> filter_;
     };
 
+    // adapts custom delegates to QtItemFilterEngine, they are
+    // matched on the model thread through the whole index
+    class DelegateItemFilter : public QtAbstractItemFilter
+    {
+    public:
+        explicit DelegateItemFilter(const QtGroupItemDataDelegate* _delegate)
+            : delegate_(_delegate)
+        {
+            Q_ASSERT(delegate_ != Q_NULLPTR);
+        }
+
+        bool accepted(const QModelIndex& _index) const Q_DECL_OVERRIDE
+        {
+            return delegate_->match(_index);
+        }
+
+        bool isRoleSupported(int /*role*/) const Q_DECL_OVERRIDE
+        {
+            return true;
+        }
+
+    protected:
+        bool accepts(const QVariant& /*v*/) const Q_DECL_OVERRIDE
+        {
+            return false;
+        }
+
+    private:
+        const QtGroupItemDataDelegate* delegate_;
+    };
+
     class CountingIterator
     {
     public:
@@ -123,13 +163,152 @@ public:
         QtGroupingProxyModel* proxy_;
     };
 
+    //
+    // Index of group membership: for every source row keeps the
+    // set of groups the row belongs to. Groups are identified by
+    // slots, which are stable while the group exists, thus
+    // insertion or removal of groups doesn't touch the index.
+    //
+    class GroupMembership
+    {
+    public:
+        int allocate()
+        {
+            if (!freeSlots_.empty())
+            {
+                const int slot = freeSlots_.back();
+                freeSlots_.pop_back();
+                return slot;
+            }
+            if (slotCount_ == stride_ * 64)
+                restride(stride_ * 2);
+            return slotCount_++;
+        }
+
+        // all bits of slot must be cleared before release
+        void release(int _slot)
+        {
+            freeSlots_.push_back(_slot);
+        }
+
+        int slotCount() const
+        {
+            return slotCount_;
+        }
+
+        int rowCount() const
+        {
+            return rows_;
+        }
+
+        void reset(int _rows)
+        {
+            rows_ = _rows;
+            bits_.assign(size_t(rows_) * stride_, 0);
+        }
+
+        void insertRows(int _first, int _count)
+        {
+            if (_first < 0 || _first > rows_ || _count <= 0)
+                return;
+            bits_.insert(bits_.begin() + size_t(_first) * stride_, size_t(_count) * stride_, 0);
+            rows_ += _count;
+        }
+
+        void removeRows(int _first, int _count)
+        {
+            _count = std::min(_count, rows_ - _first);
+            if (_first < 0 || _count <= 0)
+                return;
+            auto first = bits_.begin() + size_t(_first) * stride_;
+            bits_.erase(first, first + size_t(_count) * stride_);
+            rows_ -= _count;
+        }
+
+        void set(int _row, int _slot, bool _on = true)
+        {
+            if (_row < 0 || _row >= rows_)
+                return;
+            quint64& word = bits_[size_t(_row) * stride_ + (_slot >> 6)];
+            const quint64 mask = quint64(1) << (_slot & 63);
+            word = _on ? (word | mask) : (word & ~mask);
+        }
+
+        bool test(int _row, int _slot) const
+        {
+            if (_row < 0 || _row >= rows_)
+                return false;
+            return (bits_[size_t(_row) * stride_ + (_slot >> 6)] >> (_slot & 63)) & 1;
+        }
+
+        template<class _Fn>
+        void forEach(int _row, _Fn&& _fn) const
+        {
+            if (_row < 0 || _row >= rows_)
+                return;
+            const quint64* words = bits_.data() + size_t(_row) * stride_;
+            for (int i = 0; i < stride_; ++i)
+            {
+                for (quint64 word = words[i]; word != 0; word &= word - 1)
+                    _fn(i * 64 + qCountTrailingZeroBits(word));
+            }
+        }
+
+    private:
+        void restride(int _stride)
+        {
+            std::vector<quint64> bits(size_t(rows_) * _stride, 0);
+            for (size_t row = 0; row < size_t(rows_); ++row)
+                std::copy_n(bits_.begin() + row * stride_, stride_, bits.begin() + row * _stride);
+            bits_.swap(bits);
+            stride_ = _stride;
+        }
+
+        std::vector<quint64> bits_;
+        std::vector<int> freeSlots_;
+        int stride_ = 1;
+        int slotCount_ = 0;
+        int rows_ = 0;
+    };
+
     class GroupItem
     {
     public:
-        explicit GroupItem(QtGroupItemDataDelegate* _delegate = nullptr)
+        GroupItem(QtGroupItemDataDelegate* _delegate, GroupMembership* _membership)
             : delegate_(_delegate)
+            , membership_(_membership)
+            , slot_(_membership->allocate())
         {}
 
+        GroupItem(GroupItem&& _other) noexcept
+            : delegate_(std::move(_other.delegate_))
+            , rows_(std::move(_other.rows_))
+            , membership_(_other.membership_)
+            , slot_(std::exchange(_other.slot_, -1))
+            , checkedCount_(_other.checkedCount_)
+            , cachedFlags_(_other.cachedFlags_)
+        {}
+
+        GroupItem& operator=(GroupItem&& _other) noexcept
+        {
+            if (this == &_other)
+                return *this;
+
+            detach();
+            delegate_ = std::move(_other.delegate_);
+            rows_ = std::move(_other.rows_);
+            membership_ = _other.membership_;
+            slot_ = std::exchange(_other.slot_, -1);
+            checkedCount_ = _other.checkedCount_;
+            cachedFlags_ = _other.cachedFlags_;
+            return *this;
+        }
+
+        ~GroupItem()
+        {
+            detach();
+        }
+
         bool operator== (const QtGroupItemDataDelegate* _delegate) const
         {
             return delegate_.get() == _delegate;
@@ -155,14 +334,33 @@ public:
             return delegate_.get();
         }
 
+        // filter that can be evaluated in batch by QtItemFilterEngine,
+        // custom delegates are matched only with match() method
+        const QtAbstractItemFilter* filter() const
+        {
+            auto filterDelegate = dynamic_cast<const FilterGroupItemDelegate*>(delegate_.get());
+            return filterDelegate ? filterDelegate->filter() : nullptr;
+        }
+
+        int slot() const
+        {
+            return slot_;
+        }
+
+        template<class _Fn>
+        void forEachRow(_Fn&& _fn) const
+        {
+            rows_.forEach(std::forward<_Fn>(_fn));
+        }
+
         bool isEmpty() const
         {
-            return sourceRowMap_.empty();
+            return rows_.empty();
         }
 
         int childCount() const
         {
-            return static_cast<int>(sourceRowMap_.size());
+            return rows_.size();
         }
 
         bool match(const QModelIndex& index) const
@@ -185,12 +383,12 @@ public:
                 return cachedFlags_;
 
             Qt::ItemFlags itemFlags = Qt::ItemIsEnabled;
-            for (int row : sourceRowMap_)
+            rows_.forEach([&](int row)
             {
                 const QModelIndex index = model->index(row, _proxy->groupColumn());
                 if (index.isValid())
                     itemFlags |= index.flags();
-            }
+            });
             // update cached flags
             cachedFlags_ = itemFlags;
             return itemFlags;
@@ -234,19 +432,20 @@ public:
 
             ModelDataChangeLocker locker(_proxy);
             int successCount = 0;
-            for (int row : sourceRowMap_)
+            rows_.forEach([&](int row)
             {
                 const QModelIndex index = sourceModel->index(row, column);
                 if (index.isValid())
                     successCount += sourceModel->setData(index, _value, _role);
-            }
+            });
             checkedCount_ = checked ? successCount : childCount() - successCount;
             return true;
         }
 
         void clear()
         {
-            sourceRowMap_.clear();
+            clearMembership();
+            rows_.clear();
             checkedCount_ = 0;
         }
 
@@ -255,92 +454,110 @@ public:
             checkedCount_ = 0;
             QAbstractItemModel* model = _proxy->sourceModel();
             const int column = _proxy->groupColumn();
-            for (int sourceRow : sourceRowMap_)
+            rows_.forEach([&](int sourceRow)
+            {
                 checkedCount_ += isChecked(model->index(sourceRow, column));
+            });
             clearFlags();
         }
 
-        bool push(QtGroupingProxyModel* _proxy, int _groupIdx, const QModelIndex& _sourceIndex, bool _matchRequired = true)
+        // replace source rows without any notifications
+        void reset(const QBitArray& _rows)
         {
-#ifdef _DEBUG
-            if (!sourceRowMap_.empty())
-                Q_ASSERT(_sourceIndex.row() > sourceRowMap_.back());
-#endif
-            if (_matchRequired && !match(_sourceIndex))
-                return false;
-
-            const int i = static_cast<int>(sourceRowMap_.size());
-            _proxy->beginInsertRows(_proxy->index(_groupIdx, 0), i, i);
-            sourceRowMap_.emplace_back(_sourceIndex.row());
-            _proxy->endInsertRows();
-            checkedCount_ += isChecked(_sourceIndex);
-            return true;
+            clearMembership();
+            std::vector<int> rows;
+            for (int row = 0, n = _rows.size(); row < n; ++row)
+            {
+                if (!_rows.testBit(row))
+                    continue;
+                rows.push_back(row);
+                membership_->set(row, slot_);
+            }
+            rows_.assign(rows.begin(), rows.end());
         }
 
         int update(const QModelIndex& _sourceIndex, bool _matchRequired = true)
         {
             const int srcRow = _sourceIndex.row();
-            auto it = std::lower_bound(sourceRowMap_.begin(), sourceRowMap_.end(), srcRow);
             if (_matchRequired && !match(_sourceIndex))
             {
-                if (it != sourceRowMap_.end() && *it == srcRow) // doesn't match any more
-                    sourceRowMap_.erase(it);
+                if (rows_.erase(srcRow) != Qt5Extra::IndexSet::npos) // doesn't match any more
+                    membership_->set(srcRow, slot_, false);
                 return -1;
             }
 
-            if (it != sourceRowMap_.end() && *it == srcRow)
-                return std::distance(sourceRowMap_.begin(), it);
-
-            it = sourceRowMap_.insert(it, srcRow);
-            return std::distance(sourceRowMap_.begin(), it);
+            const auto result = rows_.insert(srcRow);
+            if (result.second)
+                membership_->set(srcRow, slot_);
+            return result.first;
         }
 
         bool contains(const QModelIndex& _sourceIndex) const
         {
-            return std::binary_search(sourceRowMap_.begin(), sourceRowMap_.end(), _sourceIndex.row());
+            return membership_->test(_sourceIndex.row(), slot_);
         }
 
         int rank(const QModelIndex& _sourceIndex) const
         {
-            const int row = _sourceIndex.row();
-            auto it = std::lower_bound(sourceRowMap_.cbegin(), sourceRowMap_.cend(), row);
-            return (it != sourceRowMap_.cend() && *it == row) ? std::distance(sourceRowMap_.begin(), it) : -1;
+            return rows_.indexOf(_sourceIndex.row());
+        }
+
+        // proxy row the source row is placed at
+        int lowerBound(int _sourceRow) const
+        {
+            return rows_.lowerBound(_sourceRow);
+        }
+
+        void insertRow(int _sourceRow)
+        {
+            if (rows_.insert(_sourceRow).second)
+                membership_->set(_sourceRow, slot_);
+        }
+
+        void eraseRow(int _sourceRow)
+        {
+            if (rows_.erase(_sourceRow) != Qt5Extra::IndexSet::npos)
+                membership_->set(_sourceRow, slot_, false);
         }
 
         int sourceRow(int _proxyRow) const
         {
             if (_proxyRow < 0 || _proxyRow >= childCount())
                 return -1;
-            return sourceRowMap_[_proxyRow];
+            return rows_.at(_proxyRow);
         }
 
-        void swapRows(std::deque<int>& _rows) noexcept
+        std::vector<int> takeRows()
         {
-            std::swap(_rows, sourceRowMap_);
+            std::vector<int> rows = rows_.toVector();
+            clear();
+            return rows;
         }
 
-        void removeSourceRows(int _groupRow, int _first, int _last, QtGroupingProxyModel* _proxy)
+        // shift rows following inserted source rows,
+        // membership of inserted rows is empty
+        void insertSourceRows(int _first, int _count)
         {
-            if (sourceRowMap_.empty() || _first >= _last)
-                return;
+            rows_.shift(_first, _count);
+        }
 
-            if (_first > sourceRowMap_.back())
+        // remove source rows in range [_first, _last) and shift following rows,
+        // membership of removed rows is dropped by the membership index itself
+        void removeSourceRows(int _groupRow, int _first, int _last, QtGroupingProxyModel* _proxy)
+        {
+            if (rows_.empty() || _first >= _last)
                 return;
 
-            const int d = _last - _first;
-            auto lowerIt = std::lower_bound(sourceRowMap_.begin(), sourceRowMap_.end(), _first);
-            auto upperIt = std::upper_bound(lowerIt, sourceRowMap_.end(), _last - 1);
-            if (lowerIt != upperIt)
+            const int rowFirst = rows_.lowerBound(_first);
+            const int rowLast = rows_.lowerBound(_last);
+            if (rowFirst != rowLast)
             {
                 const QModelIndex parent = _proxy->index(_groupRow, 0);
-                const int rowFirst = std::distance(sourceRowMap_.begin(), lowerIt);
-                const int rowLast = std::distance(sourceRowMap_.begin(), upperIt);
-                _proxy->beginRemoveRows(parent, rowFirst, std::max(0, rowLast - 1));
-                sourceRowMap_.erase(lowerIt, upperIt);
+                _proxy->beginRemoveRows(parent, rowFirst, rowLast - 1);
+                rows_.erase(_first, _last);
                 _proxy->endRemoveRows();
             }
-            auto it = std::lower_bound(sourceRowMap_.begin(), sourceRowMap_.end(), _last - 1);
-            std::transform(it, sourceRowMap_.end(), it, [d](int r) { return r - d; });
+            rows_.shift(_last, _first - _last);
         }
 
     private:
@@ -349,9 +566,25 @@ public:
             return (delegate_ ? delegate_->data(_role) : _proxy->ungroppedData(_role));
         }
 
+        void clearMembership()
+        {
+            rows_.forEach([this](int row) { membership_->set(row, slot_, false); });
+        }
+
+        void detach()
+        {
+            if (slot_ == -1)
+                return;
+            clearMembership();
+            membership_->release(slot_);
+            slot_ = -1;
+        }
+
     private:
         std::unique_ptr<QtGroupItemDataDelegate> delegate_;
-        std::deque<int> sourceRowMap_;
+        Qt5Extra::IndexSet rows_;
+        GroupMembership* membership_ = nullptr;
+        int slot_ = -1;
         int checkedCount_ = 0;
         mutable Qt::ItemFlags cachedFlags_ = Qt::NoItemFlags;
     };
@@ -367,7 +600,29 @@ public:
     using GroupMap = std::deque<GroupItem>;
 
     DataMap ungrouppedDataMap_;
+    GroupMembership membership_; // must outlive groups
     GroupMap groups_;
+    QtItemFilterEngine engine_;
+
+    // groups evaluated by the engine in time slices, their
+    // rows are replaced by results with single layout change
+    std::vector<const QtGroupItemDataDelegate*> pendingGroups_;
+    std::vector<std::unique_ptr<QtAbstractItemFilter>> pendingAdapters_;
+    int evaluatedRows_ = 0;
+
+    // lookup of group positions, rebuilt
+    // lazily after groups were changed
+    mutable QHash<QString, int> namePositions_;
+    mutable QHash<const QtGroupItemDataDelegate*, int> delegatePositions_;
+    mutable std::vector<int> slotPositions_;
+    mutable bool positionsValid_ = false;
+
+    // source rows changed since the last update of groups
+    std::vector<int> dirtyRows_;
+    QVector<int> dirtyRoles_;
+    bool dirtyAllRoles_ = false;
+    bool updatePending_ = false;
+
     QPointer<QAbstractItemModel> model_;
     QtGroupingProxyModel* q = nullptr;
     QtGroupingProxyModel::UngrouppedPolicy ungrouppedPolicy_ = QtGroupingProxyModel::UngrouppedAutoHide;
@@ -386,19 +641,108 @@ public:
         return it != groups_.end() ? q->index(std::distance(groups_.begin(), it), 0, {}) : QModelIndex{};
     }
 
-    auto findGroup(const QString& _name) const
+    void invalidatePositions()
+    {
+        positionsValid_ = false;
+    }
+
+    void updatePositions() const
+    {
+        if (positionsValid_)
+            return;
+
+        namePositions_.clear();
+        delegatePositions_.clear();
+        slotPositions_.assign(membership_.slotCount(), -1);
+        for (int i = static_cast<int>(groups_.size()) - 1; i >= 0; --i)
+        {
+            const GroupItem& group = groups_[i];
+            // the first group wins among groups with the same name
+            if (group.delegate())
+                namePositions_.insert(group.delegate()->data(Qt::DisplayRole).toString(), i);
+            delegatePositions_.insert(group.delegate(), i);
+            slotPositions_[group.slot()] = i;
+        }
+        positionsValid_ = true;
+    }
+
+    int groupPosition(const QString& _name) const
+    {
+        updatePositions();
+        auto it = namePositions_.constFind(_name);
+        if (it != namePositions_.cend() && groups_[*it] == _name)
+            return *it;
+
+        // title may be changed by the delegate itself
+        auto groupIt = std::find(groups_.begin(), groups_.end(), _name);
+        if (groupIt == groups_.end())
+            return -1;
+
+        invalidatePositions();
+        return static_cast<int>(std::distance(groups_.begin(), groupIt));
+    }
+
+    int groupPosition(const QtGroupItemDataDelegate* _delegate) const
     {
-        return std::find(groups_.begin(), groups_.end(), _name);
+        updatePositions();
+        return delegatePositions_.value(_delegate, -1);
     }
 
-    auto findGroup(const QtGroupItemDataDelegate* _delegate) const
+    GroupMap::const_iterator findGroup(const QString& _name) const
     {
-        return std::find(groups_.begin(), groups_.end(), _delegate);
+        const int i = groupPosition(_name);
+        return i != -1 ? groups_.begin() + i : groups_.end();
     }
 
-    auto findGroup(const QtGroupItemDataDelegate* _delegate)
+    GroupMap::const_iterator findGroup(const QtGroupItemDataDelegate* _delegate) const
     {
-        return std::find(groups_.begin(), groups_.end(), _delegate);
+        const int i = groupPosition(_delegate);
+        return i != -1 ? groups_.begin() + i : groups_.end();
+    }
+
+    GroupMap::iterator findGroup(const QtGroupItemDataDelegate* _delegate)
+    {
+        const int i = groupPosition(_delegate);
+        return i != -1 ? groups_.begin() + i : groups_.end();
+    }
+
+    // position of the first group containing source row
+    int sourceRowGroup(int _sourceRow) const
+    {
+        updatePositions();
+        int position = -1;
+        membership_.forEach(_sourceRow, [&](int slot)
+        {
+            const int i = slotPositions_[slot];
+            if (position == -1 || i < position)
+                position = i;
+        });
+        return position;
+    }
+
+    int groupPosition(const GroupItem& _group) const
+    {
+        updatePositions();
+        return slotPositions_[_group.slot()];
+    }
+
+    GroupMap::iterator emplaceGroup(GroupMap::const_iterator _pos, QtGroupItemDataDelegate* _delegate)
+    {
+        invalidatePositions();
+        return groups_.emplace(_pos, _delegate, &membership_);
+    }
+
+    void eraseGroupAt(GroupMap::const_iterator _pos)
+    {
+        invalidatePositions();
+        groups_.erase(_pos);
+    }
+
+    void clearAllGroups()
+    {
+        cancelEvaluation(); // filters are destroyed along with groups
+        invalidatePositions();
+        groups_.clear();
     }
 
     int eraseGroup(const QString& name)
@@ -407,7 +751,7 @@ public:
         if (it == groups_.end())
             return 0;
 
-        groups_.erase(it);
+        eraseGroupAt(it);
         return 1;
     }
 
@@ -417,7 +761,7 @@ public:
         if (it == groups_.end())
             return 0;
 
-        groups_.erase(it);
+        eraseGroupAt(it);
         return 1;
     }
 
@@ -430,41 +774,245 @@ public:
         }
     }
 
-    void resetGroups()
+    int sourceRowCount() const
     {
-        // block signals (like begin[Insert/Remove]Rows()) from
-        // proxy model since resetGroups() method always called
-        // in [begin/end]ResetModel() wrapped code
-        QSignalBlocker blocker(q);
-        clearGroups();
+        // rows of invalid group column never belong to any group
+        return (column_ >= 0 && column_ < model_->columnCount() ? model_->rowCount() : 0);
+    }
+
+    // filters evaluating the groups, custom delegates are adapted
+    // into _adapters, uncategorized group has no filter
+    static std::vector<const QtAbstractItemFilter*> groupFilters(const std::vector<const GroupItem*>& _groups,
+                                                                 std::vector<std::unique_ptr<QtAbstractItemFilter>>& _adapters)
+    {
+        std::vector<const QtAbstractItemFilter*> filters;
+        filters.reserve(_groups.size());
+        for (const GroupItem* group : _groups)
+        {
+            const QtAbstractItemFilter* filter = group->filter();
+            if (!filter && group->delegate())
+            {
+                _adapters.emplace_back(new DelegateItemFilter(group->delegate()));
+                filter = _adapters.back().get();
+            }
+            filters.push_back(filter);
+        }
+        return filters;
+    }
+
+    // bit k of result[i] is set if source row _first + k matches _groups[i]
+    std::vector<QBitArray> matchGroups(const std::vector<const GroupItem*>& _groups, int _first, int _last) const
+    {
+        const int n = std::max(0, _last - _first + 1);
+        std::vector<std::unique_ptr<QtAbstractItemFilter>> adapters;
+        const std::vector<const QtAbstractItemFilter*> filters = groupFilters(_groups, adapters);
+
+        // evaluate all filters at once: values are snapshotted
+        // here and filters are evaluated on the thread pool
+        std::vector<QBitArray> matches;
+        engine_.evaluate(model_, column_, _first, _first + n - 1, filters, matches);
+
+        // uncategorized group matches nothing
+        for (size_t i = 0; i < _groups.size(); ++i)
+        {
+            if (!filters[i])
+                matches[i].fill(false);
+        }
+        return matches;
+    }
+
+    // (re)starts evaluation of pending groups and _delegates over
+    // all source rows, results are published by publishGroups()
+    void evaluateGroups(const std::vector<const QtGroupItemDataDelegate*>& _delegates = {})
+    {
+        engine_.cancel();
+        pendingAdapters_.clear();
+        for (const QtGroupItemDataDelegate* delegate : _delegates)
+        {
+            if (std::find(pendingGroups_.begin(), pendingGroups_.end(), delegate) == pendingGroups_.end())
+                pendingGroups_.push_back(delegate);
+        }
+
+        if (pendingGroups_.empty() || identity_ || !model_)
+        {
+            pendingGroups_.clear();
+            return;
+        }
+
+        std::vector<const GroupItem*> items;
+        items.reserve(pendingGroups_.size());
+        for (const QtGroupItemDataDelegate* delegate : pendingGroups_)
+            items.push_back(std::addressof(*findGroup(delegate)));
+
+        evaluatedRows_ = sourceRowCount();
+        engine_.evaluateAsync(model_, column_, 0, evaluatedRows_ - 1, groupFilters(items, pendingAdapters_), q,
+                              [this](std::vector<QBitArray>& _matches) { publishGroups(_matches); });
+    }
+
+    // rows evaluated so far are shifted by the change of source rows
+    void restartEvaluation(int _firstChanged)
+    {
+        if (!pendingGroups_.empty() && _firstChanged < evaluatedRows_)
+            evaluateGroups();
+    }
+
+    void cancelEvaluation()
+    {
+        engine_.cancel();
+        pendingGroups_.clear();
+        pendingAdapters_.clear();
+    }
+
+    // replaces rows of evaluated groups and uncategorized group
+    // with single layout change, persistent indexes follow rows
+    void publishGroups(std::vector<QBitArray>& _matches)
+    {
+        std::vector<const QtGroupItemDataDelegate*> delegates;
+        delegates.swap(pendingGroups_);
+        pendingAdapters_.clear();
+
+        Q_EMIT q->layoutAboutToBeChanged();
+
+        // persistent indexes are kept by group slots and source rows,
+        // source row is -1 for group items
+        const QModelIndexList from = q->persistentIndexList();
+        std::vector<std::pair<int, int>> anchors;
+        anchors.reserve(from.size());
+        for (const QModelIndex& index : from)
+        {
+            if (index.internalId() == quintptr(-1))
+            {
+                anchors.emplace_back(groups_[index.row()].slot(), -1);
+                continue;
+            }
+
+            const GroupItem& group = groups_[index.internalId()];
+            const int sourceRow = group.sourceRow(index.row());
+            anchors.emplace_back(sourceRow != -1 ? group.slot() : -1, sourceRow);
+        }
+
+        // rows appended while groups were evaluated are matched here
+        const int nrows = sourceRowCount();
+        const int evaluated = std::min(evaluatedRows_, nrows);
+        std::vector<const GroupItem*> items;
+        items.reserve(delegates.size());
+        for (const QtGroupItemDataDelegate* delegate : delegates)
+            items.push_back(std::addressof(*findGroup(delegate)));
+
+        const std::vector<QBitArray> appended = matchGroups(items, evaluated, nrows - 1);
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            QBitArray& rows = _matches[i];
+            rows.resize(nrows);
+            for (int row = evaluated; row < nrows; ++row)
+                rows.setBit(row, appended[i].testBit(row - evaluated));
+            findGroup(delegates[i])->reset(rows);
+        }
 
-        // ensure that we remove previous uncategorized group if policy was changed
         if (ungrouppedPolicy_ == QtGroupingProxyModel::UngrouppedAlwaysOff)
             eraseGroup(nullptr);
 
-        // Create uncategorized group if it must be
-        // created and it isn't created already
         std::pair<GroupItem*, int> uncategorized = createUncategorizedGroup();
+        if (uncategorized.first)
+            uncategorized.first->reset(uncategorizedRows());
+
+        for (auto& group : groups_)
+            group.resetChecked(q);
 
-        // push indices into groups
-        for (int row = 0, n = model_->rowCount(); row < n; ++row)
+        if (uncategorized.first && uncategorized.first->isEmpty() &&
+            ungrouppedPolicy_ == QtGroupingProxyModel::UngrouppedAutoHide)
+            eraseGroupAt(groups_.begin() + uncategorized.second);
+
+        updatePositions();
+        QModelIndexList to;
+        to.reserve(from.size());
+        for (int i = 0; i < from.size(); ++i)
         {
-            const QModelIndex index = model_->index(row, column_);
-            if (!index.isValid())
+            const int slot = anchors[i].first;
+            const int sourceRow = anchors[i].second;
+            const int position = slot >= 0 && slot < static_cast<int>(slotPositions_.size()) ? slotPositions_[slot] : -1;
+            if (position == -1)
+                to.append(QModelIndex{});
+            else if (sourceRow == -1)
+                to.append(q->index(position, from[i].column()));
+            else if (membership_.test(sourceRow, slot))
+                to.append(q->index(groups_[position].lowerBound(sourceRow), from[i].column(), q->index(position, 0)));
+            else
+                to.append(QModelIndex{});
+        }
+        q->changePersistentIndexList(from, to);
+
+        Q_EMIT q->layoutChanged();
+
+        // changes deferred while groups were evaluated
+        if (!dirtyRows_.empty() && !updatePending_)
+        {
+            updatePending_ = true;
+            QMetaObject::invokeMethod(q, [this]() { updateDirtyRows(); }, Qt::QueuedConnection);
+        }
+    }
+
+    QBitArray uncategorizedRows() const
+    {
+        const int n = sourceRowCount();
+        QBitArray rows(n, true);
+        for (const auto& group : groups_)
+        {
+            if (!group.delegate())
                 continue;
 
-            int matchCount = 0;
-            for (int i = 0, k = groups_.size(); i < k; ++i)
-                matchCount += groups_[i].push(q, i, index);
+            group.forEachRow([&rows, n](int row)
+            {
+                if (row < n)
+                    rows.clearBit(row);
+            });
+        }
+        return rows;
+    }
 
-            if (matchCount == 0 && uncategorized.first)
-                uncategorized.first->push(q, uncategorized.second, index, false);
+    void resetGroups()
+    {
+        // resetGroups() method always called in [begin/end]ResetModel()
+        // wrapped code, so group rows are replaced without notifications
+        cancelEvaluation();
+        clearGroups();
+        membership_.reset(model_->rowCount());
+
+        // ensure that we remove previous uncategorized group if policy was changed
+        if (ungrouppedPolicy_ == QtGroupingProxyModel::UngrouppedAlwaysOff)
+            eraseGroup(nullptr);
+
+        // groups are filled once their filters are evaluated, rows
+        // are not shown as uncategorized until then
+        std::vector<const QtGroupItemDataDelegate*> delegates;
+        for (const auto& group : groups_)
+        {
+            if (group.delegate())
+                delegates.push_back(group.delegate());
+        }
+        if (!delegates.empty())
+        {
+            if (ungrouppedPolicy_ == QtGroupingProxyModel::UngrouppedAutoHide)
+                eraseGroup(nullptr);
+            else
+                createUncategorizedGroup();
+            evaluateGroups(delegates);
+            return;
         }
 
+        // Create uncategorized group if it must be
+        // created and it isn't created already
+        std::pair<GroupItem*, int> uncategorized = createUncategorizedGroup();
+        if (uncategorized.first)
+            uncategorized.first->reset(uncategorizedRows());
+
+        for (auto& group : groups_)
+            group.resetChecked(q);
+
         // remove uncategorized group according to policy
         if (uncategorized.first && uncategorized.first->isEmpty() &&
             ungrouppedPolicy_ == QtGroupingProxyModel::UngrouppedAutoHide)
-            groups_.erase(groups_.begin() + uncategorized.second);
+            eraseGroupAt(groups_.begin() + uncategorized.second);
     }
 
     void removeGroup(const QtGroupItemDataDelegate* _delegate)
@@ -473,18 +1021,24 @@ public:
         if (it == groups_.end())
             return;
 
+        // filter of the group is destroyed along with it
+        const bool evaluating = !pendingGroups_.empty();
+        engine_.cancel();
+        pendingGroups_.erase(std::remove(pendingGroups_.begin(), pendingGroups_.end(), _delegate), pendingGroups_.end());
+
         // move source indices from removed group into temporary storage
-        std::deque<int> sourceRows;
-        it->swapRows(sourceRows);
+        const std::vector<int> sourceRows = it->takeRows();
 
         const int removedRow = std::distance(groups_.begin(), it);
         q->beginRemoveRows({}, removedRow, removedRow);
         // erase group
-        groups_.erase(it);
+        eraseGroupAt(it);
         q->endRemoveRows();
 
         // reassign source indices from removed group
         updateGroups(sourceRows.begin(), sourceRows.end(), NotifyGroupsChanged);
+        if (evaluating)
+            evaluateGroups();
     }
 
     void insertGroup(QtGroupItemDataDelegate* _delegate)
@@ -496,54 +1050,14 @@ public:
         const int insertedRow = std::distance(groups_.begin(), insertionPoint);
         q->beginInsertRows({}, insertedRow, insertedRow);
         // emplace new group
-        groups_.emplace(insertionPoint, _delegate);
+        emplaceGroup(insertionPoint, _delegate);
         q->endInsertRows();
 
         if (!model_)
             return;
 
-        // Create uncategorized group if it must be
-        // created and it isn't created already
-        std::pair<GroupItem*, int> uncategorized = createUncategorizedGroup();
-
-        // We have to find new group since insertion
-        // can invalidate references/iterators
-        auto groupIt = findGroup(_delegate);
-
-        if (uncategorized.first)
-            uncategorized.first->clear();
-
-        // push indices into new group
-        for (int row = 0, n = model_->rowCount(); row < n; ++row)
-        {
-            int matchCount = 0;
-            const QModelIndex index = model_->index(row, column_, {});
-            if (!index.isValid())
-                continue;
-
-            for (int i = 0, k = groups_.size(); i < k; ++i)
-            {
-                auto& group = groups_[i];
-                if (std::addressof(group) == std::addressof(*groupIt))
-                    matchCount += groupIt->push(q, i, index);
-                else
-                    matchCount += group.contains(index);
-            }
-            // update uncategorized group if
-            // index doesn't belong to any group
-            if (matchCount == 0 && uncategorized.first)
-                uncategorized.first->push(q, uncategorized.second, index, false);
-        }
-
-        // remove uncategorized group according to policy
-        if (uncategorized.first && uncategorized.first->isEmpty() &&
-            ungrouppedPolicy_ == QtGroupingProxyModel::UngrouppedAutoHide)
-        {
-            q->beginRemoveRows({}, uncategorized.second, uncategorized.second);
-            groups_.erase(groups_.begin() + uncategorized.second);
-            q->endRemoveRows();
-        }
-
+        // new group is filled once its filter is evaluated
+        evaluateGroups({ _delegate });
 
         for (auto& group : groups_)
             group.clearFlags();
@@ -617,7 +1131,7 @@ public:
             ungrouppedPolicy_ == QtGroupingProxyModel::UngrouppedAutoHide)
         {
             q->beginRemoveRows({}, uncategorized.second, uncategorized.second);
-            groups_.erase(groups_.begin() + uncategorized.second);
+            eraseGroupAt(groups_.begin() + uncategorized.second);
             q->endRemoveRows();
             //adjust prevCntrs
             if (!prevCntrs.empty())
@@ -656,6 +1170,348 @@ public:
         }
     }
 
+    void markDirty(int _first, int _last, const QVector<int>& _roles)
+    {
+        for (int row = _first; row <= _last; ++row)
+            dirtyRows_.push_back(row);
+
+        if (_roles.isEmpty())
+            dirtyAllRoles_ = true;
+        for (int role : _roles)
+        {
+            if (!dirtyRoles_.contains(role))
+                dirtyRoles_.append(role);
+        }
+
+        if (updatePending_)
+            return;
+
+        // coalesce all changes arrived within current event loop iteration
+        updatePending_ = true;
+        QMetaObject::invokeMethod(q, [this]() { updateDirtyRows(); }, Qt::QueuedConnection);
+    }
+
+    void discardDirtyRows()
+    {
+        dirtyRows_.clear();
+        dirtyRoles_.clear();
+        dirtyAllRoles_ = false;
+    }
+
+    // keep dirty rows valid after _count source rows were inserted
+    // at _first, or were removed starting from _first if _count < 0
+    void shiftDirtyRows(int _first, int _count)
+    {
+        if (_count < 0)
+        {
+            const int last = _first - _count;
+            auto removed = [_first, last](int row) { return row >= _first && row < last; };
+            dirtyRows_.erase(std::remove_if(dirtyRows_.begin(), dirtyRows_.end(), removed), dirtyRows_.end());
+        }
+
+        for (int& row : dirtyRows_)
+        {
+            if (row >= _first)
+                row += _count;
+        }
+    }
+
+    // whether group filter depends on changed roles, custom delegates
+    // without filter may depend on anything
+    bool isGroupAffected(const GroupItem& _group) const
+    {
+        const QtAbstractItemFilter* filter = _group.delegate()->filter();
+        if (!filter || dirtyAllRoles_)
+            return true;
+
+        const int snapshotRole = _group.filter() ? filter->snapshotRole() : -1;
+        for (int role : dirtyRoles_)
+        {
+            if (filter->isRoleSupported(role) && (snapshotRole < 0 || snapshotRole == role))
+                return true;
+        }
+        return false;
+    }
+
+    GroupItem* ensureUncategorizedGroup()
+    {
+        auto it = findGroup(nullptr);
+        if (it != groups_.end())
+            return std::addressof(*it);
+
+        if (ungrouppedPolicy_ == QtGroupingProxyModel::UngrouppedAlwaysOff)
+            return nullptr;
+
+        const int row = ungrouppedPlacement_ == QtGroupingProxyModel::UngrouppedAtFront ? 0 : static_cast<int>(groups_.size());
+        q->beginInsertRows({}, row, row);
+        GroupItem* group = createUncategorizedGroup().first;
+        q->endInsertRows();
+        return group;
+    }
+
+    GroupItem& slotGroup(int _slot)
+    {
+        updatePositions();
+        return groups_[slotPositions_[_slot]];
+    }
+
+    // Moves ascending source rows between groups, each run of rows
+    // adjacent in both groups is moved by a single notification.
+    void moveRows(const std::vector<int>& _sourceRows, GroupItem& _from, GroupItem& _to)
+    {
+        const QModelIndex sourceParent = q->index(groupPosition(_from), 0);
+        const QModelIndex destinationParent = q->index(groupPosition(_to), 0);
+        for (size_t first = 0, last = 0; first < _sourceRows.size(); first = last)
+        {
+            const int fromRow = _from.lowerBound(_sourceRows[first]);
+            const int toRow = _to.lowerBound(_sourceRows[first]);
+            for (last = first + 1; last < _sourceRows.size(); ++last)
+            {
+                if (_from.lowerBound(_sourceRows[last]) != fromRow + static_cast<int>(last - first) ||
+                    _to.lowerBound(_sourceRows[last]) != toRow)
+                    break;
+            }
+
+            const int lastRow = fromRow + static_cast<int>(last - first) - 1;
+            if (!q->beginMoveRows(sourceParent, fromRow, lastRow, destinationParent, toRow))
+            {
+                // the move is refused, so tell the views it is a removal followed by an insertion
+                const std::vector<int> run(_sourceRows.begin() + first, _sourceRows.begin() + last);
+                removeRows(run, _from);
+                insertRows(run, _to);
+                continue;
+            }
+
+            for (size_t i = first; i < last; ++i)
+            {
+                _from.eraseRow(_sourceRows[i]);
+                _to.insertRow(_sourceRows[i]);
+            }
+            q->endMoveRows();
+        }
+    }
+
+    // inserts ascending source rows by runs placed together in the group
+    void insertRows(const std::vector<int>& _sourceRows, GroupItem& _to)
+    {
+        const QModelIndex parent = q->index(groupPosition(_to), 0);
+        for (size_t first = 0, last = 0; first < _sourceRows.size(); first = last)
+        {
+            const int row = _to.lowerBound(_sourceRows[first]);
+            for (last = first + 1; last < _sourceRows.size(); ++last)
+            {
+                if (_to.lowerBound(_sourceRows[last]) != row)
+                    break;
+            }
+
+            q->beginInsertRows(parent, row, row + static_cast<int>(last - first) - 1);
+            for (size_t i = first; i < last; ++i)
+                _to.insertRow(_sourceRows[i]);
+            q->endInsertRows();
+        }
+    }
+
+    // removes ascending source rows by runs adjacent in the group
+    void removeRows(const std::vector<int>& _sourceRows, GroupItem& _from)
+    {
+        const QModelIndex parent = q->index(groupPosition(_from), 0);
+        for (size_t first = 0, last = 0; first < _sourceRows.size(); first = last)
+        {
+            const int row = _from.lowerBound(_sourceRows[first]);
+            for (last = first + 1; last < _sourceRows.size(); ++last)
+            {
+                if (_from.lowerBound(_sourceRows[last]) != row + static_cast<int>(last - first))
+                    break;
+            }
+
+            q->beginRemoveRows(parent, row, row + static_cast<int>(last - first) - 1);
+            for (size_t i = first; i < last; ++i)
+                _from.eraseRow(_sourceRows[i]);
+            q->endRemoveRows();
+        }
+    }
+
+    // Re-match rows changed since the last update against groups
+    // which filters depend on changed roles. Affected groups are
+    // evaluated in batch over contiguous runs of changed rows, rows
+    // changing their group are collected per pair of groups and moved
+    // by contiguous runs, other rows are reported with single
+    // dataChanged() per group.
+    void updateDirtyRows()
+    {
+        updatePending_ = false;
+        if (dirtyRows_.empty() || identity_ || !model_ || groups_.empty())
+        {
+            discardDirtyRows();
+            return;
+        }
+
+        // changes are applied after evaluated groups are published
+        if (!pendingGroups_.empty())
+            return;
+
+        const int nrows = sourceRowCount();
+        std::vector<int> rows;
+        rows.swap(dirtyRows_);
+        rows.erase(std::remove_if(rows.begin(), rows.end(), [nrows](int row) { return row < 0 || row >= nrows; }), rows.end());
+        std::sort(rows.begin(), rows.end());
+        rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+        const bool checkStateChanged = dirtyAllRoles_ || dirtyRoles_.contains(Qt::CheckStateRole);
+        std::vector<const GroupItem*> affected;
+        std::vector<bool> isAffected(membership_.slotCount(), false);
+        for (const auto& group : groups_)
+        {
+            if (group.delegate() && isGroupAffected(group))
+            {
+                affected.push_back(std::addressof(group));
+                isAffected[group.slot()] = true;
+            }
+        }
+        const QVector<int> roles = dirtyAllRoles_ ? QVector<int>{} : dirtyRoles_;
+        discardDirtyRows();
+
+        // groups affected by large changes are evaluated in time slices
+        const int threshold = engine_.parallelThreshold();
+        if (!affected.empty() && threshold > 0 && static_cast<int>(rows.size()) >= threshold)
+        {
+            std::vector<const QtGroupItemDataDelegate*> delegates;
+            delegates.reserve(affected.size());
+            for (const GroupItem* group : affected)
+                delegates.push_back(group->delegate());
+            evaluateGroups(delegates);
+            return;
+        }
+
+        auto uncategorizedIt = findGroup(nullptr);
+        int uncategorizedSlot = uncategorizedIt != groups_.end() ? uncategorizedIt->slot() : -1;
+
+        // source rows leaving and joining groups keyed by group slots
+        std::map<std::pair<int, int>, std::vector<int>> moves;
+        std::map<int, std::vector<int>> removals;
+        std::map<int, std::vector<int>> insertions;
+        std::vector<int> leaves;
+        std::vector<int> joins;
+        for (size_t first = 0, last = 0; first < rows.size() && !affected.empty(); first = last)
+        {
+            for (last = first + 1; last < rows.size() && rows[last] == rows[last - 1] + 1; ++last)
+                ;
+
+            const int firstRow = rows[first];
+            const std::vector<QBitArray> matches = matchGroups(affected, firstRow, rows[last - 1]);
+            for (size_t k = first; k < last; ++k)
+            {
+                const int row = rows[k];
+                leaves.clear();
+                joins.clear();
+                bool categorized = false;
+                for (size_t i = 0; i < affected.size(); ++i)
+                {
+                    const int slot = affected[i]->slot();
+                    const bool matched = matches[i].testBit(row - firstRow);
+                    if (matched != membership_.test(row, slot))
+                        (matched ? joins : leaves).push_back(slot);
+                    categorized |= matched;
+                }
+                // membership in groups not affected by changes stays the same
+                membership_.forEach(row, [&](int slot)
+                {
+                    if (slot != uncategorizedSlot && !(slot < static_cast<int>(isAffected.size()) && isAffected[slot]))
+                        categorized = true;
+                });
+
+                if (ungrouppedPolicy_ != QtGroupingProxyModel::UngrouppedAlwaysOff)
+                {
+                    const bool wasUncategorized = uncategorizedSlot >= 0 && membership_.test(row, uncategorizedSlot);
+                    if (categorized && wasUncategorized)
+                    {
+                        leaves.push_back(uncategorizedSlot);
+                    }
+                    else if (!categorized && !wasUncategorized)
+                    {
+                        if (uncategorizedSlot < 0)
+                            uncategorizedSlot = ensureUncategorizedGroup()->slot();
+                        joins.push_back(uncategorizedSlot);
+                    }
+                }
+
+                // move rows between groups where possible
+                size_t i = 0;
+                for (; i < leaves.size() && i < joins.size(); ++i)
+                    moves[{ leaves[i], joins[i] }].push_back(row);
+                for (size_t j = i; j < leaves.size(); ++j)
+                    removals[leaves[j]].push_back(row);
+                for (size_t j = i; j < joins.size(); ++j)
+                    insertions[joins[j]].push_back(row);
+            }
+        }
+
+        // groups which rows were moved or changed
+        std::vector<bool> touched(membership_.slotCount(), false);
+        for (const auto& move : moves)
+        {
+            moveRows(move.second, slotGroup(move.first.first), slotGroup(move.first.second));
+            touched[move.first.first] = touched[move.first.second] = true;
+        }
+        for (const auto& removal : removals)
+        {
+            removeRows(removal.second, slotGroup(removal.first));
+            touched[removal.first] = true;
+        }
+        for (const auto& insertion : insertions)
+        {
+            insertRows(insertion.second, slotGroup(insertion.first));
+            touched[insertion.first] = true;
+        }
+
+        // report changed data of rows stayed in groups
+        std::vector<int> firstChanged(membership_.slotCount(), std::numeric_limits<int>::max());
+        std::vector<int> lastChanged(membership_.slotCount(), -1);
+        for (int row : rows)
+        {
+            membership_.forEach(row, [&](int slot)
+            {
+                const int r = slotGroup(slot).lowerBound(row);
+                firstChanged[slot] = std::min(firstChanged[slot], r);
+                lastChanged[slot] = std::max(lastChanged[slot], r);
+            });
+        }
+
+        const int lastColumn = q->columnCount() - 1;
+        for (int slot = 0; slot < static_cast<int>(lastChanged.size()); ++slot)
+        {
+            if (lastChanged[slot] == -1)
+                continue;
+
+            const QModelIndex parent = q->index(groupPosition(slotGroup(slot)), 0);
+            Q_EMIT q->dataChanged(q->index(firstChanged[slot], 0, parent), q->index(lastChanged[slot], lastColumn, parent), roles);
+            if (checkStateChanged)
+                touched[slot] = true;
+        }
+
+        // update check state and flags of changed groups
+        for (int slot = 0; slot < static_cast<int>(touched.size()); ++slot)
+        {
+            if (!touched[slot])
+                continue;
+
+            GroupItem& group = slotGroup(slot);
+            group.resetChecked(q);
+            const QModelIndex index = q->index(groupPosition(group), 0);
+            Q_EMIT q->dataChanged(index, index);
+        }
+
+        // remove uncategorized group according to policy
+        if (uncategorizedSlot >= 0 && slotGroup(uncategorizedSlot).isEmpty() &&
+            ungrouppedPolicy_ == QtGroupingProxyModel::UngrouppedAutoHide)
+        {
+            const int row = groupPosition(slotGroup(uncategorizedSlot));
+            q->beginRemoveRows({}, row, row);
+            eraseGroupAt(groups_.begin() + row);
+            q->endRemoveRows();
+        }
+    }
+
     std::pair<GroupItem*, int> createUncategorizedGroup()
     {
         if (ungrouppedPolicy_ == QtGroupingProxyModel::UngrouppedAlwaysOff)
@@ -668,10 +1524,10 @@ public:
         switch (ungrouppedPlacement_)
         {
         case QtGroupingProxyModel::UngrouppedAtFront:
-            groups_.emplace_front(nullptr);
+            emplaceGroup(groups_.begin(), nullptr);
             return { std::addressof(groups_.front()), 0 };
         case QtGroupingProxyModel::UngrouppedAtBack:
-            groups_.emplace_back(nullptr);
+            emplaceGroup(groups_.end(), nullptr);
             return { std::addressof(groups_.back()), static_cast<int>(groups_.size() - 1) };
         default:
             break;
@@ -844,7 +1700,7 @@ void QtGroupingProxyModel::ungroup(const QtGroupItemDataDelegate * _delegate)
 
 void QtGroupingProxyModel::ungroup()
 {
-    d->groups_.clear();
+    d->clearAllGroups();
     if (!d->model_)
         return;
 
@@ -882,6 +1738,11 @@ bool QtGroupingProxyModel::setUngrouppedData(const QVariant & _value, int _role)
     }
 }
 
+QtItemFilterEngine* QtGroupingProxyModel::filterEngine() const
+{
+    return &d->engine_;
+}
+
 QModelIndex QtGroupingProxyModel::index(int _row, int _column, const QModelIndex & _parent) const
 {
     if (d->identity_)
@@ -985,7 +1846,11 @@ bool QtGroupingProxyModel::setData(const QModelIndex & proxyIndex, const QVarian
             return false;
 
         if (d->groups_[r].setData(value, role, this))
+        {
+            if (role == Qt::DisplayRole || role == Qt::EditRole)
+                d->invalidatePositions(); // group name is changed
             Q_EMIT dataChanged(proxyIndex, proxyIndex, QVector<int>() << role);
+        }
     }
     const QModelIndex parent = proxyIndex.parent();
     if (!parent.isValid())
@@ -1059,9 +1924,20 @@ void QtGroupingProxyModel::onSourceRowsInserted(const QModelIndex & _parent, int
         return;
     }
 
+    // shift rows of groups following inserted ones
+    // and match only inserted rows against groups
+    const int count = _last - _first + 1;
+    d->shiftDirtyRows(_first, count);
+    d->membership_.insertRows(_first, count);
+    for (auto& group : d->groups_)
+        group.insertSourceRows(_first, count);
+
     d->updateGroups(CountingIterator(_first),
-                    CountingIterator(d->model_->rowCount()),
+                    CountingIterator(_last + 1),
                     NotificationType::NotifyGroupsChanged | NotificationType::NotifyDataChanged);
+
+    // rows appended after evaluated ones are matched on publishing
+    d->restartEvaluation(_first);
 }
 
 void QtGroupingProxyModel::onSourceRowsRemoved(const QModelIndex & _parent, int _first, int _last)
@@ -1078,6 +1954,9 @@ void QtGroupingProxyModel::onSourceRowsRemoved(const QModelIndex & _parent, int
         const int i = std::distance(d->groups_.begin(), it);
         it->removeSourceRows(i, _first, _last + 1, this);
     }
+    d->membership_.removeRows(_first, _last - _first + 1);
+    d->shiftDirtyRows(_first, -(_last - _first + 1));
+    d->restartEvaluation(_first);
 }
 
 void QtGroupingProxyModel::onSourceRowsMoved(const QModelIndex & _parent, int _start, int _end, const QModelIndex & _dest, int _row)
@@ -1091,29 +1970,30 @@ void QtGroupingProxyModel::onSourceRowsMoved(const QModelIndex & _parent, int _s
         return;
     }
 
-    // we have to update indices in our groups
+    // we have to update indices in our groups,
+    // all rows are matched again, including dirty ones
+    d->discardDirtyRows();
     d->updateGroups(CountingIterator(0),
                     CountingIterator(d->model_->rowCount()),
                     NotificationType::NotifyGroupsChanged | NotificationType::NotifyDataChanged);
+    d->restartEvaluation(0);
 }
 
 void QtGroupingProxyModel::onSourceDataChanged(const QModelIndex & _topLeft, const QModelIndex & _bottomRight, const QVector<int>&_roles)
 {
-    using NotificationType = QtGroupingProxyModelPrivate::NotificationType;
-
     if (d->identity_)
     {
         Q_EMIT dataChanged(mapFromSource(_topLeft), mapFromSource(_bottomRight), _roles);
         return;
     }
-    d->updateGroups(CountingIterator(_topLeft.row()),
-                    CountingIterator(_bottomRight.row() + 1),
-                    NotificationType::NotifyGroupsChanged | NotificationType::NotifyDataChanged,
-                    _roles);
+    // groups are updated once per event loop iteration
+    d->markDirty(_topLeft.row(), _bottomRight.row(), _roles);
 }
 
 void QtGroupingProxyModel::onSourceReset()
 {
+    d->discardDirtyRows();
+    d->cancelEvaluation();
     d->clearGroups();
     if (!d->model_)
         return;
@@ -1125,6 +2005,7 @@ void QtGroupingProxyModel::onSourceReset()
 
 void QtGroupingProxyModel::onSourceDestroyed()
 {
+    d->cancelEvaluation();
     d->clearGroups();
 }
 
@@ -1163,14 +2044,10 @@ QModelIndex QtGroupingProxyModel::mapFromSource(const QModelIndex & _sourceIndex
     if (d->identity_)
         return QIdentityProxyModel::mapFromSource(_sourceIndex);
 
-    for (auto it = d->groups_.cbegin(); it != d->groups_.cend(); ++it)
-    {
-        const int r = it->rank(_sourceIndex);
-        if (r != -1)
-        {
-            const QModelIndex parentIndex = this->index(std::distance(d->groups_.cbegin(), it), 0);
-            return this->index(r, 0, parentIndex);
-        }
-    }
-    return QModelIndex{};
+    const int i = d->sourceRowGroup(_sourceIndex.row());
+    if (i == -1)
+        return QModelIndex{};
+
+    const int r = d->groups_[i].rank(_sourceIndex);
+    return r != -1 ? this->index(r, 0, this->index(i, 0)) : QModelIndex{};
 }
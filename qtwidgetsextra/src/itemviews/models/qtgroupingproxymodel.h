@@ -4,6 +4,7 @@
 #include <QtWidgetsExtra>
 
 class QtAbstractItemFilter;
+class QtItemFilterEngine;
 
 /*!
      * \brief The GroupItemDataDelegate class
@@ -57,6 +58,12 @@ public:
  * source model that satisfies the predicate specified for group.
  * At any time GroupingProxyModel can be converted to a QIdentityProxyModel
  * in-place by calling setIdentity(true) method.
+ * Source data changes are collected and applied to groups once per event
+ * loop iteration: only changed rows are matched again, and only against
+ * groups which filters depend on changed roles.
+ * Groups added, refreshed or affected by large changes are evaluated over
+ * all rows in time slices of the event loop (see filterEngine()), their
+ * rows are replaced with single layout change once evaluation is done.
  * \warning The refresh() method reset any previously calculated group
  * index mappings and rebuild them from scratch. To minimize resource
  * consumption it's recomended to avoid call this method not very often.
@@ -118,6 +125,10 @@ public:
     virtual QVariant ungroppedData(int _role) const;
     virtual bool setUngrouppedData(const QVariant& _value, int _role);
 
+    // engine evaluating group filters on refresh, can be used
+    // to tune the thread pool, chunk size and time slice
+    QtItemFilterEngine* filterEngine() const;
+
     // QAbstractItemModel interface
 public:
     QModelIndex index(int _row, int _column, const QModelIndex& _parent = {}) const Q_DECL_OVERRIDE;
@@ -1,4 +1,6 @@
 #include <unordered_set>
+#include <algorithm>
+#include <iterator>
 
 #include <QPointer>
 #include <QString>
@@ -6,7 +8,6 @@
 #include <QVariant>
 
 #include <QRegularExpression>
-#include <QRegExp>
 
 #include <QBrush>
 
@@ -39,37 +40,160 @@ static inline QRegularExpression::PatternOptions regexOpts(QtItemFilter::RegexOp
     return result;
 }
 
-static inline bool stringMatch(const QString& pattern, const QString& what, Qt::MatchFlags flags, QtItemFilter::RegexOptions options)
+// Translates the wildcard pattern as QRegExp::Wildcard did: '*' and '?'
+// match any characters including '/', sets in brackets are kept as is.
+static QString wildcardToRegExp(const QString& pattern)
 {
-    Qt::CaseSensitivity cs = flags & Qt::MatchCaseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
-    switch (flags) {
-    case Qt::MatchRegExp:
-        return (QRegularExpression(pattern, regexOpts(options, cs)).match(what).hasMatch());
-    case Qt::MatchWildcard:
-        return (QRegExp(pattern, cs, QRegExp::Wildcard).exactMatch(what));
-    case Qt::MatchStartsWith:
-        return (what.startsWith(pattern, cs));
-    case Qt::MatchEndsWith:
-        return (what.endsWith(pattern, cs));
-    case Qt::MatchFixedString:
-        return (what.compare(pattern, cs) == 0);
-    case Qt::MatchContains:
-    default:
-        break;
+    QString result;
+    result.reserve(pattern.size() * 2);
+    int literal = 0; // start of the run of literal characters
+    auto flush = [&](int end)
+    {
+        // runs are escaped at once, so surrogate pairs stay intact
+        if (end > literal)
+            result += QRegularExpression::escape(pattern.mid(literal, end - literal));
+    };
+    for (int i = 0, n = pattern.size(); i < n; ++i)
+    {
+        const QChar ch = pattern.at(i);
+        if (ch != QLatin1Char('*') && ch != QLatin1Char('?') && ch != QLatin1Char('['))
+            continue;
+
+        flush(i);
+        literal = i + 1;
+        if (ch == QLatin1Char('*'))
+        {
+            result += QLatin1String(".*");
+        }
+        else if (ch == QLatin1Char('?'))
+        {
+            result += QLatin1Char('.');
+        }
+        else if (ch == QLatin1Char('['))
+        {
+            // the first ']' of the set is a character
+            int end = i + 1;
+            if (end < n && (pattern.at(end) == QLatin1Char('!') || pattern.at(end) == QLatin1Char('^')))
+                ++end;
+            if (end < n && pattern.at(end) == QLatin1Char(']'))
+                ++end;
+            end = pattern.indexOf(QLatin1Char(']'), end);
+            if (end < 0)
+            {
+                result += QLatin1String("\\[");
+                continue;
+            }
+
+            result += QLatin1Char('[');
+            int k = i + 1;
+            if (pattern.at(k) == QLatin1Char('!') || pattern.at(k) == QLatin1Char('^'))
+            {
+                result += QLatin1Char('^');
+                ++k;
+            }
+            for (; k < end; ++k)
+            {
+                const QChar c = pattern.at(k);
+                if (c == QLatin1Char('\\') || c == QLatin1Char('[') || c == QLatin1Char(']'))
+                    result += QLatin1Char('\\');
+                result += c;
+            }
+            result += QLatin1Char(']');
+            i = end;
+            literal = end + 1;
+        }
     }
-    return (what.contains(pattern, cs));
+    flush(pattern.size());
+    return QLatin1String("\\A(?:") + result + QLatin1String(")\\z");
 }
 
-static inline bool match(const QVariant &pattern, const QVariant& what,  Qt::MatchFlags flags, QtItemFilter::RegexOptions options)
+static inline int matchType(Qt::MatchFlags flags)
 {
-    // QVariant based matching
-    if (flags == Qt::MatchExactly) {
-        return (what == pattern);
-    } else { // QString based matching - only convert to a string if it is needed
-        return stringMatch(pattern.toString(), what.toString(), flags, options);
-    }
+    return static_cast<int>(flags & 0x0F);
 }
 
+//
+// Boyer-Moore-Horspool searcher over UTF-16 code units.
+// Characters are folded on the fly for case insensitive
+// search, with the fast path for ASCII characters.
+//
+class QtStringSearcher
+{
+public:
+    void setPattern(const QString& pattern, Qt::CaseSensitivity cs)
+    {
+        cs_ = cs;
+        needle_.resize(pattern.size());
+        for (int i = 0; i < pattern.size(); ++i)
+            needle_[i] = fold(pattern[i]);
+
+        const int m = needle_.size();
+        std::fill(std::begin(skip_), std::end(skip_), m);
+        for (int i = 0; i < m - 1; ++i)
+            skip_[needle_[i] & 0xFF] = m - 1 - i;
+    }
+
+    bool contains(const QString& text) const
+    {
+        return indexIn(text.constData(), text.size()) >= 0;
+    }
+
+    bool startsWith(const QString& text) const
+    {
+        return text.size() >= needle_.size() && equals(text.constData());
+    }
+
+    bool endsWith(const QString& text) const
+    {
+        return text.size() >= needle_.size() && equals(text.constData() + text.size() - needle_.size());
+    }
+
+    int indexIn(const QChar* text, int n) const
+    {
+        const int m = needle_.size();
+        if (m == 0)
+            return 0;
+
+        const ushort* p = needle_.constData();
+        for (int pos = 0; pos <= n - m; )
+        {
+            const ushort last = fold(text[pos + m - 1]);
+            if (last == p[m - 1])
+            {
+                int i = m - 2;
+                while (i >= 0 && fold(text[pos + i]) == p[i])
+                    --i;
+                if (i < 0)
+                    return pos;
+            }
+            pos += skip_[last & 0xFF];
+        }
+        return -1;
+    }
+
+private:
+    inline bool equals(const QChar* text) const
+    {
+        for (int i = 0, m = needle_.size(); i < m; ++i)
+            if (fold(text[i]) != needle_[i])
+                return false;
+        return true;
+    }
+
+    inline ushort fold(QChar c) const
+    {
+        const ushort u = c.unicode();
+        if (cs_ == Qt::CaseSensitive)
+            return u;
+        if (u < 0x80)
+            return (u >= 'A' && u <= 'Z') ? u + ('a' - 'A') : u;
+        return c.toCaseFolded().unicode();
+    }
+
+    QVector<ushort> needle_;
+    int skip_[256];
+    Qt::CaseSensitivity cs_ = Qt::CaseSensitive;
+};
 
 static inline int compareStrings(const QString& pattern, const QString& what, Qt::MatchFlags flags)
 {
@@ -168,6 +292,26 @@ bool QtAbstractItemFilter::isEnabled() const
     return mEnabled;
 }
 
+void QtAbstractItemFilter::acceptedRows(const QAbstractItemModel *model, int firstRow, int lastRow,
+                                        QBitArray &result, int column) const
+{
+    const int n = std::max(0, lastRow - firstRow + 1);
+    result.fill(false, n);
+    if (!model)
+        return;
+
+    for (int i = 0; i < n; ++i)
+    {
+        if (accepted(model->index(firstRow + i, column)))
+            result.setBit(i);
+    }
+}
+
+bool QtAbstractItemFilter::acceptedValue(const QVariant &value) const
+{
+    return !isEnabled() || accepts(value);
+}
+
 
 class QtItemFilterPrivate
 {
@@ -179,15 +323,85 @@ public:
     QtItemFilter::RegexOptions options;
     quint8 condition;
 
+    // compiled state of pattern: rebuilt only when
+    // pattern, match flags or regex options are changed
+    QString patternText;
+    QRegularExpression regExp;
+    QtStringSearcher searcher;
+
     QtItemFilterPrivate() :
         patternRole(Qt::EditRole),
         flags(Qt::MatchExactly),
         options(QtItemFilter::NoOptions),
         condition(QtItemFilter::None)
     {
+        compile();
     }
+
+    void compile();
+    bool match(const QVariant& what) const;
+    bool stringMatch(const QString& what) const;
 };
 
+void QtItemFilterPrivate::compile()
+{
+    const Qt::CaseSensitivity cs = flags & Qt::MatchCaseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
+    patternText = pattern.toString();
+    regExp = QRegularExpression();
+    switch (matchType(flags))
+    {
+    case Qt::MatchRegExp:
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 15, 0))
+    case Qt::MatchRegularExpression:
+#endif
+        regExp = QRegularExpression(patternText, regexOpts(options, cs));
+        break;
+    case Qt::MatchWildcard:
+        regExp = QRegularExpression(wildcardToRegExp(patternText),
+                                    regexOpts(options, cs) | QRegularExpression::DotMatchesEverythingOption);
+        break;
+    default:
+        searcher.setPattern(patternText, cs);
+        return;
+    }
+
+    if (!regExp.isValid())
+        qWarning() << "invalid filter pattern" << patternText << ':' << regExp.errorString();
+    regExp.optimize(); // compile (and JIT) pattern once, instead of doing it on every match
+}
+
+bool QtItemFilterPrivate::match(const QVariant& what) const
+{
+    // QVariant based matching
+    if (matchType(flags) == Qt::MatchExactly)
+        return (what == pattern);
+    // QString based matching - only convert to a string if it is needed
+    return stringMatch(what.toString());
+}
+
+bool QtItemFilterPrivate::stringMatch(const QString& what) const
+{
+    const Qt::CaseSensitivity cs = flags & Qt::MatchCaseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
+    switch (matchType(flags)) {
+    case Qt::MatchRegExp:
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 15, 0))
+    case Qt::MatchRegularExpression:
+#endif
+    case Qt::MatchWildcard:
+        return regExp.match(what).hasMatch();
+    case Qt::MatchStartsWith:
+        return searcher.startsWith(what);
+    case Qt::MatchEndsWith:
+        return searcher.endsWith(what);
+    case Qt::MatchFixedString:
+        return (what.compare(patternText, cs) == 0);
+    case Qt::MatchContains:
+    default:
+        break;
+    }
+    return searcher.contains(what);
+}
+
 
 
 QtItemFilter::QtItemFilter() :
@@ -200,6 +414,7 @@ QtItemFilter::~QtItemFilter() = default;
 void QtItemFilter::setPattern(const QVariant &pattern)
 {
     d->pattern = pattern;
+    d->compile();
 }
 
 QVariant QtItemFilter::pattern() const
@@ -210,6 +425,7 @@ QVariant QtItemFilter::pattern() const
 void QtItemFilter::setPatternString(const QString &pattern)
 {
     d->pattern = pattern;
+    d->compile();
 }
 
 QString QtItemFilter::patternString() const
@@ -224,6 +440,7 @@ void QtItemFilter::setPatternType(Type t)
             d->pattern.convert(t);
         else
             qWarning() << "failed to convert pattern from [" << d->pattern.type() << "] to type [" << t << ']';
+        d->compile();
     }
 }
 
@@ -255,6 +472,7 @@ QtItemFilter::Condition QtItemFilter::condition() const
 void QtItemFilter::setMatchFlags(Qt::MatchFlags f)
 {
     d->flags = f;
+    d->compile();
 }
 
 Qt::MatchFlags QtItemFilter::matchFlags() const
@@ -265,6 +483,7 @@ Qt::MatchFlags QtItemFilter::matchFlags() const
 void QtItemFilter::setRegexOptions(QtItemFilter::RegexOptions opt)
 {
     d->options = opt;
+    d->compile();
 }
 
 QtItemFilter::RegexOptions QtItemFilter::regexOptions() const
@@ -272,21 +491,53 @@ QtItemFilter::RegexOptions QtItemFilter::regexOptions() const
     return d->options;
 }
 
+bool QtItemFilter::isTrivial() const
+{
+    return (!isEnabled() || (d->condition == None || !d->pattern.isValid()));
+}
+
 bool QtItemFilter::accepted(const QModelIndex &index) const
 {
-    if (!isEnabled() || (d->condition == None || !d->pattern.isValid()))
+    if (isTrivial())
         return true;
     return accepts(index.data(patternRole()));
 }
 
+void QtItemFilter::acceptedRows(const QAbstractItemModel *model, int firstRow, int lastRow,
+                                QBitArray &result, int column) const
+{
+    const int n = std::max(0, lastRow - firstRow + 1);
+    if (isTrivial())
+    {
+        result.fill(true, n);
+        return;
+    }
+
+    result.fill(false, n);
+    if (!model)
+        return;
+
+    const int role = patternRole();
+    for (int i = 0; i < n; ++i)
+    {
+        if (accepts(model->data(model->index(firstRow + i, column), role)))
+            result.setBit(i);
+    }
+}
+
+bool QtItemFilter::acceptedValue(const QVariant &value) const
+{
+    return isTrivial() || accepts(value);
+}
+
 bool QtItemFilter::accepts(const QVariant &v) const
 {
     switch(d->condition)
     {
     case None:         return true;
-    case Match:        return match(d->pattern, v, d->flags, d->options);
-    case Equal:        return match(d->pattern, v, Qt::MatchExactly, NoOptions);
-    case NotEqual:     return (!match(d->pattern, v, Qt::MatchExactly, NoOptions));
+    case Match:        return d->match(v);
+    case Equal:        return (v == d->pattern);
+    case NotEqual:     return (v != d->pattern);
     case Less:         return (compareVariants(d->pattern, v, d->flags) > 0);
     case LessEqual:    return (compareVariants(d->pattern, v, d->flags) >= 0);
     case Greater:      return (compareVariants(d->pattern, v, d->flags) < 0);
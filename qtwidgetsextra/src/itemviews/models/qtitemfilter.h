@@ -3,6 +3,7 @@
 #include <QModelIndex>
 #include <QVariant>
 #include <QVector>
+#include <QBitArray>
 #include <QHash>
 #include <QIcon>
 #include <QFont>
@@ -81,6 +82,21 @@ public:
     virtual bool accepted(const QModelIndex& index) const = 0;
     virtual bool isRoleSupported(int /*role*/) const = 0;
 
+    // Batch version of accepted(): evaluates rows [firstRow, lastRow]
+    // of the column, bit i of result corresponds to row firstRow + i
+    virtual void acceptedRows(const QAbstractItemModel* model, int firstRow, int lastRow,
+                              QBitArray& result, int column = 0) const;
+
+    // The only item data role filter needs to evaluate the index,
+    // or negative value if filter needs the whole model index. When
+    // role is specified filter can be evaluated by acceptedValue()
+    // on snapshot of role values outside of the GUI thread.
+    virtual int snapshotRole() const { return -1; }
+
+    // Evaluates filter for snapshotted value of snapshotRole().
+    // Must be thread-safe, since it is called from worker threads.
+    virtual bool acceptedValue(const QVariant& value) const;
+
 protected:
     virtual bool accepts(const QVariant& v) const = 0;
 
@@ -89,18 +105,27 @@ protected:
     bool mEnabled;
 };
 
+//
+// QtCustomItemFilter evaluates the predicate on the GUI thread by default.
+// Predicate is evaluated by QtItemFilterEngine on worker threads only
+// if it's marked as thread-safe, i.e. it doesn't touch the model, GUI
+// objects or any other shared state without synchronization
+//
 template<class _Predicate>
 class QtCustomItemFilter : public QtAbstractItemFilter
 {
 public:
-    QtCustomItemFilter(_Predicate&& p, int role = Qt::DisplayRole) :
-        mPred(std::forward<_Predicate>(p)), mRole(role)
+    QtCustomItemFilter(_Predicate&& p, int role = Qt::DisplayRole, bool threadSafe = false) :
+        mPred(std::forward<_Predicate>(p)), mRole(role), mThreadSafe(threadSafe)
     {
     }
 
     void setPatternRole(int role) { mRole = role; }
     int patternRole() const { return mRole; }
 
+    void setThreadSafe(bool on = true) { mThreadSafe = on; }
+    bool isThreadSafe() const { return mThreadSafe; }
+
     bool accepted(const QModelIndex& index) const Q_DECL_OVERRIDE
     {
         if (isEnabled())
@@ -113,6 +138,11 @@ public:
         return (mRole == role);
     }
 
+    int snapshotRole() const Q_DECL_OVERRIDE
+    {
+        return mThreadSafe ? mRole : -1;
+    }
+
 protected:
      bool accepts(const QVariant& v) const Q_DECL_OVERRIDE
      {
@@ -121,6 +151,7 @@ protected:
 private:
      _Predicate mPred;
      int mRole;
+     bool mThreadSafe;
 };
 
 class QTWIDGETSEXTRA_EXPORT QtItemFilter : public QtAbstractItemFilter
@@ -258,10 +289,18 @@ public:
     }
 
     bool accepted(const QModelIndex& index) const Q_DECL_OVERRIDE;
+    void acceptedRows(const QAbstractItemModel* model, int firstRow, int lastRow,
+                      QBitArray& result, int column = 0) const Q_DECL_OVERRIDE;
+
+    int snapshotRole() const Q_DECL_OVERRIDE { return patternRole(); }
+    bool acceptedValue(const QVariant& value) const Q_DECL_OVERRIDE;
 
 protected:
     bool accepts(const QVariant& v) const Q_DECL_OVERRIDE;
 
+private:
+    bool isTrivial() const;
+
 private:
     QScopedPointer<class QtItemFilterPrivate> d;
 };
@@ -0,0 +1,381 @@
+#include <QAbstractItemModel>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QAtomicInt>
+#include <QPointer>
+#include <QVector>
+#include <QByteArray>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <memory>
+
+#include "qtitemfilter.h"
+#include "qtitemfilterengine.h"
+
+namespace
+{
+
+//
+// Shared state of the chunked evaluation: each task grabs
+// the next unprocessed chunk until all chunks are processed
+//
+struct ChunkSchedule
+{
+    std::function<void(int)> job;
+    QAtomicInt next;
+    int count = 0;
+    QSemaphore finished;
+
+    void process()
+    {
+        for (int chunk = next.fetchAndAddRelaxed(1); chunk < count; chunk = next.fetchAndAddRelaxed(1))
+            job(chunk);
+    }
+};
+
+class ChunkTask : public QRunnable
+{
+public:
+    explicit ChunkTask(ChunkSchedule* _schedule)
+        : schedule_(_schedule)
+    {
+        setAutoDelete(false);
+    }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        schedule_->process();
+        schedule_->finished.release();
+    }
+
+private:
+    ChunkSchedule* schedule_;
+};
+
+//
+// State of the asynchronous evaluation, shared with the events
+// posted for the next slices: once canceled it's never processed
+//
+struct SliceSchedule
+{
+    QPointer<const QAbstractItemModel> model;
+    QPointer<QObject> context;
+    std::vector<const QtAbstractItemFilter*> filters;
+    std::vector<QByteArray> bits; // accepted rows of every filter
+    QtItemFilterEngine::Callback done;
+    int column = 0;
+    int firstRow = 0;
+    int lastRow = -1;
+    int nextRow = 0;
+    bool canceled = false;
+};
+
+}
+
+
+class QtItemFilterEnginePrivate
+{
+public:
+    QPointer<QThreadPool> pool;
+    int chunkSize = 4096;
+    int threshold = 16384;
+    int timeSlice = 10;
+    std::shared_ptr<SliceSchedule> pending;
+
+    QThreadPool* threadPool() const
+    {
+        return pool ? pool.data() : QThreadPool::globalInstance();
+    }
+
+    // rows of slice are aligned to the byte boundary as well as chunks,
+    // slices are large enough to be evaluated on the pool in parallel
+    int sliceRows() const
+    {
+        return (std::max(threshold, chunkSize) + 7) & ~7;
+    }
+
+    void run(int chunks, const std::function<void(int)>& job) const;
+    void evaluate(const QAbstractItemModel* model, int column, int firstRow, int lastRow,
+                  const std::vector<const QtAbstractItemFilter*>& filters,
+                  std::vector<QBitArray>& results) const;
+    void schedule(const std::shared_ptr<SliceSchedule>& slices);
+    void process(const std::shared_ptr<SliceSchedule>& slices);
+    void cancel();
+};
+
+void QtItemFilterEnginePrivate::run(int chunks, const std::function<void(int)>& job) const
+{
+    ChunkSchedule schedule;
+    schedule.job = job;
+    schedule.count = chunks;
+
+    // start helpers only on idle threads of the pool: the calling
+    // thread processes chunks as well, so evaluation never waits
+    // for unrelated tasks occupying the pool
+    QThreadPool* threadPool = this->threadPool();
+    const int helperCount = std::min(threadPool->maxThreadCount(), chunks) - 1;
+    std::vector<std::unique_ptr<ChunkTask>> helpers;
+    helpers.reserve(std::max(0, helperCount));
+    for (int i = 0; i < helperCount; ++i)
+    {
+        auto task = std::make_unique<ChunkTask>(&schedule);
+        if (!threadPool->tryStart(task.get()))
+            break;
+        helpers.emplace_back(std::move(task));
+    }
+
+    schedule.process();
+    schedule.finished.acquire(static_cast<int>(helpers.size()));
+}
+
+
+void QtItemFilterEnginePrivate::evaluate(const QAbstractItemModel *model, int column, int firstRow, int lastRow,
+                                         const std::vector<const QtAbstractItemFilter *> &filters,
+                                         std::vector<QBitArray> &results) const
+{
+    const int n = std::max(0, lastRow - firstRow + 1);
+    results.assign(filters.size(), QBitArray(n, true));
+    if (!model || n == 0)
+        return;
+
+    // split filters into ones evaluated on snapshotted role
+    // values and ones that require the whole model index
+    std::vector<int> roles;
+    std::vector<int> roleSlots(filters.size(), -1);
+    for (size_t i = 0; i < filters.size(); ++i)
+    {
+        const QtAbstractItemFilter* filter = filters[i];
+        if (!filter)
+            continue;
+
+        const int role = filter->snapshotRole();
+        if (role < 0 || n < threshold)
+        {
+            filter->acceptedRows(model, firstRow, lastRow, results[i], column);
+            continue;
+        }
+
+        auto it = std::find(roles.begin(), roles.end(), role);
+        roleSlots[i] = static_cast<int>(std::distance(roles.begin(), it));
+        if (it == roles.end())
+            roles.push_back(role);
+    }
+
+    if (roles.empty())
+        return;
+
+    // snapshot values on the calling thread
+    std::vector<QVector<QVariant>> values(roles.size());
+    for (auto& v : values)
+        v.reserve(n);
+
+    for (int row = firstRow; row <= lastRow; ++row)
+    {
+        const QModelIndex index = model->index(row, column);
+        for (size_t r = 0; r < roles.size(); ++r)
+            values[r].append(model->data(index, roles[r]));
+    }
+
+    // chunks are aligned to the byte boundary, thus
+    // tasks never write into the same byte of bits
+    const int chunk = (std::max(chunkSize, 8) + 7) & ~7;
+    const int chunks = (n + chunk - 1) / chunk;
+    std::vector<QByteArray> bits(filters.size());
+    std::vector<uchar*> outputs(filters.size(), nullptr);
+    for (size_t i = 0; i < filters.size(); ++i)
+    {
+        if (roleSlots[i] == -1)
+            continue;
+        bits[i].fill('\0', (n + 7) / 8);
+        outputs[i] = reinterpret_cast<uchar*>(bits[i].data()); // detach before sharing with tasks
+    }
+
+    run(chunks, [&](int c)
+    {
+        const int first = c * chunk;
+        const int last = std::min(n, first + chunk);
+        for (size_t i = 0; i < filters.size(); ++i)
+        {
+            if (roleSlots[i] == -1)
+                continue;
+
+            const QtAbstractItemFilter* filter = filters[i];
+            const QVariant* v = values[roleSlots[i]].constData();
+            uchar* out = outputs[i];
+            for (int k = first; k < last; ++k)
+            {
+                if (filter->acceptedValue(v[k]))
+                    out[k >> 3] |= uchar(1 << (k & 7));
+            }
+        }
+    });
+
+    for (size_t i = 0; i < filters.size(); ++i)
+    {
+        if (roleSlots[i] != -1)
+            results[i] = QBitArray::fromBits(bits[i].constData(), n);
+    }
+}
+
+void QtItemFilterEnginePrivate::schedule(const std::shared_ptr<SliceSchedule> &slices)
+{
+    // the posted event holds the schedule, so canceled
+    // one is released along with the event
+    QMetaObject::invokeMethod(slices->context.data(), [this, slices]()
+    {
+        if (!slices->canceled)
+            process(slices);
+    }, Qt::QueuedConnection);
+}
+
+void QtItemFilterEnginePrivate::process(const std::shared_ptr<SliceSchedule> &slices)
+{
+    if (!slices->model)
+    {
+        cancel();
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const int slice = sliceRows();
+    std::vector<QBitArray> results;
+    while (slices->nextRow <= slices->lastRow)
+    {
+        const int first = slices->nextRow;
+        const int last = std::min(slices->lastRow, first + slice - 1);
+        evaluate(slices->model, slices->column, first, last, slices->filters, results);
+
+        // slices start at the byte boundary, thus bits are just copied
+        const int offset = (first - slices->firstRow) / 8;
+        for (size_t i = 0; i < results.size(); ++i)
+            std::memcpy(slices->bits[i].data() + offset, results[i].bits(), size_t(last - first + 8) / 8);
+
+        slices->nextRow = last + 1;
+        if (slices->nextRow <= slices->lastRow && timer.elapsed() >= timeSlice)
+        {
+            schedule(slices);
+            return;
+        }
+    }
+
+    const int n = slices->lastRow - slices->firstRow + 1;
+    results.clear();
+    results.reserve(slices->bits.size());
+    for (const QByteArray& bits : slices->bits)
+        results.push_back(QBitArray::fromBits(bits.constData(), n));
+
+    // the callback may start the next evaluation
+    pending.reset();
+    slices->done(results);
+}
+
+void QtItemFilterEnginePrivate::cancel()
+{
+    if (!pending)
+        return;
+
+    pending->canceled = true;
+    pending.reset();
+}
+
+
+QtItemFilterEngine::QtItemFilterEngine()
+    : d(new QtItemFilterEnginePrivate)
+{
+}
+
+QtItemFilterEngine::~QtItemFilterEngine()
+{
+    d->cancel();
+}
+
+void QtItemFilterEngine::setThreadPool(QThreadPool *pool)
+{
+    d->pool = pool;
+}
+
+QThreadPool *QtItemFilterEngine::threadPool() const
+{
+    return d->threadPool();
+}
+
+void QtItemFilterEngine::setChunkSize(int rows)
+{
+    d->chunkSize = std::max(1, rows);
+}
+
+int QtItemFilterEngine::chunkSize() const
+{
+    return d->chunkSize;
+}
+
+void QtItemFilterEngine::setParallelThreshold(int rows)
+{
+    d->threshold = std::max(0, rows);
+}
+
+int QtItemFilterEngine::parallelThreshold() const
+{
+    return d->threshold;
+}
+
+void QtItemFilterEngine::setTimeSlice(int msecs)
+{
+    d->timeSlice = std::max(1, msecs);
+}
+
+int QtItemFilterEngine::timeSlice() const
+{
+    return d->timeSlice;
+}
+
+void QtItemFilterEngine::evaluate(const QAbstractItemModel *model, int column, int firstRow, int lastRow,
+                                  const std::vector<const QtAbstractItemFilter *> &filters,
+                                  std::vector<QBitArray> &results) const
+{
+    d->evaluate(model, column, firstRow, lastRow, filters, results);
+}
+
+void QtItemFilterEngine::evaluateAsync(const QAbstractItemModel *model, int column, int firstRow, int lastRow,
+                                       const std::vector<const QtAbstractItemFilter *> &filters,
+                                       QObject *context, const Callback &done)
+{
+    d->cancel();
+    if (!context)
+        return;
+
+    auto slices = std::make_shared<SliceSchedule>();
+    slices->model = model;
+    slices->context = context;
+    slices->filters = filters;
+    slices->done = done;
+    slices->column = column;
+    slices->firstRow = firstRow;
+    slices->lastRow = std::max(firstRow - 1, lastRow);
+    slices->nextRow = firstRow;
+
+    const int n = slices->lastRow - firstRow + 1;
+    slices->bits.resize(filters.size());
+    for (QByteArray& bits : slices->bits)
+        bits.fill('\0', (n + 7) / 8);
+
+    // even empty range is reported from the event loop
+    d->pending = slices;
+    d->schedule(slices);
+}
+
+void QtItemFilterEngine::cancel()
+{
+    d->cancel();
+}
+
+bool QtItemFilterEngine::isEvaluating() const
+{
+    return d->pending && d->pending->context;
+}
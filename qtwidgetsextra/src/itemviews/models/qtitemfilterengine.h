@@ -0,0 +1,81 @@
+#pragma once
+#include <QBitArray>
+#include <QScopedPointer>
+
+#include <functional>
+#include <vector>
+
+#include <QtWidgetsExtra>
+
+class QObject;
+class QAbstractItemModel;
+class QThreadPool;
+class QtAbstractItemFilter;
+
+//
+// QtItemFilterEngine evaluates a set of item filters over
+// a range of model rows at once. Values of the roles filters
+// depend on (see QtAbstractItemFilter::snapshotRole()) are
+// snapshotted on the calling thread, after that filters are
+// evaluated in chunks of rows across the thread pool, so the
+// model itself is never touched outside of its own thread.
+// Filters that need the whole model index are evaluated
+// sequentially with QtAbstractItemFilter::acceptedRows().
+// evaluate() is synchronous: the calling thread processes
+// chunks along with the pool and waits for the rest of them,
+// evaluateAsync() splits rows into slices processed on the
+// event loop, so large models don't block the thread.
+//
+class QTWIDGETSEXTRA_EXPORT QtItemFilterEngine
+{
+    Q_DISABLE_COPY(QtItemFilterEngine)
+public:
+    typedef std::function<void(std::vector<QBitArray>& results)> Callback;
+
+    QtItemFilterEngine();
+    ~QtItemFilterEngine();
+
+    // pool used to evaluate filters, global
+    // thread pool is used if pool is not set
+    void setThreadPool(QThreadPool* pool);
+    QThreadPool* threadPool() const;
+
+    // number of rows evaluated by single task
+    void setChunkSize(int rows);
+    int chunkSize() const;
+
+    // ranges with less rows are evaluated
+    // sequentially on the calling thread
+    void setParallelThreshold(int rows);
+    int parallelThreshold() const;
+
+    // evaluateAsync() processes slices of rows until this
+    // time is elapsed, then yields to the event loop
+    void setTimeSlice(int msecs);
+    int timeSlice() const;
+
+    // evaluates filters for rows [firstRow, lastRow] of the column,
+    // results[i] receives accepted rows of filters[i], where bit k
+    // corresponds to row firstRow + k; null filters accept all rows.
+    // Blocks until all rows are evaluated, to keep the GUI responsive
+    // on large models use evaluateAsync()
+    void evaluate(const QAbstractItemModel* model, int column, int firstRow, int lastRow,
+                  const std::vector<const QtAbstractItemFilter*>& filters,
+                  std::vector<QBitArray>& results) const;
+
+    // evaluates the same way as evaluate() slice by slice on the event
+    // loop of the context's thread, which must be the model thread, and
+    // calls done() there with the results. Single evaluation runs at a
+    // time: starting the next one, cancel() or destruction of the engine
+    // or the context cancels it, done() is never called then. Model and
+    // filters must stay alive and unchanged until evaluation is finished
+    // or canceled, structural changes of the model invalidate it as well
+    void evaluateAsync(const QAbstractItemModel* model, int column, int firstRow, int lastRow,
+                       const std::vector<const QtAbstractItemFilter*>& filters,
+                       QObject* context, const Callback& done);
+    void cancel();
+    bool isEvaluating() const;
+
+private:
+    QScopedPointer<class QtItemFilterEnginePrivate> d;
+};
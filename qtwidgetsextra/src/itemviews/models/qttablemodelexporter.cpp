@@ -2,9 +2,21 @@
 #include <QProgressDialog>
 #include <QApplication>
 #include <QTextCodec>
+#include <QAbstractTableModel>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInt>
+#include <QThread>
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <vector>
 
 #include "qttablemodelexporter.h"
 #include "qttablemodelexporterdialog.h"
+#include "qttablemodelserializer.h"
 
 
 QT_METAINFO_TR(QtTableModelExporter)
@@ -16,18 +28,227 @@ QT_METAINFO_TR(QtTableModelExporter)
 
 #undef QT_META_TR
 
+namespace
+{
+
+struct ExportBlock
+{
+    int firstRow = 0;
+    int rowCount = 0;
+    int columnCount = 0;
+    QVector<QVariant> values; // row by row
+};
+
+//
+// ExportPipeline connects the exporter thread, which snapshots
+// blocks of rows and writes serialized buffers into the device,
+// with the worker thread, which serializes the blocks. Both the
+// block queue and the number of buffers are bounded, thus memory
+// use doesn't depend on the model size: the worker fills one
+// buffer while the other one is written into the device
+//
+class ExportPipeline
+{
+public:
+    static constexpr size_t MaxBlocks = 2;
+    static constexpr int BufferSize = 1 << 20;
+
+    ExportPipeline(QtTableModelSerializer* serializer, QTextCodec* codec, const std::function<void()>& notify);
+
+    // exporter thread
+    bool canPush() const;
+    void push(ExportBlock&& block);
+    void close();
+    bool takeBuffer(QByteArray& buffer);
+    void recycle(QByteArray& buffer);
+    bool isFinished() const;
+    void wait() const;
+
+    // any thread
+    void cancel();
+    bool isCanceled() const { return canceled.loadAcquire() != 0; }
+    int serializedRows() const { return rows.loadAcquire(); }
+
+    // worker thread
+    void run(const QVector<QVariant>& header);
+
+private:
+    void handOff(QByteArray& buffer);
+
+    mutable QMutex mutex;
+    mutable QWaitCondition changed;
+    std::deque<ExportBlock> blocks;
+    std::deque<QByteArray> filled;
+    std::vector<QByteArray> spare;
+    bool closed = false;
+    bool finished = false;
+    QAtomicInt canceled;
+    QAtomicInt rows;
+    QtTableModelSerializer* serializer;
+    QTextCodec* codec;
+    std::function<void()> notify;
+};
+
+ExportPipeline::ExportPipeline(QtTableModelSerializer *s, QTextCodec *c, const std::function<void()> &n)
+    : serializer(s)
+    , codec(c)
+    , notify(n)
+{
+    // the writer owns the other buffer
+    spare.emplace_back();
+    spare.back().reserve(BufferSize + BufferSize / 4);
+}
+
+bool ExportPipeline::canPush() const
+{
+    QMutexLocker locker(&mutex);
+    return !closed && blocks.size() < MaxBlocks;
+}
+
+void ExportPipeline::push(ExportBlock &&block)
+{
+    QMutexLocker locker(&mutex);
+    blocks.push_back(std::move(block));
+    changed.wakeAll();
+}
+
+void ExportPipeline::close()
+{
+    QMutexLocker locker(&mutex);
+    closed = true;
+    changed.wakeAll();
+}
+
+bool ExportPipeline::takeBuffer(QByteArray &buffer)
+{
+    QMutexLocker locker(&mutex);
+    if (filled.empty())
+        return false;
+
+    buffer = std::move(filled.front());
+    filled.pop_front();
+    return true;
+}
+
+void ExportPipeline::recycle(QByteArray &buffer)
+{
+    buffer.resize(0); // keeps reserved capacity
+    QMutexLocker locker(&mutex);
+    spare.push_back(std::move(buffer));
+    changed.wakeAll();
+}
+
+bool ExportPipeline::isFinished() const
+{
+    QMutexLocker locker(&mutex);
+    return finished && filled.empty();
+}
+
+void ExportPipeline::wait() const
+{
+    QMutexLocker locker(&mutex);
+    while (filled.empty() && !finished && (closed || blocks.size() >= MaxBlocks || isCanceled()))
+        changed.wait(&mutex);
+}
+
+void ExportPipeline::cancel()
+{
+    QMutexLocker locker(&mutex);
+    canceled.storeRelease(1);
+    changed.wakeAll();
+}
+
+void ExportPipeline::run(const QVector<QVariant> &header)
+{
+    QtTableModelWriter writer(codec, BufferSize, [this](QByteArray& buffer) { handOff(buffer); });
+    serializer->begin(writer, header);
+    if (serializer->hasError())
+        cancel();
+    writer.commit();
+
+    for (;;)
+    {
+        ExportBlock block;
+        {
+            QMutexLocker locker(&mutex);
+            while (blocks.empty() && !closed && !isCanceled())
+                changed.wait(&mutex);
+
+            if (blocks.empty() || isCanceled())
+                break;
+
+            block = std::move(blocks.front());
+            blocks.pop_front();
+            changed.wakeAll();
+        }
+        notify(); // there is a room for the next block
+
+        const QVariant* values = block.values.constData();
+        for (int i = 0; i < block.rowCount && !isCanceled(); ++i, values += block.columnCount)
+        {
+            serializer->writeRow(writer, block.firstRow + i, values, block.columnCount);
+            if (serializer->hasError())
+                cancel();
+            writer.commit();
+            rows.fetchAndAddRelease(1);
+        }
+    }
+
+    if (!isCanceled())
+    {
+        serializer->end(writer);
+        if (serializer->hasError())
+            cancel();
+        writer.flush();
+    }
+
+    {
+        QMutexLocker locker(&mutex);
+        finished = true;
+        changed.wakeAll();
+    }
+    notify();
+}
+
+void ExportPipeline::handOff(QByteArray &buffer)
+{
+    {
+        QMutexLocker locker(&mutex);
+        while (spare.empty() && !isCanceled())
+            changed.wait(&mutex);
+
+        if (isCanceled())
+        {
+            buffer.resize(0);
+            return;
+        }
+
+        filled.push_back(std::move(buffer));
+        buffer = std::move(spare.back());
+        spare.pop_back();
+        changed.wakeAll();
+    }
+    notify(); // there is a buffer to write
+}
+
+}
+
+
 class QtTableModelExporterPrivate
 {
 public:
-    QtTableModelExporterPrivate(QAbstractTableModel* m) :
+    QtTableModelExporterPrivate(QtTableModelExporter* e, QAbstractTableModel* m) :
+        q(e),
         model(m),
         tableName("[Title]"),
         codec(QTextCodec::codecForLocale()),
         role(Qt::DisplayRole),
-        storeHeader(false)
+        storeHeader(false),
+        dlg(Q_NULLPTR)
     {
     }
 
+    QtTableModelExporter *q;
     QAbstractTableModel *model;
     QString tableName;
     QString errorString;
@@ -35,16 +256,217 @@ public:
     int role;
     bool storeHeader;
     QProgressDialog *dlg;
+
+    // streaming export
+    QScopedPointer<QtTableModelSerializer> serializer;
+    QScopedPointer<ExportPipeline> pipeline;
+    QScopedPointer<QThread> worker;
+    QMutex pipelineMutex; // guards pipeline lifetime for cancel()
+    QIODevice *device = Q_NULLPTR;
+    int nextRow = 0;
+    int totalRows = 0;
+    int columnCount = 0;
+    int blockRows = 0;
+    bool writeFailed = false;
+    QAtomicInt canceled;
+    QAtomicInt pumpPending;
+    QElapsedTimer progressTimer;
+    int progressInterval = 100;
+
+    bool checkDevice(QIODevice *device);
+    bool start(QIODevice *device, bool async);
+    void schedulePump();
+    bool pump();
+    bool complete();
+    void reportProgress();
+    bool progressElapsed();
 };
 
+bool QtTableModelExporterPrivate::checkDevice(QIODevice *device)
+{
+    if (!model) {
+        errorString = QtTableModelExporter::tr("source data model is not set");
+        return false;
+    }
+
+    if (!device) {
+        errorString = QtTableModelExporter::tr("output device is not presented");
+        return false;
+    }
+
+    if (!device->isOpen() || !device->isWritable()) {
+        errorString = QtTableModelExporter::tr("output device is inaccessible");
+        return false;
+    }
+    return true;
+}
+
+bool QtTableModelExporterPrivate::start(QIODevice *device, bool async)
+{
+    if (pipeline) {
+        errorString = QtTableModelExporter::tr("export is already running");
+        return false;
+    }
+
+    if (!checkDevice(device))
+        return false;
+
+    serializer.reset(q->createSerializer());
+    if (!serializer) {
+        errorString = QtTableModelExporter::tr("streaming export is not supported");
+        return false;
+    }
+
+    // aim at some thousands of cells per block
+    columnCount = model->columnCount();
+    totalRows = model->rowCount();
+    blockRows = std::max(1, 16384 / std::max(1, columnCount));
+    nextRow = 0;
+    writeFailed = false;
+    canceled.storeRelease(0);
+    pumpPending.storeRelease(0);
+    errorString.clear();
+    this->device = device;
+
+    QVector<QVariant> header;
+    header.reserve(columnCount);
+    for (int c = 0; c < columnCount; ++c)
+        header.append(model->headerData(c, Qt::Horizontal, Qt::DisplayRole));
+
+    // synchronous export is woken up with the wait condition,
+    // asynchronous one schedules pump() on the exporter thread
+    std::function<void()> notify = [](){};
+    if (async)
+        notify = [this]() { schedulePump(); };
+
+    {
+        QMutexLocker locker(&pipelineMutex);
+        pipeline.reset(new ExportPipeline(serializer.data(), codec, notify));
+    }
+    worker.reset(QThread::create([this, header]() { pipeline->run(header); }));
+    worker->start();
+
+    progressTimer.start();
+    Q_EMIT q->progressChanged(0, totalRows);
+    if (async)
+        schedulePump();
+    return true;
+}
+
+void QtTableModelExporterPrivate::schedulePump()
+{
+    // coalesce notifications of the worker
+    if (!pumpPending.testAndSetOrdered(0, 1))
+        return;
+
+    QMetaObject::invokeMethod(q, [this]()
+    {
+        pumpPending.storeRelease(0);
+        if (pipeline && pump())
+            complete();
+    }, Qt::QueuedConnection);
+}
+
+bool QtTableModelExporterPrivate::pump()
+{
+    QByteArray buffer;
+    while (pipeline->takeBuffer(buffer))
+    {
+        if (!pipeline->isCanceled() && device->write(buffer) != buffer.size())
+        {
+            errorString = device->errorString();
+            writeFailed = true;
+            pipeline->cancel();
+        }
+        pipeline->recycle(buffer);
+    }
+
+    if (canceled.loadAcquire())
+        pipeline->cancel();
+
+    if (!pipeline->isCanceled())
+    {
+        // rows are snapshotted here, so the worker
+        // never touches the model
+        const int rowCount = std::min(totalRows, model->rowCount());
+        while (nextRow < rowCount && pipeline->canPush())
+        {
+            ExportBlock block;
+            block.firstRow = nextRow;
+            block.rowCount = std::min(blockRows, rowCount - nextRow);
+            block.columnCount = columnCount;
+            block.values.reserve(block.rowCount * columnCount);
+            for (int r = nextRow, last = nextRow + block.rowCount; r < last; ++r)
+            {
+                for (int c = 0; c < columnCount; ++c)
+                    block.values.append(model->data(model->index(r, c), role));
+            }
+            nextRow += block.rowCount;
+            pipeline->push(std::move(block));
+        }
+
+        if (nextRow >= rowCount)
+            pipeline->close();
+    }
+
+    reportProgress();
+    return pipeline->isFinished();
+}
+
+bool QtTableModelExporterPrivate::complete()
+{
+    worker->wait();
+    worker.reset();
+
+    const bool ok = !pipeline->isCanceled();
+    if (!ok && !writeFailed)
+    {
+        errorString = serializer->hasError() ? serializer->errorString()
+                                             : QtTableModelExporter::tr("export is canceled");
+    }
+
+    {
+        QMutexLocker locker(&pipelineMutex);
+        pipeline.reset();
+    }
+    serializer.reset();
+    device = Q_NULLPTR;
+
+    if (ok)
+        Q_EMIT q->progressChanged(totalRows, totalRows);
+    Q_EMIT q->finished(ok);
+    return ok;
+}
+
+void QtTableModelExporterPrivate::reportProgress()
+{
+    if (progressElapsed())
+        Q_EMIT q->progressChanged(pipeline->serializedRows(), totalRows);
+}
+
+bool QtTableModelExporterPrivate::progressElapsed()
+{
+    if (progressTimer.isValid() && progressTimer.elapsed() < progressInterval)
+        return false;
+
+    progressTimer.start();
+    return true;
+}
+
 
 QtTableModelExporter::QtTableModelExporter(QAbstractTableModel* model)
-    : d(new QtTableModelExporterPrivate(model))
+    : d(new QtTableModelExporterPrivate(this, model))
 {
     setModel(model);
 }
 
-QtTableModelExporter::~QtTableModelExporter() = default;
+QtTableModelExporter::~QtTableModelExporter()
+{
+    if (d->pipeline) {
+        d->pipeline->cancel();
+        d->worker->wait();
+    }
+}
 
 void QtTableModelExporter::setModel(QAbstractTableModel* model)
 {
@@ -123,9 +545,57 @@ QStringList QtTableModelExporter::fileFilter() const
     return QStringList();
 }
 
-bool QtTableModelExporter::exportModel(QIODevice * /*device*/)
+bool QtTableModelExporter::exportModel(QIODevice *device)
+{
+     
+    if (!d->start(device, false))
+        return false;
+
+    while (!d->pump())
+        d->pipeline->wait();
+    return d->complete();
+}
+
+bool QtTableModelExporter::startExport(QIODevice *device)
+{
+     
+    return d->start(device, true);
+}
+
+bool QtTableModelExporter::isRunning() const
+{
+     
+    return !d->pipeline.isNull();
+}
+
+void QtTableModelExporter::setProgressInterval(int msecs)
+{
+     
+    d->progressInterval = std::max(0, msecs);
+}
+
+int QtTableModelExporter::progressInterval() const
+{
+     
+    return d->progressInterval;
+}
+
+void QtTableModelExporter::cancel()
+{
+     
+    d->canceled.storeRelease(1);
+    QMutexLocker locker(&d->pipelineMutex);
+    if (d->pipeline)
+        d->pipeline->cancel();
+}
+
+QtTableModelSerializer *QtTableModelExporter::createSerializer() const
+{
+    return Q_NULLPTR;
+}
+
+void QtTableModelExporter::storeIndex(const QModelIndex &)
 {
-    return false;
 }
 
 void QtTableModelExporter::setErrorString( const QString& text )
@@ -137,8 +607,14 @@ void QtTableModelExporter::setErrorString( const QString& text )
 void QtTableModelExporter::setProgress( int step )
 {
      
+    // updating the dialog and processing events for
+    // every item dominates the export time
+    if (!d->progressElapsed())
+        return;
+
     if (d->dlg) {
         d->dlg->setValue(step);
+        Q_EMIT progressChanged(step, d->dlg->maximum());
     }
     qApp->processEvents();
 }
@@ -155,21 +631,11 @@ void QtTableModelExporter::setProgressText( const QString& text )
 bool QtTableModelExporter::beginExport(QIODevice *device)
 {
      
-    if (!d->model) {
-        d->errorString = tr("source data model is not set");
+    if (!d->checkDevice(device))
         return false;
-    }
-
-    if (!device) {
-        d->errorString = tr("output device is not presented");
-        return false;
-    }
-
-    if (!device->isOpen() || !device->isWritable()) {
-        d->errorString = tr("output device is inaccessible");
-        return false;
-    }
 
+    d->canceled.storeRelease(0);
+    d->progressTimer.invalidate();
     d->dlg = new QProgressDialog(tr("Data export..."), tr("Cancel"), 0,
                                  d->model->rowCount() * d->model->columnCount());
     d->dlg->setAttribute(Qt::WA_DeleteOnClose);
@@ -182,8 +648,11 @@ bool QtTableModelExporter::beginExport(QIODevice *device)
 void QtTableModelExporter::endExport()
 {
      
-    d->dlg->setValue(d->dlg->maximum());
-    d->dlg->close();
+    if (d->dlg) {
+        d->dlg->setValue(d->dlg->maximum());
+        d->dlg->close();
+        d->dlg = Q_NULLPTR;
+    }
     qApp->processEvents();
 
 }
@@ -191,8 +660,8 @@ void QtTableModelExporter::endExport()
 bool QtTableModelExporter::aborted() const
 {
      
-    qApp->processEvents();
-    return d->dlg->wasCanceled();
+    // events are processed by setProgress()
+    return d->canceled.loadAcquire() || (d->dlg && d->dlg->wasCanceled());
 }
 
 
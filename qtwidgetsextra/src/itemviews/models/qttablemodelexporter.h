@@ -10,6 +10,7 @@ class QDialog;
 class QIODevice;
 class QTextCodec;
 class QAbstractTableModel;
+class QtTableModelSerializer;
 
 
 #ifdef Q_CC_GNU
@@ -67,12 +68,38 @@ public:
 
     virtual QStringList fileFilter() const;
 
+    // default implementation runs the streaming export (see
+    // createSerializer()) and blocks until it's finished without
+    // processing events, progressChanged() is emitted meanwhile
     virtual bool exportModel(QIODevice *device);
 
+    // starts the streaming export and returns immediately: blocks of
+    // rows are snapshotted on the event loop of the exporter thread
+    // and serialized on the worker thread, device must stay alive
+    // until finished() is emitted
+    bool startExport(QIODevice *device);
+    bool isRunning() const;
+
+    // minimal interval between progressChanged() notifications
+    void setProgressInterval(int msecs);
+    int progressInterval() const;
+
     virtual QWidget *createEditor(QDialog *parent) const = 0;
 
+public Q_SLOTS:
+    // thread-safe, export finishes with error
+    void cancel();
+
+Q_SIGNALS:
+    void progressChanged(int value, int maximum);
+    void finished(bool ok);
+
 protected:
-    virtual void storeIndex(const QModelIndex& index = QModelIndex()) = 0;
+    // exporters supporting streaming export return new
+    // serializer with the copy of the current settings
+    virtual QtTableModelSerializer* createSerializer() const;
+
+    virtual void storeIndex(const QModelIndex& index = QModelIndex());
 
     void setErrorString(const QString& text);
     void setProgress(int step);
@@ -0,0 +1,67 @@
+#include <QTextCodec>
+
+#include "qttablemodelserializer.h"
+
+
+QtTableModelWriter::QtTableModelWriter(QTextCodec *codec, int threshold, const Sink &sink)
+    : codec_(codec ? codec : QTextCodec::codecForLocale())
+    , encoder_(codec_->makeEncoder(QTextCodec::IgnoreHeader))
+    , sink_(sink)
+    , threshold_(threshold)
+    , utf8_(codec_->mibEnum() == 106) // UTF-8
+{
+    // reserved capacity survives resize(0), so
+    // buffers handed to the sink can be reused
+    buffer_.reserve(threshold_ + threshold_ / 4);
+}
+
+QtTableModelWriter::~QtTableModelWriter()
+{
+    delete encoder_;
+}
+
+QTextCodec *QtTableModelWriter::codec() const
+{
+    return codec_;
+}
+
+bool QtTableModelWriter::isUtf8() const
+{
+    return utf8_;
+}
+
+void QtTableModelWriter::write(const QString &text)
+{
+    write(QStringView(text));
+}
+
+void QtTableModelWriter::write(QStringView text)
+{
+    if (text.isEmpty())
+        return;
+
+    if (utf8_)
+        buffer_.append(text.toUtf8());
+    else
+        buffer_.append(encoder_->fromUnicode(text.data(), static_cast<int>(text.size())));
+}
+
+void QtTableModelWriter::flush()
+{
+    if (buffer_.isEmpty())
+        return;
+
+    if (sink_)
+        sink_(buffer_);
+    else
+        buffer_.resize(0);
+}
+
+
+void QtTableModelSerializer::begin(QtTableModelWriter &, const QVector<QVariant> &)
+{
+}
+
+void QtTableModelSerializer::end(QtTableModelWriter &)
+{
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <QByteArray>
+#include <QString>
+#include <QVariant>
+#include <QVector>
+
+#include <functional>
+
+#include <QtWidgetsExtra>
+
+class QTextCodec;
+class QTextEncoder;
+
+//
+// QtTableModelWriter accumulates serialized data into the
+// memory buffer, once the buffer grows over the threshold
+// (checked by commit() after every row) it is handed to the
+// sink, which takes its content and leaves the spare buffer
+// in place, so the writer continues without reallocation
+//
+class QTWIDGETSEXTRA_EXPORT QtTableModelWriter
+{
+    Q_DISABLE_COPY(QtTableModelWriter)
+public:
+    typedef std::function<void(QByteArray&)> Sink;
+
+    QtTableModelWriter(QTextCodec* codec, int threshold, const Sink& sink);
+    ~QtTableModelWriter();
+
+    QTextCodec* codec() const;
+    bool isUtf8() const;
+
+    // raw bytes, already encoded
+    inline void write(char c) { buffer_.append(c); }
+    inline void write(const char* data, int size) { buffer_.append(data, size); }
+    inline void write(const QByteArray& data) { buffer_.append(data); }
+    inline void write(QLatin1String text) { buffer_.append(text.data(), text.size()); }
+
+    // text encoded with the writer codec
+    void write(const QString& text);
+    void write(QStringView text);
+
+    // buffer for serializers which encode data on their own
+    inline QByteArray& buffer() { return buffer_; }
+
+    // hands the buffer to the sink if it's full
+    inline void commit()
+    {
+        if (buffer_.size() >= threshold_)
+            flush();
+    }
+
+    // hands the buffer to the sink unconditionally
+    void flush();
+
+private:
+    QByteArray buffer_;
+    QTextCodec* codec_;
+    QTextEncoder* encoder_;
+    Sink sink_;
+    int threshold_;
+    bool utf8_;
+};
+
+
+//
+// QtTableModelSerializer writes the table into the writer.
+// Serializer is created by QtTableModelExporter::createSerializer()
+// on the thread of the model and takes a copy of all exporter
+// settings it needs, after that its methods are called from the
+// worker thread with data snapshotted from the model, so they
+// should never touch the model or the exporter. Serializer that
+// can't continue sets the error string, the export is canceled
+// then and fails with that error
+//
+class QTWIDGETSEXTRA_EXPORT QtTableModelSerializer
+{
+public:
+    virtual ~QtTableModelSerializer() {}
+
+    // header holds horizontal header of every column
+    virtual void begin(QtTableModelWriter& writer, const QVector<QVariant>& header);
+
+    // values holds item data of every column of the row
+    virtual void writeRow(QtTableModelWriter& writer, int row, const QVariant* values, int count) = 0;
+
+    virtual void end(QtTableModelWriter& writer);
+
+    inline bool hasError() const { return !errorString_.isEmpty(); }
+    inline const QString& errorString() const { return errorString_; }
+
+protected:
+    inline void setErrorString(const QString& text) { errorString_ = text; }
+
+private:
+    QString errorString_;
+};
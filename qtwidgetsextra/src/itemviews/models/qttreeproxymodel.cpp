@@ -1,4 +1,7 @@
+#include <algorithm>
+#include <iterator>
 #include <vector>
+#include <QMultiHash>
 #include <QPointer>
 
 #include "qttreeproxymodel.h"
@@ -9,18 +12,31 @@ namespace
 struct Group
 {
     QVariant key;
-    int childCount;
+    std::vector<int> rows; // sorted source rows of the group
 
-    Group(const QVariant& k)  : key(k), childCount(1) {}
+    Group(const QVariant& k)  : key(k) {}
 
-    bool operator ==(const QVariant& value) {
-        return key == value;
+    int position(int sourceRow) const
+    {
+        return static_cast<int>(std::lower_bound(rows.begin(), rows.end(), sourceRow) - rows.begin());
     }
+};
 
-    bool operator !=(const QVariant& value) {
-        return key != value;
+// groups are hashed by the string form of their keys, hash
+// hits are verified with QVariant comparison, so keys which
+// have no string form just share the same bucket
+typedef QMultiHash<QString, int> GroupIndex;
+
+int lookupGroup(const GroupIndex& index, const std::vector<Group>& groups, const QVariant& key, int offset = 0)
+{
+    const QString hashKey = key.toString();
+    for (auto it = index.constFind(hashKey); it != index.cend() && it.key() == hashKey; ++it)
+    {
+        if (groups[*it - offset].key == key)
+            return *it;
     }
-};
+    return -1;
+}
 
 }
 
@@ -29,6 +45,8 @@ class QtTreeProxyModelPrivate
 public:
     QPointer<QAbstractItemModel> model;
     std::vector<Group> groups;
+    GroupIndex groupIndex;
+    std::vector<int> rowGroups; // group of each source row
     int groupColumn, groupRole;
 
     QtTreeProxyModelPrivate()
@@ -37,21 +55,58 @@ public:
         , groupRole(Qt::DisplayRole)
     {}
 
-    int sourceRowForGroup(const QVariant& key, int expectedSourceRow) const
+    QVariant groupKey(int sourceRow) const
+    {
+        return model->index(sourceRow, groupColumn).data(groupRole);
+    }
+
+    int findGroup(const QVariant& key) const
+    {
+        return lookupGroup(groupIndex, groups, key);
+    }
+
+    void clear()
     {
-        // Scan the source model and find row number in it
-        // that corresponds with parent group key
-        for (int i = 0, k = 0; i < model->rowCount(); ++i)
+        groups.clear();
+        groupIndex.clear();
+        rowGroups.clear();
+    }
+
+    void rebuild()
+    {
+        clear();
+        if (!model)
+            return;
+
+        // populate groups from source model
+        const int count = model->rowCount();
+        rowGroups.reserve(count);
+        for (int i = 0; i < count; ++i)
         {
-            const QVariant value = model->index(i, groupColumn).data(groupRole);
-            if (value == key)
+            const QVariant value = groupKey(i);
+            int g = findGroup(value);
+            if (g == -1)
             {
-                if (k == expectedSourceRow)
-                    return i;
-                ++k;
+                g = static_cast<int>(groups.size());
+                groups.emplace_back(value);
+                groupIndex.insert(value.toString(), g);
             }
+            groups[g].rows.push_back(i);
+            rowGroups.push_back(g);
+        }
+    }
+
+    // restore group positions after groups were erased
+    void reindex()
+    {
+        groupIndex.clear();
+        std::fill(rowGroups.begin(), rowGroups.end(), -1);
+        for (int g = 0, n = static_cast<int>(groups.size()); g < n; ++g)
+        {
+            groupIndex.insert(groups[g].key.toString(), g);
+            for (int row : groups[g].rows)
+                rowGroups[row] = g;
         }
-        return -1;
     }
 };
 
@@ -76,7 +131,10 @@ void QtTreeProxyModel::setSourceModel(QAbstractItemModel *model)
     {
         disconnect(d->model, &QAbstractItemModel::rowsInserted, this, &QtTreeProxyModel::onSourceRowsInserted);
         disconnect(d->model, &QAbstractItemModel::rowsRemoved, this, &QtTreeProxyModel::onSourceRowsRemoved);
+        disconnect(d->model, &QAbstractItemModel::rowsMoved, this, &QtTreeProxyModel::onSourceReset);
         disconnect(d->model, &QAbstractItemModel::dataChanged, this, &QtTreeProxyModel::onSourceDataChanged);
+        disconnect(d->model, &QAbstractItemModel::layoutChanged, this, &QtTreeProxyModel::onSourceReset);
+        disconnect(d->model, &QAbstractItemModel::modelReset, this, &QtTreeProxyModel::onSourceReset);
         disconnect(d->model, &QAbstractItemModel::destroyed, this, &QtTreeProxyModel::onSourceDestroyed);
     }
 
@@ -86,11 +144,14 @@ void QtTreeProxyModel::setSourceModel(QAbstractItemModel *model)
     {
         connect(d->model, &QAbstractItemModel::rowsInserted, this, &QtTreeProxyModel::onSourceRowsInserted);
         connect(d->model, &QAbstractItemModel::rowsRemoved, this, &QtTreeProxyModel::onSourceRowsRemoved);
+        connect(d->model, &QAbstractItemModel::rowsMoved, this, &QtTreeProxyModel::onSourceReset);
         connect(d->model, &QAbstractItemModel::dataChanged, this, &QtTreeProxyModel::onSourceDataChanged);
+        connect(d->model, &QAbstractItemModel::layoutChanged, this, &QtTreeProxyModel::onSourceReset);
+        connect(d->model, &QAbstractItemModel::modelReset, this, &QtTreeProxyModel::onSourceReset);
         connect(d->model, &QAbstractItemModel::destroyed, this, &QtTreeProxyModel::onSourceDestroyed);
     }
 
-    onSourceReset(); // update our groups
+    d->rebuild(); // update our groups
 
     endResetModel();
 }
@@ -141,8 +202,32 @@ int QtTreeProxyModel::groupNameRole() const
     return d->groupRole;
 }
 
+QModelIndex QtTreeProxyModel::mapToSource(const QModelIndex &proxyIndex) const
+{
+    if (!d->model || !proxyIndex.isValid() || proxyIndex.internalId() == quintptr(-1))
+        return QModelIndex();
+
+    const Group& group = d->groups[proxyIndex.internalId()];
+    return d->model->index(group.rows[proxyIndex.row()], proxyIndex.column());
+}
+
+QModelIndex QtTreeProxyModel::mapFromSource(const QModelIndex &sourceIndex) const
+{
+    if (!d->model || !sourceIndex.isValid() || sourceIndex.model() != d->model || sourceIndex.parent().isValid())
+        return QModelIndex();
+
+    const int g = d->rowGroups[sourceIndex.row()];
+    if (g == -1)
+        return QModelIndex();
+
+    return createIndex(d->groups[g].position(sourceIndex.row()), sourceIndex.column(), quintptr(g));
+}
+
 QModelIndex QtTreeProxyModel::index(int row, int column, const QModelIndex &parent) const
 {
+    if (!hasIndex(row, column, parent))
+        return QModelIndex();
+
     // Here is a tricky part:
     // - if we have a parent set internal id to it row
     // - otherwise set internal id to -1 sentinel
@@ -164,7 +249,7 @@ QModelIndex QtTreeProxyModel::parent(const QModelIndex &child) const
     // - if internal id is something other than -1 than the child is some child so we need to set
     // column of parent to 0 when creating the parent index, to escape selection issues
 
-    if (child.internalId() == -1)
+    if (child.internalId() == quintptr(-1))
         return QModelIndex();
     else
         return createIndex(child.internalId(), 0, quintptr(-1));
@@ -174,9 +259,9 @@ int QtTreeProxyModel::rowCount(const QModelIndex &parent) const
 {
      
     if (parent.isValid())
-        return (parent.internalId() == -1 ? d->groups[parent.row()].childCount : 0);
+        return (parent.internalId() == quintptr(-1) ? static_cast<int>(d->groups[parent.row()].rows.size()) : 0);
     else
-        return d->groups.size();
+        return static_cast<int>(d->groups.size());
 }
 
 int QtTreeProxyModel::columnCount(const QModelIndex &parent) const
@@ -191,10 +276,9 @@ QVariant QtTreeProxyModel::data(const QModelIndex &proxyIndex, int role) const
     if (!proxyIndex.isValid() || !d->model)
         return QVariant();
 
-    const int id = proxyIndex.internalId();
     const int r = proxyIndex.row();
     const int c = proxyIndex.column();
-    if (id == -1) // top-level item
+    if (proxyIndex.internalId() == quintptr(-1)) // top-level item
     {
         if (c != d->groupColumn)
             return QVariant();
@@ -205,15 +289,7 @@ QVariant QtTreeProxyModel::data(const QModelIndex &proxyIndex, int role) const
         return d->groups[r].key;
     }
 
-    const QModelIndex parent = proxyIndex.parent();
-    if (!parent.isValid())
-        return QVariant();
-
-    const int row = d->sourceRowForGroup(d->groups[parent.row()].key, r);
-    if (row == -1)
-        return QVariant();
-    else
-        return d->model->index(row, c).data(role);
+    return mapToSource(proxyIndex).data(role);
 }
 
 QVariant QtTreeProxyModel::headerData(int section, Qt::Orientation orientation, int role) const
@@ -228,69 +304,226 @@ QVariant QtTreeProxyModel::headerData(int section, Qt::Orientation orientation,
 void QtTreeProxyModel::onSourceRowsInserted(const QModelIndex &parent, int first, int last)
 {
      
-    if (!d->model)
+    if (!d->model || parent.isValid())
         return;
 
-    // populate groups from source model
+    const int count = last - first + 1;
+    for (Group& group : d->groups)
+    {
+        for (auto it = group.rows.begin() + group.position(first); it != group.rows.end(); ++it)
+            *it += count;
+    }
+    d->rowGroups.insert(d->rowGroups.begin() + first, count, -1);
+
+    // split inserted rows into ones joining existing groups
+    // and ones that start new groups
+    std::vector<std::pair<int, int>> joins; // group, source row
+    std::vector<Group> created;
+    GroupIndex createdIndex;
+    const int groupCount = static_cast<int>(d->groups.size());
     for (int i = first; i <= last; ++i)
     {
-        QVariant value = d->model->index(i, d->groupColumn).data(d->groupRole);
-        auto it = std::find(d->groups.begin(), d->groups.end(), value);
-        if (it == d->groups.end())
-            d->groups.emplace_back(value);
-        else
-            ++it->childCount;
+        const QVariant value = d->groupKey(i);
+        const int g = d->findGroup(value);
+        if (g != -1)
+        {
+            joins.emplace_back(g, i);
+            continue;
+        }
+
+        int k = lookupGroup(createdIndex, created, value, groupCount);
+        if (k == -1)
+        {
+            k = groupCount + static_cast<int>(created.size());
+            created.emplace_back(value);
+            createdIndex.insert(value.toString(), k);
+        }
+        created[k - groupCount].rows.push_back(i);
     }
+
+    // inserted rows are the contiguous block of every group
+    std::stable_sort(joins.begin(), joins.end(), [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+        return a.first < b.first;
+    });
+    for (auto it = joins.begin(); it != joins.end(); )
+    {
+        const int g = it->first;
+        auto end = std::find_if(it, joins.end(), [g](const std::pair<int, int>& join) { return join.first != g; });
+
+        Group& group = d->groups[g];
+        const int pos = group.position(first);
+        beginInsertRows(index(g, 0, QModelIndex()), pos, pos + static_cast<int>(end - it) - 1);
+        for (auto row = group.rows.begin() + pos; it != end; ++it, ++row)
+        {
+            row = group.rows.insert(row, it->second);
+            d->rowGroups[it->second] = g;
+        }
+        endInsertRows();
+    }
+
+    if (created.empty())
+        return;
+
+    beginInsertRows(QModelIndex(), groupCount, groupCount + static_cast<int>(created.size()) - 1);
+    for (Group& group : created)
+    {
+        for (int row : group.rows)
+            d->rowGroups[row] = static_cast<int>(d->groups.size());
+        d->groups.emplace_back(std::move(group));
+    }
+    d->groupIndex.unite(createdIndex);
+    endInsertRows();
 }
 
 void QtTreeProxyModel::onSourceRowsRemoved(const QModelIndex &parent, int first, int last)
 {
      
+    if (!d->model || parent.isValid())
+        return;
 
-    // populate groups from source model
-    for (int i = first; i <= last; ++i)
+    // removed rows form the contiguous block of every group,
+    // rows following the block are shifted at once, so the
+    // remaining items are mapped correctly while notifying
+    struct Block { int group, first, count; };
+    const int count = last - first + 1;
+    std::vector<Block> blocks;
+    for (int g = 0, n = static_cast<int>(d->groups.size()); g < n; ++g)
     {
-        QVariant value = d->model->index(i, d->groupColumn).data(d->groupRole);
-        auto it = std::find(d->groups.begin(), d->groups.end(), value);
-        if (it != d->groups.end())
-            --it->childCount;
+        Group& group = d->groups[g];
+        const int lo = group.position(first);
+        const int hi = group.position(last + 1);
+        for (auto it = group.rows.begin() + hi; it != group.rows.end(); ++it)
+            *it -= count;
+
+        if (lo != hi)
+            blocks.push_back({ g, lo, hi - lo });
+    }
+    d->rowGroups.erase(d->rowGroups.begin() + first, d->rowGroups.begin() + last + 1);
 
-        if (it->childCount == 0)
-            d->groups.erase(it);
+    for (const Block& block : blocks)
+    {
+        auto& rows = d->groups[block.group].rows;
+        beginRemoveRows(index(block.group, 0, QModelIndex()), block.first, block.first + block.count - 1);
+        rows.erase(rows.begin() + block.first, rows.begin() + block.first + block.count);
+        endRemoveRows();
     }
-}
 
-void QtTreeProxyModel::onSourceDataChanged(const QModelIndex &, const QModelIndex &, const QVector<int> &roles)
-{
-     
-    if (std::find(roles.begin(), roles.end(), d->groupRole))
-        onSourceReset(); // update all groups
+    // drop groups left without rows, adjacent ones at once
+    for (auto it = blocks.rbegin(); it != blocks.rend(); )
+    {
+        if (!d->groups[it->group].rows.empty())
+        {
+            ++it;
+            continue;
+        }
+
+        const int lastGroup = it->group;
+        int firstGroup = lastGroup;
+        for (++it; it != blocks.rend() && it->group == firstGroup - 1 && d->groups[it->group].rows.empty(); ++it)
+            --firstGroup;
+
+        beginRemoveRows(QModelIndex(), firstGroup, lastGroup);
+        d->groups.erase(d->groups.begin() + firstGroup, d->groups.begin() + lastGroup + 1);
+        d->reindex();
+        endRemoveRows();
+    }
 }
 
-void QtTreeProxyModel::onSourceReset()
+void QtTreeProxyModel::onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles)
 {
      
-    d->groups.clear();
-
-    if (!d->model)
+    if (!d->model || topLeft.parent().isValid())
         return;
 
-    // populate groups from source model
-    for (int i = 0; i < d->model->rowCount(); ++i)
+    const bool regroup = topLeft.column() <= d->groupColumn && d->groupColumn <= bottomRight.column() &&
+                         (roles.isEmpty() || roles.contains(d->groupRole));
+
+    std::vector<std::pair<int, int>> changed; // group, position
+    std::vector<std::pair<int, QVariant>> moved; // source row, new group key
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row)
     {
-        QVariant value = sourceModel()->index(i, d->groupColumn).data(d->groupRole);
-        auto it = std::find(d->groups.begin(), d->groups.end(), value);
-        if (it == d->groups.end())
-            d->groups.emplace_back(value);
-        else
-            ++it->childCount;
+        const int g = d->rowGroups[row];
+        if (regroup)
+        {
+            QVariant value = d->groupKey(row);
+            if (d->groups[g].key != value)
+            {
+                moved.emplace_back(row, std::move(value));
+                continue;
+            }
+        }
+        changed.emplace_back(g, d->groups[g].position(row));
+    }
+
+    // rows staying in their groups are notified with
+    // the single range per group
+    std::sort(changed.begin(), changed.end());
+    for (auto it = changed.begin(); it != changed.end(); )
+    {
+        const int g = it->first;
+        auto end = std::find_if(it, changed.end(), [g](const std::pair<int, int>& item) { return item.first != g; });
+        const QModelIndex parent = index(g, 0, QModelIndex());
+        Q_EMIT dataChanged(index(it->second, topLeft.column(), parent),
+                           index(std::prev(end)->second, bottomRight.column(), parent), roles);
+        it = end;
     }
+
+    for (const auto& item : moved)
+        regroupSourceRow(item.first, item.second);
+}
+
+void QtTreeProxyModel::onSourceReset()
+{
+     
+    beginResetModel();
+    d->rebuild();
+    endResetModel();
 }
 
 void QtTreeProxyModel::onSourceDestroyed()
 {
      
     beginResetModel();
-    d->groups.clear();
+    d->clear();
     endResetModel();
 }
+
+void QtTreeProxyModel::regroupSourceRow(int sourceRow, const QVariant &key)
+{
+    const int from = d->rowGroups[sourceRow];
+    auto& rows = d->groups[from].rows;
+    const int pos = d->groups[from].position(sourceRow);
+    beginRemoveRows(index(from, 0, QModelIndex()), pos, pos);
+    rows.erase(rows.begin() + pos);
+    d->rowGroups[sourceRow] = -1;
+    endRemoveRows();
+
+    if (rows.empty())
+    {
+        beginRemoveRows(QModelIndex(), from, from);
+        d->groups.erase(d->groups.begin() + from);
+        d->reindex();
+        endRemoveRows();
+    }
+
+    const int to = d->findGroup(key);
+    if (to == -1)
+    {
+        const int g = static_cast<int>(d->groups.size());
+        beginInsertRows(QModelIndex(), g, g);
+        d->groups.emplace_back(key);
+        d->groups.back().rows.push_back(sourceRow);
+        d->groupIndex.insert(key.toString(), g);
+        d->rowGroups[sourceRow] = g;
+        endInsertRows();
+    }
+    else
+    {
+        Group& group = d->groups[to];
+        const int at = group.position(sourceRow);
+        beginInsertRows(index(to, 0, QModelIndex()), at, at);
+        group.rows.insert(group.rows.begin() + at, sourceRow);
+        d->rowGroups[sourceRow] = to;
+        endInsertRows();
+    }
+}
@@ -30,6 +30,11 @@ public:
     void setGroupNameRole(int role);
     int groupNameRole() const;
 
+    // maps child items to source rows and back without scanning
+    // the source model, top-level group items have no source row
+    QModelIndex mapToSource(const QModelIndex& proxyIndex) const;
+    QModelIndex mapFromSource(const QModelIndex& sourceIndex) const;
+
     // QAbstractItemModel interface
 public:
     QModelIndex index(int row, int column, const QModelIndex &parent) const Q_DECL_OVERRIDE;
@@ -42,7 +47,7 @@ public:
 private Q_SLOTS:
     void onSourceRowsInserted(const QModelIndex &parent, int first, int last);
     void onSourceRowsRemoved(const QModelIndex &parent, int first, int last);
-    void onSourceDataChanged(const QModelIndex &, const QModelIndex &, const QVector<int> &roles);
+    void onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles);
     void onSourceReset();
     void onSourceDestroyed();
 
@@ -51,5 +56,7 @@ Q_SIGNALS:
     void groupNameRoleChanged(int);
 
 private:
+    void regroupSourceRow(int sourceRow, const QVariant& key);
+
     QScopedPointer<class QtTreeProxyModelPrivate> d;
 };
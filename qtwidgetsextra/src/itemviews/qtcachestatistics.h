@@ -0,0 +1,41 @@
+#pragma once
+#include <QtGlobal>
+
+//
+// QtCacheStatistics is the snapshot of cache counters of item views
+// helpers (QtItemWidgetDelegate, QtCachingProxyModel), so the cache
+// limits can be tuned against the real hit rate and memory usage
+//
+struct QtCacheStatistics
+{
+    quint64 hits = 0;      // lookups served from the cache
+    quint64 misses = 0;    // lookups that had to compute the value
+    quint64 inserts = 0;   // values put into the cache
+    quint64 evictions = 0; // values dropped due to the cache limits
+    qint64 size = 0;       // number of values in the cache
+    qint64 peakSize = 0;
+    qint64 bytes = 0;      // estimated memory occupied by the values
+    qint64 peakBytes = 0;
+
+    // converts counters collected by Qt5Extra::CacheStats<> policy
+    template<class _Counters>
+    static QtCacheStatistics fromCounters(const _Counters& counters)
+    {
+        QtCacheStatistics result;
+        result.hits = counters.hits;
+        result.misses = counters.misses;
+        result.inserts = counters.inserts;
+        result.evictions = counters.evictions;
+        result.size = qint64(counters.size);
+        result.peakSize = qint64(counters.peakSize);
+        result.bytes = qint64(counters.bytes);
+        result.peakBytes = qint64(counters.peakBytes);
+        return result;
+    }
+
+    inline double hitRate() const
+    {
+        const quint64 lookups = hits + misses;
+        return lookups > 0 ? double(hits) / double(lookups) : 0.0;
+    }
+};
@@ -1,37 +1,507 @@
 #include "qtmessagelogmodel.h"
+#include "../itemviews/models/qtitemfilter.h"
+
+#include <QHash>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <iterator>
+#include <memory>
 #include <vector>
 
+// strings are referenced by the id of the
+// category and the range in the message arena
 struct LogRecord
 {
-    QDateTime timestamp;
+    qint64 timestamp = 0; // msecs since epoch
+    quint32 category = 0;
+    quint32 chunk = 0;
+    quint32 offset = 0;
+    quint32 length = 0;
+    int level = 0;
+    int code = -1;
+};
+
+namespace
+{
+
+constexpr int kDefaultDrainInterval = 50;
+constexpr size_t kQueueCapacity = 8192; // power of 2
+
+struct QueuedRecord
+{
+    qint64 msecs = 0;
     QString category;
     QString message;
     int level = 0;
     int code = -1;
 };
 
+//
+// Bounded multi-producer single-consumer queue over the preallocated
+// slots. Producers claim the slot by advancing the tail, the sequence
+// of the slot tells whether it's free, written or read, so neither
+// side takes a lock. The queue never grows, if it's full the record
+// is dropped instead of blocking the producer
+//
+class LogQueue
+{
+    Q_DISABLE_COPY(LogQueue)
+public:
+    explicit LogQueue(size_t capacity)
+        : slots(new Slot[capacity])
+        , mask(capacity - 1)
+    {
+        Q_ASSERT((capacity & mask) == 0);
+        for (size_t i = 0; i < capacity; ++i)
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    bool push(int level, int code, const QString& category, const QString& message, qint64 msecs)
+    {
+        size_t position = tail.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+        for (;;)
+        {
+            slot = &slots[position & mask];
+            const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const ptrdiff_t delta = ptrdiff_t(sequence - position);
+            if (delta == 0)
+            {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (delta < 0)
+            {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+                position = tail.load(std::memory_order_relaxed);
+        }
+
+        QueuedRecord& r = slot->record;
+        r.msecs = msecs;
+        r.category = category;
+        r.message = message;
+        r.level = level;
+        r.code = code;
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // single consumer only
+    template<class F>
+    size_t drain(F consume)
+    {
+        size_t count = 0;
+        for (; count <= mask; ++count, ++head)
+        {
+            Slot& slot = slots[head & mask];
+            if (slot.sequence.load(std::memory_order_acquire) != head + 1)
+                break;
+
+            consume(slot.record);
+            slot.sequence.store(head + mask + 1, std::memory_order_release);
+        }
+        return count;
+    }
+
+    quint64 droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        QueuedRecord record;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    const size_t mask;
+    alignas(64) std::atomic<size_t> tail{ 0 };
+    alignas(64) size_t head = 0;
+    std::atomic<quint64> dropped{ 0 };
+};
+
+//
+// Messages are appended to the chunks in the order of records, so
+// chunks are released from the front as the oldest records go away.
+// A message longer than the chunk gets the chunk of its own
+//
+class MessageArena
+{
+public:
+    void append(const QString& text, LogRecord& record)
+    {
+        const int length = text.size();
+        if (chunks.empty() || chunks.back().capacity - chunks.back().used < length)
+            allocate(length);
+
+        Chunk& chunk = chunks.back();
+        std::copy(text.constData(), text.constData() + length, chunk.data.get() + chunk.used);
+        record.chunk = first + quint32(chunks.size() - 1);
+        record.offset = quint32(chunk.used);
+        record.length = quint32(length);
+        chunk.used += length;
+    }
+
+    QString text(const LogRecord& record) const
+    {
+        const Chunk& chunk = chunks[record.chunk - first];
+        return QString(chunk.data.get() + record.offset, int(record.length));
+    }
+
+    // releases chunks preceding the given one
+    void release(quint32 chunk)
+    {
+        for (; first != chunk && !chunks.empty(); ++first)
+        {
+            if (chunks.front().capacity == kChunkSize)
+                spare = std::move(chunks.front());
+            chunks.pop_front();
+        }
+    }
+
+    void clear()
+    {
+        release(first + quint32(chunks.size()));
+    }
+
+private:
+    static constexpr int kChunkSize = 32768; // QChars
+
+    struct Chunk
+    {
+        std::unique_ptr<QChar[]> data;
+        int capacity = 0;
+        int used = 0;
+    };
+
+    void allocate(int length)
+    {
+        Chunk chunk;
+        if (spare.capacity >= length)
+            std::swap(chunk, spare);
+        else
+        {
+            chunk.capacity = std::max(length, kChunkSize);
+            chunk.data.reset(new QChar[chunk.capacity]);
+        }
+        chunk.used = 0;
+        chunks.push_back(std::move(chunk));
+    }
+
+    std::deque<Chunk> chunks;
+    quint32 first = 0; // number of chunks.front()
+    Chunk spare;       // the last released chunk, it's reused first
+};
+
+inline bool isWordChar(QChar c)
+{
+    return c.isLetterOrNumber() || c == QLatin1Char('_');
+}
+
+// calls f(start, length) for every word of the text
+template<class F>
+void forEachWord(const QString& text, F f)
+{
+    const QChar* p = text.constData();
+    const int n = text.size();
+    for (int i = 0; i < n; )
+    {
+        while (i < n && !isWordChar(p[i]))
+            ++i;
+
+        const int start = i;
+        while (i < n && isWordChar(p[i]))
+            ++i;
+
+        if (i > start)
+            f(p + start, i - start);
+    }
+}
+
+// three characters of the word packed into the key
+inline quint64 trigramKey(const QChar* p)
+{
+    return quint64(p[0].unicode()) | (quint64(p[1].unicode()) << 16) | (quint64(p[2].unicode()) << 32);
+}
+
+// the handler holds the queue, not the model, so a message
+// posted while the model is being destroyed is still safe
+std::shared_ptr<LogQueue> handlerQueue;
+std::atomic<QtMessageHandler> previousHandler{ nullptr };
+
+void logMessageHandler(QtMsgType type, const QMessageLogContext& context, const QString& message)
+{
+    if (auto queue = std::atomic_load(&handlerQueue))
+    {
+        const QString category = QString::fromLatin1(context.category ? context.category : "default");
+        queue->push(int(type), -1, category, message, QDateTime::currentMSecsSinceEpoch());
+    }
+
+    if (QtMessageHandler previous = previousHandler.load())
+        previous(type, context, message);
+}
+
+}
+
 
 class QtMessageLogModelPrivate
 {
 public:
-    std::vector<LogRecord> recordCache;
-    int current;
+    // circular, records[head] is the row 0
+    std::vector<LogRecord> records;
+    int head;
+    int count;
     int maxSize;
 
-    QtMessageLogModelPrivate(int size) : current(0), maxSize(size) {
-        recordCache.reserve(size);
+    MessageArena messages;
+    std::vector<QString> categories;
+    QHash<QString, quint32> categoryIds;
+
+    // inverted index of message words (case folded), the postings are
+    // sequence numbers of records in ascending order, row 0 is firstSequence
+    QHash<QString, std::vector<quint32>> words;
+    // words by their trigrams, for words of the pattern that may be a part of the message word
+    QHash<quint64, std::vector<QString>> trigrams;
+    quint32 firstSequence;
+    quint32 prunedSequence; // postings were pruned up to this one
+
+    // records of message() and drain() waiting for commit()
+    std::vector<QueuedRecord> staged;
+    std::shared_ptr<LogQueue> queue;
+    QTimer drainTimer;
+
+    QtMessageLogModelPrivate(int size)
+        : head(0), count(0), maxSize(std::max(size, 1))
+        , firstSequence(0), prunedSequence(0)
+        , queue(std::make_shared<LogQueue>(kQueueCapacity))
+    {
+        records.reserve(maxSize);
     }
 
+    inline const LogRecord& record(int row) const { return records[(head + row) % maxSize]; }
+
+    quint32 category(const QString& name);
+    void append(const QueuedRecord& r);
+    void removeFirst(int n);
+
+    void indexWords(const QString& text, quint32 sequence);
+    void indexTrigrams(const QString& word);
+    void pruneWords();
+    std::vector<int> rowsWithWord(const QString& word, bool openStart, bool openEnd) const;
+    QVector<int> scanRows(int section, const QtItemFilter& filter) const;
+
     bool validate(const QModelIndex& index) const;
     QVariant display(int row, int column) const;
     QVariant value(int row, int column) const;
     QVariant tooltip(int row, int column) const;
 };
 
+quint32 QtMessageLogModelPrivate::category(const QString& name)
+{
+    auto it = categoryIds.constFind(name);
+    if (it != categoryIds.cend())
+        return *it;
+
+    const quint32 id = quint32(categories.size());
+    categories.push_back(name);
+    categoryIds.insert(name, id);
+    return id;
+}
+
+void QtMessageLogModelPrivate::append(const QueuedRecord& r)
+{
+    LogRecord record;
+    record.timestamp = r.msecs;
+    record.category = category(r.category);
+    record.level = r.level;
+    record.code = r.code;
+    messages.append(r.message, record);
+    indexWords(r.message, firstSequence + quint32(count));
+
+    const int position = (head + count) % maxSize;
+    if (position == int(records.size()))
+        records.push_back(record);
+    else
+        records[position] = record;
+    ++count;
+}
+
+void QtMessageLogModelPrivate::removeFirst(int n)
+{
+    // the head moves from now on, so the buffer takes its full size
+    if (int(records.size()) < maxSize)
+        records.resize(maxSize);
+
+    head = (head + n) % maxSize;
+    count -= n;
+    if (count > 0)
+        messages.release(records[head].chunk);
+    else
+        messages.clear();
+
+    // postings are pruned once the whole log is rotated, so it's O(1) per record
+    firstSequence += quint32(n);
+    if (firstSequence - prunedSequence >= quint32(maxSize))
+        pruneWords();
+}
+
+void QtMessageLogModelPrivate::indexWords(const QString& text, quint32 sequence)
+{
+    forEachWord(text, [this, sequence](const QChar* word, int length) {
+        const QString key = QString(word, length).toCaseFolded();
+        auto it = words.find(key);
+        if (it == words.end())
+        {
+            it = words.insert(key, std::vector<quint32>());
+            indexTrigrams(key);
+        }
+
+        std::vector<quint32>& posting = *it;
+        if (posting.empty() || posting.back() != sequence)
+            posting.push_back(sequence);
+    });
+}
+
+void QtMessageLogModelPrivate::indexTrigrams(const QString& word)
+{
+    const int n = word.size() - 2;
+    if (n <= 0)
+        return;
+
+    std::vector<quint64> keys;
+    keys.reserve(size_t(n));
+    for (int i = 0; i < n; ++i)
+        keys.push_back(trigramKey(word.constData() + i));
+
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    for (quint64 key : keys)
+        trigrams[key].push_back(word);
+}
+
+void QtMessageLogModelPrivate::pruneWords()
+{
+    // sequence numbers may wrap, so records are compared by their distance from the row 0
+    const quint32 alive = quint32(count);
+    int erased = 0;
+    for (auto it = words.begin(); it != words.end(); )
+    {
+        std::vector<quint32>& posting = *it;
+        auto last = std::find_if(posting.begin(), posting.end(), [this, alive](quint32 sequence) {
+            return sequence - firstSequence < alive;
+        });
+        posting.erase(posting.begin(), last);
+
+        if (posting.empty())
+        {
+            it = words.erase(it);
+            ++erased;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    prunedSequence = firstSequence;
+
+    if (erased == 0)
+        return;
+
+    for (auto it = trigrams.begin(); it != trigrams.end(); )
+    {
+        std::vector<QString>& list = *it;
+        list.erase(std::remove_if(list.begin(), list.end(), [this](const QString& word) {
+            return !words.contains(word);
+        }), list.end());
+
+        if (list.empty())
+            it = trigrams.erase(it);
+        else
+            ++it;
+    }
+}
+
+std::vector<int> QtMessageLogModelPrivate::rowsWithWord(const QString& word, bool openStart, bool openEnd) const
+{
+    std::vector<int> rows;
+    auto collect = [this, &rows](const std::vector<quint32>& posting) {
+        for (quint32 sequence : posting)
+        {
+            const quint32 row = sequence - firstSequence;
+            if (row < quint32(count))
+                rows.push_back(int(row));
+        }
+    };
+
+    // the word delimited in the pattern is the whole word of the message
+    if (!openStart && !openEnd)
+    {
+        auto it = words.constFind(word);
+        if (it != words.cend())
+            collect(*it);
+        return rows;
+    }
+
+    // otherwise it's the end, the start or a part of the message word
+    auto matches = [&word, openStart, openEnd](const QString& candidate) {
+        if (openStart && openEnd)
+            return candidate.contains(word);
+        return openStart ? candidate.endsWith(word) : candidate.startsWith(word);
+    };
+
+    // candidates are the words having the rarest trigram of the word,
+    // words shorter than the trigram are rare in the patterns
+    const std::vector<QString>* candidates = Q_NULLPTR;
+    for (int i = 0, n = word.size() - 2; i < n; ++i)
+    {
+        auto it = trigrams.constFind(trigramKey(word.constData() + i));
+        if (it == trigrams.cend())
+            return rows;
+
+        if (!candidates || it->size() < candidates->size())
+            candidates = &*it;
+    }
+
+    if (candidates)
+    {
+        for (const QString& candidate : *candidates)
+            if (matches(candidate))
+                collect(*words.constFind(candidate));
+    }
+    else
+    {
+        for (auto it = words.cbegin(); it != words.cend(); ++it)
+            if (matches(it.key()))
+                collect(*it);
+    }
+
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    return rows;
+}
+
+QVector<int> QtMessageLogModelPrivate::scanRows(int section, const QtItemFilter& filter) const
+{
+    QVector<int> rows;
+    for (int row = 0; row < count; ++row)
+    {
+        if (filter.acceptedValue(display(row, section)))
+            rows.push_back(row);
+    }
+    return rows;
+}
+
 bool QtMessageLogModelPrivate::validate(const QModelIndex &index) const
 {
     int row = index.row();
-    if (row < 0 || row >= (int)recordCache.size())
+    if (row < 0 || row >= count)
         return false;
 
     int column = index.column();
@@ -42,7 +512,7 @@ bool QtMessageLogModelPrivate::validate(const QModelIndex &index) const
 
 QVariant QtMessageLogModelPrivate::display(int row, int column) const
 {
-    const LogRecord& r = recordCache[row];
+    const LogRecord& r = record(row);
     switch(column)
     {
     case QtMessageLogModel::SectionLevel:
@@ -50,11 +520,11 @@ QVariant QtMessageLogModelPrivate::display(int row, int column) const
     case QtMessageLogModel::SectionCode:
         return r.code;
     case QtMessageLogModel::SectionTimestamp:
-        return r.timestamp;
+        return QDateTime::fromMSecsSinceEpoch(r.timestamp);
     case QtMessageLogModel::SectionCategory:
-        return r.category;
+        return categories[r.category];
     case QtMessageLogModel::SectionMessage:
-        return r.message;
+        return messages.text(r);
     }
     return QVariant();
 }
@@ -80,9 +550,15 @@ QtMessageLogModel::QtMessageLogModel(uint maxSize, QObject *parent)
     : QAbstractTableModel(parent)
     , d(new QtMessageLogModelPrivate(maxSize))
 {
+    connect(&d->drainTimer, &QTimer::timeout, this, &QtMessageLogModel::drain);
+    d->drainTimer.start(kDefaultDrainInterval);
 }
 
-QtMessageLogModel::~QtMessageLogModel() = default;
+QtMessageLogModel::~QtMessageLogModel()
+{
+    if (std::atomic_load(&handlerQueue) == d->queue)
+        installMessageHandler(Q_NULLPTR);
+}
 
 QVariant QtMessageLogModel::headerData(int section, Qt::Orientation orientation, int role) const
 {
@@ -113,8 +589,7 @@ int QtMessageLogModel::rowCount(const QModelIndex &parent) const
     if (parent.isValid())
         return 0;
 
-     
-    return d->recordCache.size();
+    return d->count;
 }
 
 int QtMessageLogModel::columnCount(const QModelIndex &parent) const
@@ -154,7 +629,12 @@ QVariant QtMessageLogModel::data(const QModelIndex &index, int role) const
 
 void QtMessageLogModel::setRotationLimit(uint limit)
 {
-    if (limit > 0 && limit > (uint)d->recordCache.size()) {
+    if (limit > 0 && limit > (uint)d->count) {
+        // rows are laid out from the beginning of the buffer again
+        std::rotate(d->records.begin(), d->records.begin() + d->head, d->records.end());
+        d->records.resize(d->count);
+        d->records.reserve(limit);
+        d->head = 0;
         d->maxSize = limit;
     }
 }
@@ -166,38 +646,207 @@ uint QtMessageLogModel::rotationLimit() const
 
 void QtMessageLogModel::message(int level, int code, const QString& category, const QString& message, const QDateTime& timestamp)
 {
-    static const QModelIndex invalid;
+    // queued records go first to keep the order of messages
+    drain();
+    d->staged.emplace_back(QueuedRecord{ timestamp.toMSecsSinceEpoch(), category, message, level, code });
+    commit();
+}
 
-    if (d->current < (int)d->recordCache.size()) {
-        LogRecord& r = d->recordCache[d->current];
-        r.level = level;
-        r.code = code;
-        r.category = category;
-        r.message = message;
-        r.timestamp = timestamp;
-        Q_EMIT dataChanged(index(d->current, 0), index(d->current, MaxSection-1));
-        ++d->current;
-    }
+bool QtMessageLogModel::post(int level, int code, const QString& category, const QString& message)
+{
+    return d->queue->push(level, code, category, message, QDateTime::currentMSecsSinceEpoch());
+}
+
+void QtMessageLogModel::setDrainInterval(int msecs)
+{
+    if (msecs > 0)
+        d->drainTimer.start(msecs);
     else
+        d->drainTimer.stop();
+}
+
+int QtMessageLogModel::drainInterval() const
+{
+    return d->drainTimer.isActive() ? d->drainTimer.interval() : 0;
+}
+
+quint64 QtMessageLogModel::droppedCount() const
+{
+    return d->queue->droppedCount();
+}
+
+QVector<int> QtMessageLogModel::acceptedRows(int section, const QtItemFilter& filter) const
+{
+    QVector<int> rows;
+    switch (section)
+    {
+    case SectionCategory:
+    {
+        std::vector<char> accepted;
+        accepted.reserve(d->categories.size());
+        for (const QString& category : d->categories)
+            accepted.push_back(filter.acceptedValue(category));
+
+        for (int row = 0; row < d->count; ++row)
+            if (accepted[d->record(row).category])
+                rows.push_back(row);
+        return rows;
+    }
+    case SectionLevel:
+    case SectionCode:
+    {
+        QHash<int, bool> accepted;
+        for (int row = 0; row < d->count; ++row)
+        {
+            const LogRecord& r = d->record(row);
+            const int value = (section == SectionLevel ? r.level : r.code);
+            auto it = accepted.find(value);
+            if (it == accepted.end())
+                it = accepted.insert(value, filter.acceptedValue(value));
+            if (*it)
+                rows.push_back(row);
+        }
+        return rows;
+    }
+    case SectionMessage:
+        break;
+    default:
+        return d->scanRows(section, filter);
+    }
+
+    // a message matching the string pattern contains every word of the pattern,
+    // so only rows having all of them in the index are matched against the filter
+    const int type = int(filter.matchFlags() & 0x0F);
+    const bool indexed = filter.condition() == QtItemFilter::Match &&
+                         type != Qt::MatchRegExp && type != Qt::MatchWildcard &&
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 15, 0))
+                         type != Qt::MatchRegularExpression &&
+#endif
+                         filter.pattern().type() == QVariant::String;
+
+    // only the words at the edges of the pattern may be parts of the message
+    // words, the ones delimited by separators are looked up by the exact key
+    struct PatternWord
+    {
+        QString word;
+        bool openStart;
+        bool openEnd;
+    };
+
+    const QString pattern = filter.patternString();
+    const bool openStart = type == Qt::MatchContains || type == Qt::MatchEndsWith;
+    const bool openEnd = type == Qt::MatchContains || type == Qt::MatchStartsWith;
+    std::vector<PatternWord> patternWords;
+    if (indexed)
     {
-        beginInsertRows(invalid, d->current, d->current);
-        d->recordCache.emplace_back(LogRecord{ timestamp, category, message, level, code });
-        endInsertRows();
-        d->current = d->recordCache.size();
+        forEachWord(pattern, [&](const QChar* word, int length) {
+            const int offset = int(word - pattern.constData());
+            patternWords.push_back({ QString(word, length).toCaseFolded(),
+                                     openStart && offset == 0,
+                                     openEnd && offset + length == pattern.size() });
+        });
     }
 
-    if (d->current >= d->maxSize)
+    if (patternWords.empty())
+        return d->scanRows(section, filter);
+
+    // the exact words are the most selective, so they go first
+    std::stable_sort(patternWords.begin(), patternWords.end(), [](const PatternWord& lhs, const PatternWord& rhs) {
+        return (lhs.openStart || lhs.openEnd) < (rhs.openStart || rhs.openEnd);
+    });
+
+    std::vector<int> candidates;
+    for (size_t i = 0; i < patternWords.size(); ++i)
     {
-        d->current = 0;
-        Q_EMIT overflowed();
+        const PatternWord& w = patternWords[i];
+        std::vector<int> found = d->rowsWithWord(w.word, w.openStart, w.openEnd);
+        if (i == 0)
+            candidates.swap(found);
+        else
+        {
+            std::vector<int> both;
+            std::set_intersection(candidates.begin(), candidates.end(), found.begin(), found.end(), std::back_inserter(both));
+            candidates.swap(both);
+        }
+
+        if (candidates.empty())
+            break;
     }
+
+    for (int row : candidates)
+    {
+        if (filter.acceptedValue(d->messages.text(d->record(row))))
+            rows.push_back(row);
+    }
+    return rows;
+}
+
+void QtMessageLogModel::installMessageHandler(QtMessageLogModel* model)
+{
+    if (model)
+    {
+        std::atomic_store(&handlerQueue, model->d->queue);
+        const QtMessageHandler previous = qInstallMessageHandler(logMessageHandler);
+        if (previous != logMessageHandler)
+            previousHandler.store(previous);
+    }
+    else if (std::atomic_exchange(&handlerQueue, std::shared_ptr<LogQueue>()))
+    {
+        qInstallMessageHandler(previousHandler.exchange(nullptr));
+    }
+}
+
+void QtMessageLogModel::drain()
+{
+    d->queue->drain([this](QueuedRecord& r) {
+        d->staged.emplace_back(std::move(r));
+    });
+
+    if (!d->staged.empty())
+        commit();
+}
+
+void QtMessageLogModel::commit()
+{
+    static const QModelIndex invalid;
+
+    // records rotated out within this batch are never shown
+    auto first = d->staged.cbegin();
+    if (d->staged.size() > size_t(d->maxSize))
+        first += d->staged.size() - d->maxSize;
+    const int size = int(d->staged.cend() - first);
+
+    const int removed = std::max(d->count + size - d->maxSize, 0);
+    if (removed > 0)
+    {
+        beginRemoveRows(invalid, 0, removed - 1);
+        d->removeFirst(removed);
+        endRemoveRows();
+    }
+
+    beginInsertRows(invalid, d->count, d->count + size - 1);
+    for (; first != d->staged.cend(); ++first)
+        d->append(*first);
+    endInsertRows();
+
+    d->staged.clear();
+
+    if (removed > 0)
+        Q_EMIT overflowed();
 }
 
 void QtMessageLogModel::clear()
 {
     beginResetModel();
-    d->recordCache.clear();
-    d->current = 0;
+    d->queue->drain([](QueuedRecord&) {});
+    d->records.clear();
+    d->head = 0;
+    d->count = 0;
+    d->messages.clear();
+    d->words.clear();
+    d->trigrams.clear();
+    d->firstSequence = 0;
+    d->prunedSequence = 0;
     endResetModel();
 }
 
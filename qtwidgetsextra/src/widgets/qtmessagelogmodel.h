@@ -4,6 +4,15 @@
 
 #include <QtWidgetsExtra>
 
+class QtItemFilter;
+
+//
+// QtMessageLogModel keeps the last rotationLimit() messages, the oldest
+// message is always the row 0. Records are stored in the circular buffer
+// with interned categories and message text in the chunked arena, so the
+// memory taken by the log is predictable. Once the limit is reached, the
+// oldest rows are removed as new ones are inserted and overflowed() is emitted
+//
 class QTWIDGETSEXTRA_EXPORT QtMessageLogModel : public QAbstractTableModel
 {
     Q_OBJECT
@@ -41,12 +50,36 @@ public:
         this->message(level, code, category, message, QDateTime::currentDateTime());
     }
 
+    // Thread-safe counterpart of message(): records are queued without locks
+    // and added to the model by drain(), so the model changes once per drain.
+    // Returns false if the queue is full and the message is dropped
+    bool post(int level, int code, const QString& category, const QString& message);
+
+    // drain() is called by the timer, if the interval is 0 it must be called by the owner
+    void setDrainInterval(int msecs);
+    int drainInterval() const;
+
+    quint64 droppedCount() const;
+
+    // Rows whose data of the section is accepted by the filter, in ascending order.
+    // Levels, codes and categories are matched once per distinct value, messages
+    // are narrowed down by the index of words, so the log is not rescanned
+    QVector<int> acceptedRows(int section, const QtItemFilter& filter) const;
+
+    // Qt messages of all threads are posted to the model,
+    // nullptr restores the previously installed handler
+    static void installMessageHandler(QtMessageLogModel* model);
+
 public Q_SLOTS:
     void clear();
+    void drain();
 
 Q_SIGNALS:
     void overflowed();
 
+private:
+    void commit();
+
 private:
     QScopedPointer<class QtMessageLogModelPrivate> d;
 };
@@ -2,13 +2,23 @@
 #include "qtmessagelogmodel.h"
 
 #include "../itemviews/delegates/qtrichtextitemdelegate.h"
+#include "../itemviews/models/qtitemfilter.h"
 
+#include <QBitArray>
+#include <QSharedPointer>
 #include <QSortFilterProxyModel>
 #include <QTableView>
 #include <QHeaderView>
 #include <QBoxLayout>
 
 
+//
+// Filters are compiled to QtItemFilter once per change and rows accepted
+// by all of them are looked up in the log model, which matches distinct
+// values and indexed words instead of every row. The result is kept
+// as the bitmap over source rows: it follows the rotation of the log,
+// rows added later are matched by filters directly
+//
 class QtMessageLogProxyModel : public QSortFilterProxyModel
 {
     Q_OBJECT
@@ -17,18 +27,34 @@ public:
     using VariantFlagsPair = QPair<QVariant, Qt::MatchFlags>;
 
     explicit QtMessageLogProxyModel(QObject* parent = Q_NULLPTR) :
-        QSortFilterProxyModel(parent) {
+        QSortFilterProxyModel(parent), acceptedOffset(0) {
     }
 
     virtual ~QtMessageLogProxyModel() {}
 
+    void setSourceModel(QAbstractItemModel* model) Q_DECL_OVERRIDE
+    {
+        for (const auto& connection : qAsConst(connections))
+            disconnect(connection);
+        connections.clear();
+
+        QSortFilterProxyModel::setSourceModel(model);
+        if (model)
+        {
+            connections << connect(model, &QAbstractItemModel::rowsRemoved, this, &QtMessageLogProxyModel::sourceRowsRemoved)
+                        << connect(model, &QAbstractItemModel::modelReset, this, &QtMessageLogProxyModel::resetAcceptedRows)
+                        << connect(model, &QAbstractItemModel::layoutChanged, this, &QtMessageLogProxyModel::resetAcceptedRows);
+        }
+        updateFilters();
+    }
+
     void setFieldFilter(QtMessageLogView::Field field, const QVariant& value, Qt::MatchFlags flags = Qt::MatchExactly)
     {
         if (value.isValid())
             filters[fieldColumn(field)] = qMakePair(value, flags);
         else
             filters.remove(fieldColumn(field));
-        invalidateFilter();
+        updateFilters();
     }
 
     const VariantFlagsPair fieldFilter(QtMessageLogView::Field field) const
@@ -54,15 +80,19 @@ public:
                     filters.remove(c);
             }
         }
-        invalidateFilter();
+        updateFilters();
     }
 
-    bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const
+    bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const Q_DECL_OVERRIDE
     {
-        for (auto it = filters.begin(); it != filters.end(); ++it)
+        const int bit = sourceRow + acceptedOffset;
+        if (!sourceParent.isValid() && bit >= 0 && bit < accepted.size())
+            return accepted.testBit(bit);
+
+        for (auto it = matchers.begin(); it != matchers.end(); ++it)
         {
             const QModelIndex index = sourceModel()->index(sourceRow, it.key(), sourceParent);
-            if (!matched(index.data(filterRole()), it->first, it->second))
+            if (!(*it)->acceptedValue(index.data(filterRole())))
                 return false;
         }
         return true;
@@ -83,39 +113,66 @@ public:
         return (i > 0 ? (i - 1) : i);
     }
 
-    // TODO: fix me! combine with QtItemFilter internal implementation
-    static bool matched(const QVariant& v, const QVariant& what, Qt::MatchFlags flags)
+private:
+    static QSharedPointer<QtItemFilter> compile(const QVariant& what, Qt::MatchFlags flags)
+    {
+        QSharedPointer<QtItemFilter> filter(new QtItemFilter);
+        filter->setCondition(QtItemFilter::Match);
+        filter->setMatchFlags(flags);
+        // the whole value is matched by the regular expression, like QRegExp::exactMatch() does
+        if ((flags & 0x0F) == Qt::MatchRegExp)
+            filter->setPattern(QString(QLatin1String("\\A(?:") + what.toString() + QLatin1String(")\\z")));
+        else
+            filter->setPattern(what);
+        return filter;
+    }
+
+    void updateFilters()
     {
-        Qt::CaseSensitivity cs = flags & Qt::MatchCaseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
-        QString text;
-        // QVariant based matching
-        if (flags == Qt::MatchExactly) {
-            return (what == v);
-        } else {
-            if (text.isEmpty())
-                text = what.toString();
-            QString t = v.toString(); // lazy string initialization
-            switch (flags) {
-            case Qt::MatchRegExp:
-                return (QRegExp(text, cs).exactMatch(t));
-            case Qt::MatchWildcard:
-                return (QRegExp(text, cs, QRegExp::Wildcard).exactMatch(t));
-            case Qt::MatchStartsWith:
-                return t.startsWith(text, cs);
-            case Qt::MatchEndsWith:
-                return t.endsWith(text, cs);
-            case Qt::MatchFixedString:
-                return (t.compare(text, cs) == 0);
-            case Qt::MatchContains:
-            default:
-                return t.contains(text, cs);
+        matchers.clear();
+        for (auto it = filters.cbegin(); it != filters.cend(); ++it)
+            matchers.insert(it.key(), compile(it->first, it->second));
+
+        accepted.clear();
+        acceptedOffset = 0;
+
+        QtMessageLogModel* log = qobject_cast<QtMessageLogModel*>(sourceModel());
+        if (log && !matchers.isEmpty())
+        {
+            accepted.fill(true, log->rowCount());
+            for (auto it = matchers.cbegin(); it != matchers.cend(); ++it)
+            {
+                QBitArray rows(accepted.size());
+                for (int row : log->acceptedRows(it.key(), **it))
+                    rows.setBit(row);
+                accepted &= rows;
             }
         }
-        return false;
+        invalidateFilter();
+    }
+
+    void sourceRowsRemoved(const QModelIndex& parent, int first, int last)
+    {
+        // the log rotates from the beginning, otherwise rows are matched directly
+        if (!parent.isValid() && first == 0)
+            acceptedOffset += last - first + 1;
+        else
+            resetAcceptedRows();
+    }
+
+    void resetAcceptedRows()
+    {
+        accepted.clear();
+        acceptedOffset = 0;
     }
 
 private:
     QHash<int, VariantFlagsPair> filters;
+    QHash<int, QSharedPointer<QtItemFilter>> matchers;
+
+    QBitArray accepted; // bit of the source row is sourceRow + acceptedOffset
+    int acceptedOffset;
+    QVector<QMetaObject::Connection> connections;
 };
 
 
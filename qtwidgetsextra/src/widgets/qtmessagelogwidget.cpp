@@ -8,11 +8,116 @@
 #include <QPaintEvent>
 #include <QScrollBar>
 #include <QRegularExpression>
+#include <QStaticText>
+#include <QVarLengthArray>
 
 #include <cassert>
 #include <algorithm>
+#include <deque>
 #include <iterator>
+#include <vector>
 
+#include <LRUCache> // from Qt5Extra aux
+
+static inline int textWidth( const QFontMetrics & fm, const QString & text )
+{
+#if QT_VERSION < 0x050B00
+    return fm.width( text );
+#else
+    return fm.horizontalAdvance( text );
+#endif
+}
+
+// Lines are appended at the back and dropped from the front,
+// so the history rotates without moving the lines kept
+template<class T>
+class LineRing
+{
+public:
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    T& operator[](int i) { return items[(head + i) & (items.size() - 1)]; }
+    const T& operator[](int i) const { return items[(head + i) & (items.size() - 1)]; }
+
+    void push_back(T&& item)
+    {
+        if (count == int(items.size()))
+            grow();
+        items[(head + count) & (items.size() - 1)] = std::move(item);
+        ++count;
+    }
+
+    void pop_front(int n)
+    {
+        n = std::min(n, count);
+        for (int i = 0; i < n; ++i)
+        {
+            items[head] = T();
+            head = (head + 1) & (items.size() - 1);
+        }
+        count -= n;
+    }
+
+    void clear()
+    {
+        items.clear();
+        head = 0;
+        count = 0;
+    }
+
+private:
+    void grow()
+    {
+        // capacity is kept a power of 2
+        std::vector<T> next(std::max<size_t>(64, items.size() * 2));
+        for (int i = 0; i < count; ++i)
+            next[i] = std::move((*this)[i]);
+        items.swap(next);
+        head = 0;
+    }
+
+    std::vector<T> items;
+    int head = 0;
+    int count = 0;
+};
+
+// Maximum width of the lines kept. A width that isn't greater than
+// the width of a later line will never become the maximum, so only
+// the decreasing sequence of widths is stored
+class WidthTracker
+{
+public:
+    void push( qint64 line, int width )
+    {
+        while ( !widths.empty() && widths.back().second <= width )
+            widths.pop_back();
+        widths.emplace_back( line, width );
+    }
+
+    // forgets the lines preceding the given one
+    void pop( qint64 line )
+    {
+        while ( !widths.empty() && widths.front().first < line )
+            widths.pop_front();
+    }
+
+    int maximum() const { return widths.empty() ? 0 : widths.front().second; }
+
+    void clear() { widths.clear(); }
+
+private:
+    std::deque<std::pair<qint64, int>> widths;
+};
+
+//
+// Styles are matched in the order they were set up, the first one
+// matching the line wins. Expressions that can be embedded into the
+// single alternation are compiled into it, so the line without any
+// style (the most common case) is scanned only once. If the alternation
+// matches, only styles preceding the one it reports are checked one by
+// one, since they could match further in the line
+//
 class MessageHighlignter
 {
 public:
@@ -36,9 +141,12 @@ public:
         {}
     };
 
-    MessageHighlignter() {}
+    MessageHighlignter() : revision(1), compiled(false) {}
     ~MessageHighlignter() {}
 
+    // changed by every change of styles, lines are classified again then
+    unsigned int generation() const { return revision; }
+
     bool contains(int id) const
     {
         return (id > 0 && id <= styles.size());
@@ -47,6 +155,7 @@ public:
     int setup(const QRegularExpression& expr, const QColor& background, const QColor& foreground)
     {
         styles.push_back(Style(expr, background, foreground));
+        invalidate();
         return styles.size();
     }
 
@@ -55,6 +164,7 @@ public:
         if (contains(id))
         {
             styles.removeAt(id - 1);
+            invalidate();
             return 1;
         }
         return 0;
@@ -62,15 +172,37 @@ public:
 
     int highlight(const QString& text) const
     {
-        QRegularExpressionMatch match;
-        int i = 1;
-        for (auto it = styles.begin(); it != styles.end(); ++it, ++i)
+        if (!compiled)
+            compile();
+
+        // id of the first embedded style matching the line
+        int found = 0;
+        if (!embedded.empty())
         {
-            match = it->expr.match(text);
+            const QRegularExpressionMatch match = combined.match(text);
             if (match.hasMatch())
+            {
+                for (const auto& e : embedded)
+                {
+                    if (match.capturedStart(e.second) >= 0)
+                    {
+                        found = e.first;
+                        break;
+                    }
+                }
+            }
+        }
+
+        for (int i = 1, last = found ? found - 1 : styles.size(); i <= last; ++i)
+        {
+            // embedded ones are known not to match if the alternation doesn't
+            if (!found && isEmbedded[i - 1])
+                continue;
+
+            if (styles[i - 1].expr.match(text).hasMatch())
                 return i;
         }
-        return 0;
+        return found;
     }
 
     const Style& style(const int id) const
@@ -85,10 +217,89 @@ public:
     void clear()
     {
         styles.clear();
+        invalidate();
     }
 
 private:
+    void invalidate()
+    {
+        ++revision;
+        compiled = false;
+    }
+
+    // the inline form of options, others can't be scoped by the group
+    static QString inlineOptions(QRegularExpression::PatternOptions options)
+    {
+        QString flags;
+        if (options & QRegularExpression::CaseInsensitiveOption)
+            flags += QLatin1Char('i');
+        if (options & QRegularExpression::DotMatchesEverythingOption)
+            flags += QLatin1Char('s');
+        if (options & QRegularExpression::MultilineOption)
+            flags += QLatin1Char('m');
+        if (options & QRegularExpression::InvertedGreedinessOption)
+            flags += QLatin1Char('U');
+        return flags.isEmpty() ? flags : QLatin1String("(?") + flags + QLatin1Char(')');
+    }
+
+    static bool embeddable(const QRegularExpression& expr)
+    {
+        static const QRegularExpression::PatternOptions scoped =
+                QRegularExpression::CaseInsensitiveOption |
+                QRegularExpression::DotMatchesEverythingOption |
+                QRegularExpression::MultilineOption |
+                QRegularExpression::InvertedGreedinessOption;
+
+        // numbered references are broken by the groups of preceding expressions
+        static const QRegularExpression references(QStringLiteral("\\\\[1-9g]|\\(\\?(?:[0-9R+\\-&(]|P>)"));
+
+        return expr.isValid() && !expr.pattern().isEmpty() &&
+               (expr.patternOptions() & ~scoped) == 0 &&
+               !references.match(expr.pattern()).hasMatch();
+    }
+
+    void compile() const
+    {
+        embedded.clear();
+        isEmbedded.assign(size_t(styles.size()), false);
+
+        QString pattern;
+        int group = 1;
+        for (int i = 0; i < styles.size(); ++i)
+        {
+            const QRegularExpression& expr = styles[i].expr;
+            if (!embeddable(expr))
+                continue;
+
+            if (!pattern.isEmpty())
+                pattern += QLatin1Char('|');
+            pattern += QLatin1Char('(') + inlineOptions(expr.patternOptions()) + expr.pattern() + QLatin1Char(')');
+
+            embedded.emplace_back(i + 1, group);
+            isEmbedded[i] = true;
+            group += 1 + expr.captureCount();
+        }
+
+        combined.setPattern(pattern);
+        if (!combined.isValid())
+        {
+            // e.g. the same group name is used by several expressions
+            embedded.clear();
+            isEmbedded.assign(isEmbedded.size(), false);
+        }
+        else
+            combined.optimize();
+
+        compiled = true;
+    }
+
     QList<Style> styles;
+    unsigned int revision;
+
+    mutable QRegularExpression combined;
+    mutable std::vector<std::pair<int, int>> embedded; // style id and group of the alternation
+    mutable std::vector<bool> isEmbedded;
+    mutable bool compiled;
 };
 
 
@@ -100,7 +311,7 @@ public:
     explicit QtMessageLogWidgetPrivate( QtMessageLogWidget * qq );
     ~QtMessageLogWidgetPrivate();
 
-    void updateCache() const;
+    void updateCache();
 
     void triggerTimer() {
         if ( !timer.isActive() )
@@ -108,6 +319,7 @@ public:
     }
 
     void addPendingLines();
+    void removeFirstLines( int n );
     void enforceHistorySize();
     void updateScrollRanges();
 
@@ -119,7 +331,7 @@ public:
                           qMax( 0, 1 + lineByYCoordinate( bottom ) ) );
     }
 
-    inline int lineByYCoordinate( int x ) const;
+    inline int lineByYCoordinate( int x );
 
     inline QPoint scrollOffset() const;
 
@@ -136,9 +348,17 @@ public:
         return sb ? sb->value() : 0 ;
     }
 
+    // shaped text of the line, it's cached for a few screens of lines
+    const QStaticText & staticText( int idx );
+
+    // lines are classified when they are painted
+    unsigned int styleOf( int idx );
+
     struct LineItem {
         QString text;
-        unsigned int styleID;
+        unsigned int styleID = 0;
+        unsigned int generation = 0; // of the highlighter, the style is valid for
+        int width = 0;
     };
 
 private:
@@ -158,21 +378,25 @@ private:
             int lineSpacing;
             int ascent;
             int averageCharWidth;
-            QVector<int> lineWidths;
         } fontMetrics;
 
         struct
         {
-            int indexOfLongestLine;
+            WidthTracker widths;
             int longestLineLength;
         } dimensions;
     } cache;
 
+    // keyed by the line number, lines[idx] is the line firstLine + idx
+    Qt5Extra::LRUCache<qint64, QStaticText> glyphCache;
+
     //QHash<unsigned int, Style> styleByID;
     //QHash<Style,unsigned int> idByStyle;
     MessageHighlignter highlighter;
 
-    QVector<LineItem> lines, pendingLines;
+    LineRing<LineItem> lines;
+    QVector<LineItem> pendingLines;
+    qint64 firstLine;
 
     QRect visibleRect;
     QPair<int,int> linesVisible;
@@ -189,6 +413,8 @@ private:
 
 QtMessageLogWidgetPrivate::QtMessageLogWidgetPrivate( QtMessageLogWidget * q ) :
     q_ptr( q ),
+    glyphCache( 256 ),
+    firstLine( 0 ),
     historySize( 0xFFFFFFFF ),
     minimumVisibleLines( 1 ),
     minimumVisibleColumns( 1 ),
@@ -208,10 +434,10 @@ QtMessageLogWidgetPrivate::~QtMessageLogWidgetPrivate() {
 }
 
 
-void QtMessageLogWidgetPrivate::updateCache() const
+void QtMessageLogWidgetPrivate::updateCache()
 {
 
-    if ( cache.dirty >= Cache::FontMetrics ) {
+    if ( cache.dirty & Cache::FontMetrics ) {
         const QFontMetrics & fm = q_ptr->fontMetrics();
         cache.fontMetrics.lineSpacing = fm.lineSpacing();
         cache.fontMetrics.ascent = fm.ascent();
@@ -221,57 +447,45 @@ void QtMessageLogWidgetPrivate::updateCache() const
         cache.fontMetrics.averageCharWidth = fm.averageCharWidth();
 #endif
 
-        QVector<int> & lw = cache.fontMetrics.lineWidths;
-        lw.clear();
-        lw.reserve( lines.size() );
-        for (auto it = lines.begin(); it != lines.end(); ++it) {
-            lw.push_back( fm.width( it->text ));
-        }
+        for ( int i = 0, n = lines.size(); i < n; ++i )
+            lines[i].width = textWidth( fm, lines[i].text );
+        glyphCache.clear();
     }
 
-    if ( cache.dirty >= Cache::Dimensions ) {
-        const QVector<int> & lw = cache.fontMetrics.lineWidths;
-        const QVector<int>::const_iterator it =
-            std::max_element( lw.begin(), lw.end() );
-        if ( it == lw.end() ) {
-            cache.dimensions.indexOfLongestLine = -1;
-            cache.dimensions.longestLineLength = 0;
-        } else {
-            cache.dimensions.indexOfLongestLine = it - lw.begin();
-            cache.dimensions.longestLineLength = *it;
-        }
+    if ( cache.dirty ) {
+        WidthTracker & widths = cache.dimensions.widths;
+        widths.clear();
+        for ( int i = 0, n = lines.size(); i < n; ++i )
+            widths.push( firstLine + i, lines[i].width );
+        cache.dimensions.longestLineLength = widths.maximum();
     }
 
     cache.dirty = false;
 }
 
-void QtMessageLogWidgetPrivate::enforceHistorySize()
+void QtMessageLogWidgetPrivate::removeFirstLines( int n )
 {
-    const size_t numLimes = lines.size();
-    if ( numLimes <= historySize )
+    n = std::min( n, lines.size() );
+    if ( n <= 0 )
         return;
-    const int remove = numLimes - historySize ;
-    lines.erase( lines.begin(), lines.begin() + remove );
 
-    // can't quickly update the dimensions if the fontMetrics aren't uptodate.
-    if ( cache.dirty & Cache::FontMetrics )
-    {
-        cache.dirty |= Cache::Dimensions;
-        return;
-    }
+    lines.pop_front( n );
+    firstLine += n;
 
-    QVector<int> & lw = cache.fontMetrics.lineWidths;
+    // the dimensions are rebuilt anyway if the cache is dirty
+    if ( cache.dirty )
+        return;
 
-    Q_ASSERT( lw.size() > remove );
-    lw.erase( lw.begin(), lw.begin() + remove );
+    cache.dimensions.widths.pop( firstLine );
+    cache.dimensions.longestLineLength = cache.dimensions.widths.maximum();
+}
 
-    if ( cache.dirty & Cache::Dimensions )
+void QtMessageLogWidgetPrivate::enforceHistorySize()
+{
+    const unsigned int numLines = lines.size();
+    if ( numLines <= historySize )
         return;
-
-    if ( cache.dimensions.indexOfLongestLine >= remove )
-        cache.dimensions.indexOfLongestLine -= remove;
-    else
-        cache.dirty |= Cache::Dimensions;
+    removeFirstLines( int( numLines - historySize ) );
 }
 
 static inline void set_scrollbar_properties( QScrollBar & sb, int document, int viewport, int singleStep, Qt::Orientation o )
@@ -322,27 +536,27 @@ void QtMessageLogWidgetPrivate::addPendingLines()
     if (pendingLines.empty())
         return;
 
-    const unsigned int oldNumLines = lines.size();
-
-    lines += pendingLines;
+    // lines rotated out within this batch are never shown
+    const qint64 pending = pendingLines.size();
+    const int skipped = int( std::max<qint64>( 0, pending - historySize ) );
+    removeFirstLines( int( std::max<qint64>( 0, lines.size() + pending - skipped - historySize ) ) );
 
     // if the cache isn't dirty, we can quickly update it without
     // invalidation:
-    if (!cache.dirty)
+    const bool measure = !cache.dirty;
+    const QFontMetrics & fm = q_ptr->fontMetrics();
+    for (auto it = pendingLines.begin() + skipped; it != pendingLines.end(); ++it)
     {
-        // update fontMetrics:
-        const QFontMetrics & fm = q_ptr->fontMetrics();
-        QVector<int>& lw = cache.fontMetrics.lineWidths;
-        lw.reserve( pendingLines.size() );
-        for (const auto& line : qAsConst(pendingLines))
-            lw.push_back( fm.width(line.text) );
-
-        // update dimensions:
-        const QVector<int>::const_iterator it = std::max_element( lw.begin() + oldNumLines, lw.end() );
-        if ( *it >= cache.dimensions.longestLineLength ) {
-            cache.dimensions.longestLineLength = *it;
-            cache.dimensions.indexOfLongestLine = oldNumLines + ( it - lw.begin() );
+        if ( measure ) {
+            it->width = textWidth( fm, it->text );
+            cache.dimensions.widths.push( firstLine + lines.size(), it->width );
         }
+        lines.push_back( std::move(*it) );
+    }
+
+    if ( measure )
+    {
+        cache.dimensions.longestLineLength = cache.dimensions.widths.maximum();
 
         cache.fontMetrics.lineSpacing = fm.lineSpacing();
         cache.fontMetrics.ascent = fm.ascent();
@@ -355,12 +569,11 @@ void QtMessageLogWidgetPrivate::addPendingLines()
 
     pendingLines.clear();
 
-    enforceHistorySize();
     updateScrollRanges();
     q_ptr->viewport()->update();
 }
 
-inline int QtMessageLogWidgetPrivate::lineByYCoordinate( int y ) const
+inline int QtMessageLogWidgetPrivate::lineByYCoordinate( int y )
 {
     updateCache();
     if ( cache.fontMetrics.lineSpacing == 0 )
@@ -379,6 +592,30 @@ inline QPoint QtMessageLogWidgetPrivate::scrollOffset() const
                    scrollBarOffset( q_ptr->verticalScrollBar() ) );
 }
 
+unsigned int QtMessageLogWidgetPrivate::styleOf( int idx )
+{
+    LineItem & li = lines[idx];
+    if ( li.generation != highlighter.generation() ) {
+        li.styleID = highlighter.highlight( li.text );
+        li.generation = highlighter.generation();
+    }
+    return li.styleID;
+}
+
+const QStaticText & QtMessageLogWidgetPrivate::staticText( int idx )
+{
+    const qint64 key = firstLine + idx;
+    auto it = glyphCache.find( key );
+    if ( it != glyphCache.end() )
+        return glyphCache.move_font( it )->second;
+
+    QStaticText text( lines[idx].text );
+    text.setTextFormat( Qt::PlainText );
+    text.setPerformanceHint( QStaticText::AggressiveCaching );
+    text.prepare( QTransform(), q_ptr->font() );
+    return glyphCache.emplace( key, std::move(text) ).first->second;
+}
+
 
 
 QtMessageLogWidget::QtMessageLogWidget( QWidget * parent )
@@ -397,6 +634,7 @@ void QtMessageLogWidget::setHistorySize(unsigned int hs)
     d->historySize = hs;
     d->enforceHistorySize();
     d->updateScrollRanges();
+    d->updateGeometry();
     viewport()->update();
 }
 
@@ -412,9 +650,9 @@ QString QtMessageLogWidget::text() const
     QString result;
     // reserve space
     result.reserve((d->lines.size() + d->pendingLines.size()) * qMin(512, d->cache.dimensions.longestLineLength / 4));
-    for (const auto& line : qAsConst(d->lines))
+    for (int i = 0, n = d->lines.size(); i < n; ++i)
     {
-        result += line.text;
+        result += d->lines[i].text;
         result += '\n';
     }
 
@@ -477,18 +715,21 @@ bool QtMessageLogWidget::alternatingRowColors() const
 int QtMessageLogWidget::setupStyle(const QRegularExpression &expr, const QColor &background, const QColor &foreground)
 {
 
+    viewport()->update();
     return d->highlighter.setup(expr, background, foreground);
 }
 
 int QtMessageLogWidget::removeStyle(int id)
 {
 
+    viewport()->update();
     return d->highlighter.remove(id);
 }
 
 void QtMessageLogWidget::clearStyles()
 {
 
+    viewport()->update();
     return d->highlighter.clear();
 }
 
@@ -521,6 +762,8 @@ void QtMessageLogWidget::clear()
     d->linesVisible.second = 0;
     d->lines.clear();
     d->pendingLines.clear();
+    d->firstLine = 0;
+    d->glyphCache.clear();
     d->cache.dirty = QtMessageLogWidgetPrivate::Cache::All;
     viewport()->update();
 }
@@ -530,7 +773,6 @@ void QtMessageLogWidget::message( const QString & str )
 {
     QtMessageLogWidgetPrivate::LineItem li;
     li.text = str;
-    li.styleID = d->highlighter.highlight(str);
     d->pendingLines.push_back( li );
     d->triggerTimer();
 }
@@ -566,20 +808,46 @@ void QtMessageLogWidget::paintEvent(QPaintEvent*)
         p.drawRect( d->visibleRect );
     }
 
-    // ### unused optimization: paint lines by styles to minimise pen changes.
-    for ( unsigned int i = d->linesVisible.first, end = d->linesVisible.second ; i != end ; ++i )
-    {
-        const QtMessageLogWidgetPrivate::LineItem & li = d->lines[i];
+    // lines are painted grouped by styles to minimise pen and brush changes,
+    // backgrounds go first, so no background covers the text of the line above
+    const int first = d->linesVisible.first;
+    const int last = std::min( d->linesVisible.second, d->lines.size() );
+    if ( first >= last )
+        return;
 
-        assert( !li.styleID || d->highlighter.contains( li.styleID ) );
+    QVarLengthArray<int, 256> order;
+    for ( int i = first; i < last; ++i ) {
+        d->styleOf( i );
+        order.append( i );
+    }
+    std::stable_sort( order.begin(), order.end(), [this](int lhs, int rhs) {
+        return d->lines[lhs].styleID < d->lines[rhs].styleID;
+    });
 
-        const MessageHighlignter::Style& st = d->highlighter.style(li.styleID);
-        p.setPen( Qt::NoPen );
-        p.setBrush(st.background);
-        p.drawRect( d->lineRect( i ).adjusted(0, 0, size().width(), 0) );
+    QVector<QRect> rects;
+    for ( auto it = order.cbegin(); it != order.cend(); )
+    {
+        const unsigned int styleID = d->lines[*it].styleID;
+        assert( !styleID || d->highlighter.contains( styleID ) );
+
+        const MessageHighlignter::Style& st = d->highlighter.style(styleID);
+        rects.clear();
+        for ( ; it != order.cend() && d->lines[*it].styleID == styleID; ++it )
+            rects.append( d->lineRect( *it ).adjusted(0, 0, size().width(), 0) );
+
+        if ( st.background.alpha() != 0 ) {
+            p.setPen( Qt::NoPen );
+            p.setBrush( st.background );
+            p.drawRects( rects );
+        }
+    }
 
-        p.setPen(st.foreground);
-        p.drawText( 0, i * cache.fontMetrics.lineSpacing + cache.fontMetrics.ascent, li.text );
+    for ( auto it = order.cbegin(); it != order.cend(); )
+    {
+        const unsigned int styleID = d->lines[*it].styleID;
+        p.setPen( d->highlighter.style(styleID).foreground );
+        for ( ; it != order.cend() && d->lines[*it].styleID == styleID; ++it )
+            p.drawStaticText( 0, *it * cache.fontMetrics.lineSpacing, d->staticText( *it ) );
     }
 }
 
@@ -620,6 +888,8 @@ void QtMessageLogWidget::resizeEvent(QResizeEvent* e)
     d->updateScrollRanges();
     d->updateCache();
     d->updateGeometry();
+    if ( const int lineSpacing = d->cache.fontMetrics.lineSpacing )
+        d->glyphCache.resize( std::max( 256, 4 * (viewport()->height() / lineSpacing + 1) ) );
     QAbstractScrollArea::resizeEvent(e);
 }
 